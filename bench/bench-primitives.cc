@@ -0,0 +1,465 @@
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <array>
+#include <cstdio>
+#include <experimental/filesystem>
+#include <unistd.h>
+
+#include <taquinsolve.hh>
+#include <IDASolver.hh>
+#include <Heuristics.hh>
+#include <BoardParser.hh>
+#include <PuzzleGenerator.hh>
+
+using namespace TaquinSolve;
+
+//Large enough to push the pattern database entries out of every cache level.
+static const size_t EVICTION_BUFFER_SIZE = 64 * 1024 * 1024;
+
+//Boards recorded from real searches to measure pattern database locality with.
+static const size_t SEARCH_SAMPLE_SIZE = 1 << 20;
+
+/**
+ * Exposes the solver's pattern database loading to the benchmarks.
+ */
+class BenchSolver : public IDASolver
+{
+    public:
+        std::shared_ptr<PatternDatabase> get_pattern_database()
+        {
+            this->load_pattern_database();
+            return this->pattern_database;
+        }
+};
+
+/**
+ * The default heuristic, recording every board it evaluates in search order.
+ */
+struct RecordingHeuristic
+{
+    DefaultHeuristic heuristic;
+    std::vector< std::array<uint8_t, 16> > *boards;
+
+    uint8_t estimate(Board &board)
+    {
+        if (this->boards->size() < SEARCH_SAMPLE_SIZE) {
+            std::array<uint8_t, 16> cells;
+            std::copy(board.get_cells(), board.get_cells() + 16, cells.begin());
+            this->boards->push_back(cells);
+        }
+        return this->heuristic.estimate(board);
+    }
+
+    void prefetch(Board &board)
+    {
+        this->heuristic.prefetch(board);
+    }
+};
+
+/**
+ * Timing samples of one primitive, in nanoseconds per operation.
+ */
+struct Measurement {
+    std::string name;
+    uint32_t batch;
+    std::vector<double> samples;
+};
+
+/**
+ * A benchmark case.
+ * setup prepares the inputs for a batch outside the timed region, run performs operation i of the batch.
+ */
+struct Case {
+    std::string name;
+    std::function<void(uint32_t)> setup;
+    std::function<void(uint32_t)> run;
+};
+
+static volatile uint64_t sink;
+
+/**
+ * Run a case for warm-up, then time the given number of batches.
+ */
+static Measurement measure(Case bench_case, uint32_t batch, uint32_t warmup, uint32_t repetitions)
+{
+    Measurement measurement;
+    measurement.name = bench_case.name;
+    measurement.batch = batch;
+
+    for (uint32_t r = 0; r < warmup + repetitions; r++) {
+        bench_case.setup(batch);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < batch; i++) {
+            bench_case.run(i);
+        }
+        double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        if (r >= warmup) {
+            measurement.samples.push_back(elapsed / batch);
+        }
+    }
+
+    return measurement;
+}
+
+static std::string measurement_to_json(Measurement measurement)
+{
+    std::vector<double> samples = measurement.samples;
+    std::sort(samples.begin(), samples.end());
+
+    double mean = 0;
+    for (double sample : samples) {
+        mean += sample;
+    }
+    mean /= samples.size();
+
+    double variance = 0;
+    for (double sample : samples) {
+        variance += (sample - mean) * (sample - mean);
+    }
+    variance /= samples.size();
+
+    std::ostringstream json;
+    json << "{\"name\":\"" << measurement.name << "\""
+         << ",\"batch\":" << measurement.batch
+         << ",\"repetitions\":" << samples.size()
+         << ",\"ns_per_op\":{"
+         << "\"min\":" << samples.front()
+         << ",\"median\":" << samples[samples.size() / 2]
+         << ",\"mean\":" << mean
+         << ",\"stddev\":" << std::sqrt(variance)
+         << ",\"p90\":" << samples[std::min(samples.size() - 1, (size_t)(samples.size() * 0.9))]
+         << ",\"max\":" << samples.back()
+         << "}}";
+    return json.str();
+}
+
+/**
+ * Walk the empty tile randomly to get a board that is valid and solvable.
+ */
+static std::vector<uint8_t> random_board(std::mt19937_64 &rng, uint8_t board_size, uint32_t steps = 200)
+{
+    std::shared_ptr<Board> board(new Board(taquin_tokenise_board_string(board_size == 4 ? "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 0" : "1 2 3 4 5 6 7 8 0"), board_size));
+    for (uint32_t i = 0; i < steps; i++) {
+        std::vector<Moves> moves = board->get_available_moves();
+        board = std::shared_ptr<Board>(board->perform_move(moves[rng() % moves.size()]));
+    }
+    return board->get_state();
+}
+
+/**
+ * Compute the table indices of each recorded board.
+ */
+static std::vector<uint32_t> search_indices(std::shared_ptr<PatternDatabase> pattern_database, const std::vector< std::array<uint8_t, 16> > &boards)
+{
+    std::vector<uint32_t> indices(boards.size() * MAX_PATTERN_GROUPS);
+    uint8_t positions[MAX_CELLS];
+    for (size_t i = 0; i < boards.size(); i++) {
+        for (uint8_t cell = 0; cell < 16; cell++) {
+            positions[boards[i][cell]] = cell;
+        }
+        pattern_database->get_indices(positions, indices.data() + i * MAX_PATTERN_GROUPS);
+    }
+    return indices;
+}
+
+/**
+ * Count how often a lookup lands on a different cache line or page than the previous lookup in the same group.
+ */
+static std::string locality_to_json(std::string name, std::shared_ptr<PatternDatabase> pattern_database, const std::vector<uint32_t> &indices)
+{
+    uint8_t group_count = pattern_database->get_group_count();
+    uint64_t lookups = 0;
+    uint64_t line_changes = 0;
+    uint64_t page_changes = 0;
+
+    for (size_t i = MAX_PATTERN_GROUPS; i < indices.size(); i++) {
+        if (i % MAX_PATTERN_GROUPS >= group_count) {
+            continue;
+        }
+        lookups++;
+        line_changes += indices[i] / 64 != indices[i - MAX_PATTERN_GROUPS] / 64;
+        page_changes += indices[i] / 4096 != indices[i - MAX_PATTERN_GROUPS] / 4096;
+    }
+
+    std::ostringstream json;
+    json << "{\"order\":\"" << name << "\""
+         << ",\"lookups\":" << lookups
+         << ",\"line_change_rate\":" << (double) line_changes / lookups
+         << ",\"page_change_rate\":" << (double) page_changes / lookups
+         << "}";
+    return json.str();
+}
+
+static void usage()
+{
+    std::cerr << "Usage: bench-primitives [options]" << std::endl
+              << "  --batch N         Operations timed per sample (default 4096)" << std::endl
+              << "  --warmup N        Untimed warm-up samples (default 5)" << std::endl
+              << "  --repetitions N   Timed samples (default 50)" << std::endl
+              << "  --output FILE     Write the JSON report to FILE instead of stdout" << std::endl;
+}
+
+int main (int argc, char **argv)
+{
+    uint32_t batch = 4096;
+    uint32_t warmup = 5;
+    uint32_t repetitions = 50;
+    std::string output_path;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--batch" && has_value) {
+            batch = strtoul(argv[++i], NULL, 10);
+        } else if (arg == "--warmup" && has_value) {
+            warmup = strtoul(argv[++i], NULL, 10);
+        } else if (arg == "--repetitions" && has_value) {
+            repetitions = strtoul(argv[++i], NULL, 10);
+        } else if (arg == "--output" && has_value) {
+            output_path = argv[++i];
+        } else {
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::mt19937_64 rng(1);
+
+    //A fixed pool of boards the cases draw from
+    const uint32_t pool_size = 1 << 16;
+    std::vector< std::vector<uint8_t> > states_3x3;
+    std::vector< std::vector<uint8_t> > states_4x4;
+    std::vector<std::string> strings_4x4;
+    for (uint32_t i = 0; i < pool_size; i++) {
+        states_3x3.push_back(random_board(rng, 3));
+        states_4x4.push_back(random_board(rng, 4));
+
+        std::string board_string;
+        for (uint8_t tile : states_4x4.back()) {
+            board_string += std::to_string(tile) + " ";
+        }
+        strings_4x4.push_back(board_string);
+    }
+
+    std::shared_ptr<PatternDatabase> pattern_database;
+    try {
+        BenchSolver solver;
+        pattern_database = solver.get_pattern_database();
+    } catch (std::string e) {
+        std::cerr << "Pattern databases unavailable, skipping their benchmarks: " << e << std::endl;
+    }
+
+    //Boards prepared by the setup of each batch
+    std::vector< std::shared_ptr<Board> > boards;
+    std::vector<Moves> moves;
+    std::vector<uint32_t> indices;
+    std::vector<uint8_t> eviction_buffer(EVICTION_BUFFER_SIZE);
+    BoardParser parser(4);
+    PuzzleGenerator generator(4, 1);
+    uint8_t generated[16];
+    BoardBatch parse_batch;
+    uint32_t offset = 0;
+
+    //Prepare fresh boards so cached values are recomputed in the timed region
+    auto fresh_boards = [&](std::vector< std::vector<uint8_t> > *states, uint8_t board_size, std::shared_ptr<PatternDatabase> database) {
+        return [&, states, board_size, database](uint32_t count) {
+            boards.clear();
+            moves.clear();
+            for (uint32_t i = 0; i < count; i++) {
+                boards.push_back(std::shared_ptr<Board>(new Board((*states)[(offset + i) % pool_size], board_size, database)));
+                moves.push_back(boards.back()->get_available_moves()[0]);
+            }
+            offset += count;
+        };
+    };
+
+    auto no_setup = [&](uint32_t count) {
+        offset += count;
+    };
+
+    std::vector<Case> cases = {
+        {"Board::perform_move 4x4", fresh_boards(&states_4x4, 4, NULL), [&](uint32_t i) {
+            Board *board = boards[i]->perform_move(moves[i]);
+            sink += board->get_cost();
+            delete board;
+        }},
+        {"Board::get_state_hash 4x4", fresh_boards(&states_4x4, 4, NULL), [&](uint32_t i) {
+            sink += boards[i]->get_state_hash();
+        }},
+        {"Board::get_partial_state_hash 4x4", fresh_boards(&states_4x4, 4, NULL), [&](uint32_t i) {
+            sink += boards[i]->get_partial_state_hash(0x2662);
+        }},
+        {"Board::get_heuristic 3x3", fresh_boards(&states_3x3, 3, NULL), [&](uint32_t i) {
+            sink += boards[i]->get_heuristic();
+        }},
+        {"Board::get_heuristic 4x4 manhattan", fresh_boards(&states_4x4, 4, NULL), [&](uint32_t i) {
+            sink += boards[i]->get_heuristic();
+        }},
+        {"taquin_check_solvable 4x4", no_setup, [&](uint32_t i) {
+            sink += taquin_check_solvable(states_4x4[(offset + i) % pool_size], 4);
+        }},
+        {"taquin_tokenise_board_string 4x4", no_setup, [&](uint32_t i) {
+            sink += taquin_tokenise_board_string(strings_4x4[(offset + i) % pool_size]).size();
+        }},
+        {"PuzzleGenerator::generate_into 4x4", no_setup, [&](uint32_t i) {
+            generator.generate_into(generated);
+            sink += generated[0];
+        }},
+        {"BoardParser::validate 4x4", no_setup, [&](uint32_t i) {
+            sink += (uint8_t) BoardParser::validate(states_4x4[(offset + i) % pool_size].data(), 4);
+        }},
+        {"BoardParser::parse 4x4 line", [&](uint32_t count) {
+            parse_batch = BoardBatch();
+            parse_batch.tiles.reserve(count * 16);
+            parse_batch.errors.reserve(count);
+            parse_batch.lines.reserve(count);
+            offset += count;
+        }, [&](uint32_t i) {
+            sink += parser.parse(strings_4x4[(offset + i) % pool_size], parse_batch);
+        }}
+    };
+
+    //The same tables in ascending tile order, replaying lookups in the order real searches made them
+    std::vector<std::string> locality;
+    std::shared_ptr<PatternDatabase> ascending_database;
+    std::vector< std::array<uint8_t, 16> > search_boards;
+    std::vector<uint32_t> search_indices_default;
+    std::vector<uint32_t> search_indices_ascending;
+    if (pattern_database != NULL) {
+        std::cerr << "Recording search lookups.." << std::endl;
+        RecordingHeuristic recording;
+        recording.boards = &search_boards;
+        BasicIDASolver<RecordingHeuristic> recording_solver(SolverOptions(), recording);
+        while (search_boards.size() < SEARCH_SAMPLE_SIZE) {
+            recording_solver.solve(random_board(rng, 4, 60), 4);
+        }
+
+        //Round trip each group through a scratch file outside the working directory
+        std::string path = std::experimental::filesystem::temp_directory_path().string() + "/bench-primitives-XXXXXX";
+        int fd = mkstemp(&path[0]);
+        if (fd < 0) {
+            std::cerr << "Error: unable to create a temporary file" << std::endl;
+            return EXIT_FAILURE;
+        }
+        close(fd);
+
+        try {
+            ascending_database = std::shared_ptr<PatternDatabase>(new PatternDatabase(4));
+            for (uint8_t g = 0; g < pattern_database->get_group_count(); g++) {
+                std::vector<uint8_t> order = pattern_database->get_tile_order(g);
+                std::sort(order.begin(), order.end());
+
+                uint16_t mask = 0;
+                for (uint8_t tile : order) {
+                    mask |= 1 << tile;
+                }
+                ascending_database->add_group(mask, order);
+
+                pattern_database->save(g, path);
+                ascending_database->load(path);
+            }
+        } catch (std::string e) {
+            remove(path.c_str());
+            throw;
+        }
+        remove(path.c_str());
+
+        search_indices_default = search_indices(pattern_database, search_boards);
+        search_indices_ascending = search_indices(ascending_database, search_boards);
+        locality.push_back(locality_to_json("default", pattern_database, search_indices_default));
+        locality.push_back(locality_to_json("ascending", ascending_database, search_indices_ascending));
+    }
+
+    //Replay a run of recorded lookups with cold caches
+    auto search_order = [&](std::vector<uint32_t> *search_indices) {
+        return [&, search_indices](uint32_t count) {
+            indices.assign(
+                search_indices->begin() + (offset % (search_boards.size() - count)) * MAX_PATTERN_GROUPS,
+                search_indices->begin() + (offset % (search_boards.size() - count) + count) * MAX_PATTERN_GROUPS
+            );
+            for (size_t j = 0; j < eviction_buffer.size(); j += 64) {
+                eviction_buffer[j]++;
+            }
+            offset += count;
+        };
+    };
+
+    if (pattern_database != NULL) {
+        cases.push_back({"PatternDatabase::lookup search order", search_order(&search_indices_default), [&](uint32_t i) {
+            sink += pattern_database->lookup(indices.data() + i * MAX_PATTERN_GROUPS);
+        }});
+        cases.push_back({"PatternDatabase::lookup search order ascending", search_order(&search_indices_ascending), [&](uint32_t i) {
+            sink += ascending_database->lookup(indices.data() + i * MAX_PATTERN_GROUPS);
+        }});
+        cases.push_back({"Board::get_heuristic 4x4 pdb", fresh_boards(&states_4x4, 4, pattern_database), [&](uint32_t i) {
+            sink += boards[i]->get_heuristic();
+        }});
+        cases.push_back({"Board::get_pattern_db_heuristic 4x4", fresh_boards(&states_4x4, 4, pattern_database), [&](uint32_t i) {
+            sink += boards[i]->get_pattern_db_heuristic();
+        }});
+
+        //Warm: the same few entries are probed over and over, so they stay in L1.
+        cases.push_back({"PatternDatabase::lookup warm", [&](uint32_t count) {
+            indices.resize(MAX_PATTERN_GROUPS);
+            std::vector<uint8_t> positions(MAX_CELLS);
+            for (uint8_t cell = 0; cell < 16; cell++) {
+                positions[states_4x4[offset % pool_size][cell]] = cell;
+            }
+            pattern_database->get_indices(positions.data(), indices.data());
+            offset += count;
+        }, [&](uint32_t i) {
+            sink += pattern_database->lookup(indices.data());
+        }});
+
+        //Cold: random entries, after the caches have been flushed by sweeping a large buffer.
+        cases.push_back({"PatternDatabase::lookup cold", [&](uint32_t count) {
+            indices.resize(count * MAX_PATTERN_GROUPS);
+            std::vector<uint8_t> positions(MAX_CELLS);
+            for (uint32_t i = 0; i < count; i++) {
+                for (uint8_t cell = 0; cell < 16; cell++) {
+                    positions[states_4x4[(offset + i) % pool_size][cell]] = cell;
+                }
+                pattern_database->get_indices(positions.data(), indices.data() + i * MAX_PATTERN_GROUPS);
+            }
+            for (size_t j = 0; j < eviction_buffer.size(); j += 64) {
+                eviction_buffer[j]++;
+            }
+            offset += count;
+        }, [&](uint32_t i) {
+            sink += pattern_database->lookup(indices.data() + i * MAX_PATTERN_GROUPS);
+        }});
+    }
+
+    std::ostringstream json;
+    json << "{\"primitives\":[";
+    for (size_t i = 0; i < cases.size(); i++) {
+        std::cerr << "Measuring " << cases[i].name << ".." << std::endl;
+        json << (i ? "," : "") << measurement_to_json(measure(cases[i], batch, warmup, repetitions));
+    }
+    json << "],\"pattern_database_locality\":[";
+    for (size_t i = 0; i < locality.size(); i++) {
+        json << (i ? "," : "") << locality[i];
+    }
+    json << "]}" << std::endl;
+
+    if (output_path.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream output(output_path);
+        output << json.str();
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,412 @@
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <experimental/filesystem>
+
+#include <taquinsolve.hh>
+#include <IDASolver.hh>
+#include <ParallelIDASolver.hh>
+#include <AStarSolver.hh>
+#include <ExactTableSolver.hh>
+#include <AutoSolver.hh>
+#include <Heuristics.hh>
+
+using namespace TaquinSolve;
+
+/**
+ * Timing and node counts over one set of instances.
+ */
+struct SetResult {
+    std::string name;
+    uint8_t board_size = 0;
+    std::vector<double> solve_times;
+    uint64_t nodes_generated = 0;
+    uint64_t total_moves = 0;
+    uint64_t database_load_time = 0;
+    double total_time = 0;
+
+    //Instances solved by each engine
+    std::map<Algorithm, uint32_t> algorithms;
+};
+
+static const std::map<std::string, Algorithm> ALGORITHM_NAMES = {
+    {"ida", Algorithm::IDA},
+    {"auto", Algorithm::AUTO},
+    {"exact-table", Algorithm::EXACT_TABLE},
+    {"astar", Algorithm::ASTAR},
+    {"parallel-ida", Algorithm::PARALLEL_IDA}
+};
+
+/**
+ * Build a solvable board with a uniformly random tile order.
+ * Uses its own seeded generator so the set is identical on every platform.
+ */
+static std::vector<uint8_t> seeded_board(std::mt19937_64 &rng, uint8_t board_size)
+{
+    uint8_t len = board_size * board_size;
+    std::vector<uint8_t> board;
+    for (uint8_t i = 0; i < len; i++) {
+        board.push_back(i);
+    }
+
+    //Fisher-Yates with rejection sampling to avoid modulo bias
+    for (uint8_t i = len - 1; i > 0; i--) {
+        uint64_t limit = std::numeric_limits<uint64_t>::max() - std::numeric_limits<uint64_t>::max() % (i + 1);
+        uint64_t r;
+        do {
+            r = rng();
+        } while (r >= limit);
+        std::swap(board[i], board[r % (i + 1)]);
+    }
+
+    //Swapping two tiles flips the parity, so this keeps the distribution uniform
+    if (!taquin_check_solvable(board, board_size)) {
+        std::iter_swap(std::find(board.begin(), board.end(), 1), std::find(board.begin(), board.end(), 2));
+    }
+
+    return board;
+}
+
+/**
+ * Build a board by walking the empty tile randomly away from the goal.
+ * The optimal solution is at most walk_length moves.
+ */
+static std::vector<uint8_t> seeded_walk(std::mt19937_64 &rng, uint8_t board_size, uint32_t walk_length)
+{
+    uint8_t len = board_size * board_size;
+    std::vector<uint8_t> board;
+    for (uint8_t i = 1; i < len; i++) {
+        board.push_back(i);
+    }
+    board.push_back(0);
+
+    uint8_t zero_position = len - 1;
+    int8_t last_step = 0;
+    for (uint32_t i = 0; i < walk_length; i++) {
+        std::vector<int8_t> steps;
+        uint8_t x = zero_position % board_size;
+        uint8_t y = zero_position / board_size;
+        if (x > 0) steps.push_back(-1);
+        if (x < board_size - 1) steps.push_back(1);
+        if (y > 0) steps.push_back(-board_size);
+        if (y < board_size - 1) steps.push_back(board_size);
+
+        //Never undo the previous step
+        steps.erase(std::remove(steps.begin(), steps.end(), -last_step), steps.end());
+
+        int8_t step = steps[rng() % steps.size()];
+        std::swap(board[zero_position], board[zero_position + step]);
+        zero_position += step;
+        last_step = step;
+    }
+
+    return board;
+}
+
+/**
+ * Convert one of Korf's instances (blank-first goal) to this library's goal.
+ * Rotating the board half a turn and relabelling tile t as 16-t maps one goal onto the other
+ * without changing the optimal solution length.
+ */
+static std::vector<uint8_t> korf_to_standard(std::vector<uint8_t> board)
+{
+    uint8_t len = board.size();
+    std::vector<uint8_t> converted(len);
+    for (uint8_t i = 0; i < len; i++) {
+        uint8_t tile = board[len - 1 - i];
+        converted[i] = tile == 0 ? 0 : len - tile;
+    }
+    return converted;
+}
+
+/**
+ * Read one board per line, skipping blank lines and # comments.
+ */
+static std::vector< std::vector<uint8_t> > read_instances(std::string path)
+{
+    std::vector< std::vector<uint8_t> > instances;
+    std::ifstream file(path);
+
+    if (!file.is_open()) {
+        throw std::string("Unable to open instance file: ") + path;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        instances.push_back(taquin_tokenise_board_string(line));
+    }
+
+    return instances;
+}
+
+/**
+ * Solve every instance with one solver, so databases are loaded once per set.
+ */
+template<typename SolverType>
+static SetResult run_set(std::string name, uint8_t board_size, std::vector< std::vector<uint8_t> > instances)
+{
+    SetResult result;
+    result.name = name;
+    result.board_size = board_size;
+
+    SolverType solver;
+    for (size_t i = 0; i < instances.size(); i++) {
+        SolveStats stats;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::queue<Moves> moves = solver.solve(instances[i], board_size, &stats);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (i == 0) {
+            result.database_load_time = stats.database_load_time;
+        }
+
+        result.solve_times.push_back(elapsed - stats.database_load_time / 1e6);
+        result.nodes_generated += stats.nodes_generated;
+        result.total_moves += moves.size();
+        result.algorithms[stats.algorithm]++;
+
+        std::cerr << "\r" << name << ": " << (i + 1) << "/" << instances.size() << std::flush;
+    }
+    std::cerr << std::endl;
+
+    for (double time : result.solve_times) {
+        result.total_time += time;
+    }
+
+    return result;
+}
+
+/**
+ * Solve a set with the named engine and, for IDA*, heuristic composition.
+ */
+static SetResult run_set(std::string algorithm, std::string heuristic, std::string name, uint8_t board_size, std::vector< std::vector<uint8_t> > instances)
+{
+    if (algorithm != "ida" && heuristic != "default") {
+        throw std::string("--heuristic only applies to --algorithm ida");
+    }
+
+    if (algorithm == "auto") {
+        return run_set<AutoSolver>(name, board_size, instances);
+    } else if (algorithm == "exact-table") {
+        return run_set<ExactTableSolver>(name, board_size, instances);
+    } else if (algorithm == "astar") {
+        return run_set<AStarSolver>(name, board_size, instances);
+    } else if (algorithm == "parallel-ida") {
+        return run_set<ParallelIDASolver>(name, board_size, instances);
+    } else if (algorithm != "ida") {
+        throw std::string("Unknown algorithm: ") + algorithm;
+    }
+
+    if (heuristic == "default") {
+        return run_set<IDASolver>(name, board_size, instances);
+    } else if (heuristic == "manhattan") {
+        return run_set<BasicIDASolver<WithPerimeter<ManhattanDistance>>>(name, board_size, instances);
+    } else if (heuristic == "linear-conflict") {
+        return run_set<BasicIDASolver<WithPerimeter<LinearConflict>>>(name, board_size, instances);
+    } else if (heuristic == "enhanced-linear-conflict") {
+        return run_set<BasicIDASolver<WithPerimeter<EnhancedLinearConflict>>>(name, board_size, instances);
+    } else if (heuristic == "walking-distance") {
+        return run_set<BasicIDASolver<WithPerimeter<WalkingDistance>>>(name, board_size, instances);
+    } else if (heuristic == "pdb-linear-conflict") {
+        return run_set<BasicIDASolver<WithPerimeter<MaxOf<PatternDatabaseHeuristic, LinearConflict>>>>(name, board_size, instances);
+    }
+
+    throw std::string("Unknown heuristic: ") + heuristic;
+}
+
+/**
+ * Time generating each standard pattern database partition into a scratch directory.
+ */
+static std::vector< std::pair<std::string, double> > run_pattern_database_generation()
+{
+    std::vector< std::pair<std::string, double> > results;
+    std::vector<uint8_t> goal_board = taquin_tokenise_board_string("1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 0");
+    std::vector< std::pair<std::string, std::set<uint8_t> > > partitions = {
+        {"234", {2,3,4}},
+        {"15691013", {1,5,6,9,10,13}},
+        {"7811121415", {7,8,11,12,14,15}}
+    };
+
+    std::string directory = std::experimental::filesystem::temp_directory_path().string() + "/taquinsolve-bench";
+    std::experimental::filesystem::create_directory(directory);
+
+    for (std::pair<std::string, std::set<uint8_t> > partition : partitions) {
+        std::string path = directory + "/" + partition.first + ".db.bin";
+        std::experimental::filesystem::remove(path);
+
+        std::cerr << "Generating " << partition.first << ".." << std::endl;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        generate_pattern_database(goal_board, partition.second, 4, path);
+        results.push_back({partition.first, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()});
+
+        std::experimental::filesystem::remove(path);
+    }
+
+    return results;
+}
+
+static double percentile(std::vector<double> values, double p)
+{
+    std::sort(values.begin(), values.end());
+    size_t index = std::min(values.size() - 1, (size_t)(p * values.size()));
+    return values[index];
+}
+
+static std::string set_to_json(SetResult result)
+{
+    std::ostringstream json;
+    json << "{\"name\":\"" << result.name << "\""
+         << ",\"board_size\":" << (int)result.board_size
+         << ",\"instances\":" << result.solve_times.size();
+
+    if (!result.solve_times.empty()) {
+        json << ",\"total_moves\":" << result.total_moves
+             << ",\"nodes_generated\":" << result.nodes_generated
+             << ",\"nodes_per_second\":" << (result.total_time > 0 ? result.nodes_generated / result.total_time : 0)
+             << ",\"database_load_time\":" << result.database_load_time / 1e6
+             << ",\"solve_time\":{"
+             << "\"total\":" << result.total_time
+             << ",\"p50\":" << percentile(result.solve_times, 0.50)
+             << ",\"p90\":" << percentile(result.solve_times, 0.90)
+             << ",\"p99\":" << percentile(result.solve_times, 0.99)
+             << ",\"max\":" << percentile(result.solve_times, 1.0)
+             << "}";
+
+        json << ",\"algorithms\":{";
+        bool first = true;
+        for (const std::pair<const std::string, Algorithm> &entry : ALGORITHM_NAMES) {
+            if (result.algorithms.count(entry.second)) {
+                json << (first ? "" : ",") << "\"" << entry.first << "\":" << result.algorithms[entry.second];
+                first = false;
+            }
+        }
+        json << "}";
+    }
+
+    json << "}";
+    return json.str();
+}
+
+static void usage()
+{
+    std::cerr << "Usage: bench-solve [options]" << std::endl
+              << "  --seed N          Seed for the generated instance sets (default 1)" << std::endl
+              << "  --count-3x3 N     Number of uniformly random 3x3 boards (default 2000)" << std::endl
+              << "  --count-4x4 N     Number of random-walk 4x4 boards (default 20)" << std::endl
+              << "  --walk-length N   Random walk length of the 4x4 boards (default 40)" << std::endl
+              << "  --korf FILE       Also solve Korf's 100 instances, one blank-first board per line" << std::endl
+              << "  --algorithm NAME  Solve with ida, auto, exact-table, astar or parallel-ida (default ida)" << std::endl
+              << "  --heuristic NAME  Search IDA* with default, manhattan, linear-conflict, enhanced-linear-conflict," << std::endl
+              << "                    walking-distance or pdb-linear-conflict" << std::endl
+              << "  --pdb             Also time generating each standard pattern database" << std::endl
+              << "  --output FILE     Write the JSON report to FILE instead of stdout" << std::endl;
+}
+
+int main (int argc, char **argv)
+{
+    uint64_t seed = 1;
+    uint32_t count_3x3 = 2000;
+    uint32_t count_4x4 = 20;
+    uint32_t walk_length = 40;
+    std::string korf_path;
+    std::string output_path;
+    std::string algorithm = "ida";
+    std::string heuristic = "default";
+    bool run_pdb = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--seed" && has_value) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (arg == "--count-3x3" && has_value) {
+            count_3x3 = strtoul(argv[++i], NULL, 10);
+        } else if (arg == "--count-4x4" && has_value) {
+            count_4x4 = strtoul(argv[++i], NULL, 10);
+        } else if (arg == "--walk-length" && has_value) {
+            walk_length = strtoul(argv[++i], NULL, 10);
+        } else if (arg == "--korf" && has_value) {
+            korf_path = argv[++i];
+        } else if (arg == "--algorithm" && has_value) {
+            algorithm = argv[++i];
+        } else if (arg == "--heuristic" && has_value) {
+            heuristic = argv[++i];
+        } else if (arg == "--output" && has_value) {
+            output_path = argv[++i];
+        } else if (arg == "--pdb") {
+            run_pdb = true;
+        } else {
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<SetResult> sets;
+    std::vector< std::pair<std::string, double> > generation_times;
+
+    try {
+        std::mt19937_64 rng(seed);
+
+        std::vector< std::vector<uint8_t> > instances_3x3;
+        for (uint32_t i = 0; i < count_3x3; i++) {
+            instances_3x3.push_back(seeded_board(rng, 3));
+        }
+        sets.push_back(run_set(algorithm, heuristic, "random-3x3", 3, instances_3x3));
+
+        std::vector< std::vector<uint8_t> > instances_4x4;
+        for (uint32_t i = 0; i < count_4x4; i++) {
+            instances_4x4.push_back(seeded_walk(rng, 4, walk_length));
+        }
+        sets.push_back(run_set(algorithm, heuristic, "walk-4x4", 4, instances_4x4));
+
+        if (!korf_path.empty()) {
+            std::vector< std::vector<uint8_t> > instances_korf = read_instances(korf_path);
+            std::transform(instances_korf.begin(), instances_korf.end(), instances_korf.begin(), korf_to_standard);
+            sets.push_back(run_set(algorithm, heuristic, "korf-100", 4, instances_korf));
+        }
+
+        if (run_pdb) {
+            generation_times = run_pattern_database_generation();
+        }
+    } catch (std::string e) {
+        std::cerr << "Error: " << e << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    std::ostringstream json;
+    json << "{\"seed\":" << seed << ",\"algorithm\":\"" << algorithm << "\",\"heuristic\":\"" << heuristic << "\",\"sets\":[";
+    for (size_t i = 0; i < sets.size(); i++) {
+        json << (i ? "," : "") << set_to_json(sets[i]);
+    }
+    json << "],\"pattern_database_generation\":{";
+    for (size_t i = 0; i < generation_times.size(); i++) {
+        json << (i ? "," : "") << "\"" << generation_times[i].first << "\":" << generation_times[i].second;
+    }
+    json << "},\"max_rss_kb\":" << usage.ru_maxrss << "}" << std::endl;
+
+    if (output_path.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream output(output_path);
+        output << json.str();
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,189 @@
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+#include <taquinsolve.hh>
+#include <Trace.hh>
+
+using namespace TaquinSolve;
+
+/**
+ * The result of replaying one record.
+ */
+struct ReplayResult {
+    TraceOutcome outcome = TraceOutcome::SOLVED;
+    uint8_t solution_length = 0;
+    uint64_t solve_time = 0;
+    uint64_t nodes_generated = 0;
+};
+
+static double percentile(std::vector<double> values, double p)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, (size_t)(p * values.size()))];
+}
+
+static std::string times_to_json(std::vector<double> times)
+{
+    double total = 0;
+    for (double time : times) {
+        total += time;
+    }
+
+    std::ostringstream json;
+    json << "{\"total\":" << total
+         << ",\"p50\":" << percentile(times, 0.50)
+         << ",\"p90\":" << percentile(times, 0.90)
+         << ",\"p99\":" << percentile(times, 0.99)
+         << ",\"max\":" << percentile(times, 1.0)
+         << "}";
+    return json.str();
+}
+
+static void usage()
+{
+    std::cerr << "Usage: taquinsolve-replay [options] TRACE" << std::endl
+              << "  --rate X          Replay at X times the original rate, 0 for as fast as possible (default 0)" << std::endl
+              << "  --threads N       Number of threads solving concurrently (default 1)" << std::endl
+              << "  --output FILE     Write the JSON report to FILE instead of stdout" << std::endl;
+}
+
+int main (int argc, char **argv)
+{
+    double rate = 0;
+    uint32_t thread_count = 1;
+    std::string trace_path;
+    std::string output_path;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--rate" && has_value) {
+            rate = strtod(argv[++i], NULL);
+        } else if (arg == "--threads" && has_value) {
+            thread_count = std::max(1ul, strtoul(argv[++i], NULL, 10));
+        } else if (arg == "--output" && has_value) {
+            output_path = argv[++i];
+        } else if (trace_path.empty() && arg[0] != '-') {
+            trace_path = arg;
+        } else {
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (trace_path.empty()) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    //Don't capture the replay into a trace of its own
+    taquin_set_trace_file("");
+
+    std::vector<TraceRecord> records;
+    try {
+        TraceReader reader(trace_path);
+        TraceRecord record;
+        while (reader.read(record)) {
+            records.push_back(record);
+        }
+    } catch (std::string e) {
+        std::cerr << "Error: " << e << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (records.empty()) {
+        std::cerr << "Error: the trace is empty." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<ReplayResult> results(records.size());
+    std::atomic<size_t> next_record(0);
+    uint64_t first_timestamp = records.front().timestamp;
+    std::chrono::steady_clock::time_point replay_start = std::chrono::steady_clock::now();
+
+    //Each thread takes the next record, waits for its scheduled time if pacing, then solves it.
+    auto worker = [&]() {
+        size_t i;
+        while ((i = next_record++) < records.size()) {
+            const TraceRecord &record = records[i];
+
+            if (rate > 0) {
+                std::chrono::microseconds offset((uint64_t)((record.timestamp - first_timestamp) / rate));
+                std::this_thread::sleep_until(replay_start + offset);
+            }
+
+            SolveStats stats;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            try {
+                results[i].solution_length = taquin_solve(record.board, record.board_size, Algorithm::IDA, SolverOptions(), &stats).size();
+                results[i].nodes_generated = stats.nodes_generated;
+            } catch (...) {
+                results[i].outcome = TraceOutcome::FAILED;
+            }
+            results[i].solve_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < thread_count; t++) {
+        threads.push_back(std::thread(worker));
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - replay_start).count();
+
+    //Compare against the captured outcomes
+    std::vector<double> original_times;
+    std::vector<double> replay_times;
+    uint64_t original_nodes = 0;
+    uint64_t replay_nodes = 0;
+    uint64_t mismatches = 0;
+    uint64_t failures = 0;
+
+    for (size_t i = 0; i < records.size(); i++) {
+        original_times.push_back(records[i].solve_time / 1e6);
+        replay_times.push_back(results[i].solve_time / 1e6);
+        original_nodes += records[i].nodes_generated;
+        replay_nodes += results[i].nodes_generated;
+        failures += results[i].outcome == TraceOutcome::FAILED;
+
+        if (results[i].outcome != records[i].outcome || results[i].solution_length != records[i].solution_length) {
+            mismatches++;
+        }
+    }
+
+    std::ostringstream json;
+    json << "{\"records\":" << records.size()
+         << ",\"threads\":" << thread_count
+         << ",\"rate\":" << rate
+         << ",\"wall_time\":" << wall_time
+         << ",\"solves_per_second\":" << records.size() / wall_time
+         << ",\"failures\":" << failures
+         << ",\"mismatches\":" << mismatches
+         << ",\"nodes_generated\":{\"original\":" << original_nodes << ",\"replay\":" << replay_nodes << "}"
+         << ",\"solve_time\":{\"original\":" << times_to_json(original_times) << ",\"replay\":" << times_to_json(replay_times) << "}"
+         << "}" << std::endl;
+
+    if (output_path.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream output(output_path);
+        output << json.str();
+    }
+
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
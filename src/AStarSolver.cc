@@ -0,0 +1,187 @@
+#include <string>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+#include <chrono>
+
+#include "AStarSolver.hh"
+#include "IDASolver.hh"
+#include "GoalMapping.hh"
+
+using namespace TaquinSolve;
+
+/**
+ * Constructor.
+ *
+ * @param options Tunable parameters for the solver.
+ */
+AStarSolver::AStarSolver(SolverOptions options) : Solver(options), fallback_options(options)
+{
+}
+
+/**
+ * Constructor, with other options for the IDA* search used once the node limit is reached.
+ *
+ * @param options           Tunable parameters for the solver.
+ * @param fallback_options  Tunable parameters for the IDA* fallback.
+ */
+AStarSolver::AStarSolver(SolverOptions options, SolverOptions fallback_options) : Solver(options), fallback_options(fallback_options)
+{
+}
+
+/**
+ * Solve the board state given to this object, with IDA* if the node limit is reached.
+ *
+ * @param board         The board state.
+ * @param board_size    The width/height of the board.
+ * @param solution      Filled with the moves taken to reach the solution.
+ * @param stats         If given, filled with a description of the work done.
+ */
+void AStarSolver::solve_into(std::vector<uint8_t> board, uint8_t board_size, MoveSequence &solution, SolveStats *stats)
+{
+    this->stats = SolveStats();
+    this->stats.algorithm = Algorithm::ASTAR;
+
+    //Other goals are solved as the equivalent puzzle against the standard goal.
+    std::shared_ptr<GoalMapping> goal_mapping;
+    std::vector<uint8_t> mapped_board = board;
+    if (!this->options.goal_board.empty()) {
+        goal_mapping = std::shared_ptr<GoalMapping>(new GoalMapping(this->options.goal_board, board_size));
+        mapped_board = goal_mapping->map_board(board);
+    }
+
+    if (!this->search(mapped_board, board_size, solution)) {
+        //Too far away to hold every board, IDA* keeps only the current path
+        IDASolver fallback(this->fallback_options);
+        fallback.solve_into(board, board_size, solution, stats);
+        this->stats = fallback.get_stats();
+        return;
+    }
+
+    if (stats != NULL) {
+        *stats = this->stats;
+    }
+
+    if (goal_mapping != NULL) {
+        goal_mapping->unmap_moves(solution);
+    }
+}
+
+/**
+ * Search from the board against the standard goal.
+ *
+ * @param board         The board state.
+ * @param board_size    The width/height of the board.
+ * @param solution      Filled with the moves taken to reach the solution.
+ *
+ * @return False if the node limit was reached first.
+ */
+bool AStarSolver::search(std::vector<uint8_t> board, uint8_t board_size, MoveSequence &solution)
+{
+    ArenaScope arena_scope;
+
+    std::chrono::steady_clock::time_point phase_start = std::chrono::steady_clock::now();
+    if (this->uses_pattern_databases(board_size)) {
+        this->load_pattern_database(board_size);
+    }
+    this->stats.database_load_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - phase_start).count();
+
+    phase_start = std::chrono::steady_clock::now();
+    Board initial_board(board, board_size, this->pattern_database);
+    initial_board.validate_state();
+    this->stats.validation_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - phase_start).count();
+
+    phase_start = std::chrono::steady_clock::now();
+    const BoardTables *tables = initial_board.get_tables();
+    uint8_t bits = get_state_hash_bits(tables->cell_count);
+    StateHash goal_state = 0;
+    for (uint8_t i = 0; i < tables->cell_count - 1; i++) {
+        goal_state |= ((StateHash)(i + 1)) << (i * bits);
+    }
+
+    this->stats.initial_heuristic = initial_board.get_heuristic();
+
+    //Open boards by lowest estimated total, then deepest first, then oldest first
+    typedef std::tuple<uint8_t, uint8_t, uint32_t> OpenEntry;
+    auto compare = [](const OpenEntry &l, const OpenEntry &r) {
+        if (std::get<0>(l) != std::get<0>(r)) {
+            return std::get<0>(l) > std::get<0>(r);
+        }
+        if (std::get<1>(l) != std::get<1>(r)) {
+            return std::get<1>(l) < std::get<1>(r);
+        }
+        return std::get<2>(l) > std::get<2>(r);
+    };
+    std::priority_queue<OpenEntry, std::vector<OpenEntry>, decltype(compare)> open(compare);
+
+    //Every board generated, and the cheapest cost each state was reached at
+    std::vector<Node> nodes;
+    std::unordered_map<StateHash, uint8_t, StateHashHasher> best_costs;
+
+    nodes.push_back({initial_board.get_state_hash(), UINT32_MAX, 0, Moves::UP});
+    best_costs[nodes[0].state] = 0;
+    open.push(OpenEntry(this->stats.initial_heuristic, 0, 0));
+
+    std::vector<uint8_t> cells(tables->cell_count);
+    IterationStats iteration;
+    while (!open.empty()) {
+        uint32_t index = std::get<2>(open.top());
+        open.pop();
+        Node node = nodes[index];
+
+        //Reached again more cheaply since it was queued
+        if (node.cost > best_costs[node.state]) {
+            continue;
+        }
+
+        if (node.state == goal_state) {
+            std::vector<Moves> moves;
+            for (uint32_t i = index; nodes[i].parent != UINT32_MAX; i = nodes[i].parent) {
+                moves.push_back(nodes[i].move);
+            }
+            solution.clear();
+            for (std::vector<Moves>::reverse_iterator it = moves.rbegin(); it != moves.rend(); ++it) {
+                solution.push(*it);
+            }
+
+            iteration.bound = node.cost;
+            this->stats.iterations.push_back(iteration);
+            this->stats.nodes_expanded = iteration.nodes_expanded;
+            this->stats.nodes_generated = iteration.nodes_generated;
+            this->stats.solution_length = node.cost;
+            this->stats.search_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - phase_start).count();
+            this->stats.arena_high_water = SearchArena::get_thread_arena().get_high_water_mark();
+            return true;
+        }
+
+        if (nodes.size() > this->options.astar_node_limit) {
+            return false;
+        }
+
+        Board::unpack_state_hash(node.state, tables->cell_count, cells.data());
+        Board parent(cells, board_size, this->pattern_database);
+        iteration.nodes_expanded++;
+
+        for (uint8_t i = 0; i < parent.get_available_move_count(); i++) {
+            Moves move = parent.get_available_move(i);
+            std::shared_ptr<Board> child = parent.perform_move_in_arena(move);
+            iteration.nodes_generated++;
+
+            StateHash state = child->get_state_hash();
+            uint8_t cost = node.cost + 1;
+            auto it = best_costs.find(state);
+            if (it != best_costs.end() && it->second <= cost) {
+                continue;
+            }
+            best_costs[state] = cost;
+
+            if (this->pattern_database != NULL) {
+                this->stats.pdb_lookups += this->pattern_database->get_group_count();
+            }
+            nodes.push_back({state, index, cost, move});
+            open.push(OpenEntry(cost + child->get_heuristic(), cost, nodes.size() - 1));
+        }
+    }
+
+    throw std::string("Puzzle is unsolvable.");
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Solver.hh"
+
+namespace TaquinSolve
+{
+    /**
+     * A* search with the default heuristic, for boards close enough to the goal that every board
+     * it generates fits in memory. Unlike IDA* no board is expanded twice.
+     *
+     * Boards are held packed as their state hash, with the move and parent that reached them. Once
+     * more than SolverOptions::astar_node_limit are held the search gives up and IDA* solves the board.
+     */
+    class AStarSolver : public Solver
+    {
+        public:
+            AStarSolver(SolverOptions options = SolverOptions());
+            AStarSolver(SolverOptions options, SolverOptions fallback_options);
+
+            void solve_into(std::vector<uint8_t> board, uint8_t board_size, MoveSequence &solution, SolveStats *stats = NULL);
+
+        protected:
+            //Given to IDA* once the node limit is reached
+            SolverOptions fallback_options;
+
+            struct Node
+            {
+                StateHash state;
+                uint32_t parent;
+                uint8_t cost;
+                Moves move;
+            };
+
+            bool search(std::vector<uint8_t> board, uint8_t board_size, MoveSequence &solution);
+    };
+}
@@ -0,0 +1,107 @@
+#include <string>
+#include <thread>
+
+#include "AutoSolver.hh"
+#include "ExactTableSolver.hh"
+#include "AStarSolver.hh"
+#include "IDASolver.hh"
+#include "ParallelIDASolver.hh"
+#include "GoalMapping.hh"
+
+using namespace TaquinSolve;
+
+/**
+ * Constructor.
+ *
+ * @param options Tunable parameters for the solver, and the policy to pick engines by.
+ */
+AutoSolver::AutoSolver(SolverOptions options) : Solver(options)
+{
+}
+
+/**
+ * Solve the board state given to this object with the engine chosen for it.
+ *
+ * @param board         The board state.
+ * @param board_size    The width/height of the board.
+ * @param solution      Filled with the moves taken to reach the solution.
+ * @param stats         If given, filled with a description of the work done, including the engine used.
+ */
+void AutoSolver::solve_into(std::vector<uint8_t> board, uint8_t board_size, MoveSequence &solution, SolveStats *stats)
+{
+    SolverOptions engine_options = this->options;
+    std::unique_ptr<Solver> solver;
+
+    switch (this->choose(board, board_size, engine_options)) {
+        case Algorithm::EXACT_TABLE:
+            solver = std::unique_ptr<Solver>(new ExactTableSolver(engine_options));
+            break;
+        case Algorithm::ASTAR:
+            //Databases skipped for a short search are wanted again if it turns out too long for A*
+            solver = std::unique_ptr<Solver>(new AStarSolver(engine_options, this->options));
+            break;
+        case Algorithm::PARALLEL_IDA:
+            solver = std::unique_ptr<Solver>(new ParallelIDASolver(engine_options));
+            break;
+        case Algorithm::IDA:
+        default:
+            solver = std::unique_ptr<Solver>(new IDASolver(engine_options));
+            break;
+    }
+
+    solver->solve_into(board, board_size, solution, stats);
+    this->stats = solver->get_stats();
+}
+
+/**
+ * Pick the engine for a board.
+ *
+ * @param board             The board state.
+ * @param board_size        The width/height of the board.
+ * @param engine_options    The options to give the engine, updated if it should search without the pattern databases.
+ *
+ * @return The engine. Boards that can't be estimated go to IDA, which reports what is wrong with them.
+ */
+Algorithm AutoSolver::choose(std::vector<uint8_t> board, uint8_t board_size, SolverOptions &engine_options)
+{
+    const AlgorithmPolicy &policy = this->options.algorithm_policy;
+
+    if (board_size <= policy.exact_table_max_size && board_size <= ExactTableSolver::MAX_BOARD_SIZE) {
+        return Algorithm::EXACT_TABLE;
+    }
+
+    uint8_t estimate;
+    try {
+        if (!this->options.goal_board.empty()) {
+            board = GoalMapping(this->options.goal_board, board_size).map_board(board);
+        }
+
+        //Only databases already loaded are used to estimate, a solve never waits on them here
+        std::shared_ptr<PatternDatabase> pattern_database;
+        bool use_pattern_databases = this->uses_pattern_databases(board_size);
+        if (use_pattern_databases) {
+            pattern_database = Solver::get_loaded_pattern_database(this->options.use_huge_pages, board_size);
+        }
+
+        Board initial_board(board, board_size, pattern_database);
+        initial_board.validate_state();
+        estimate = initial_board.get_heuristic();
+
+        if (use_pattern_databases && pattern_database == NULL && estimate < policy.pattern_database_min_heuristic) {
+            engine_options.use_pattern_databases = false;
+        }
+    } catch (std::string) {
+        return Algorithm::IDA;
+    }
+
+    if (estimate <= policy.astar_max_heuristic) {
+        return Algorithm::ASTAR;
+    }
+
+    uint32_t threads = this->options.search_threads > 0 ? this->options.search_threads : std::thread::hardware_concurrency();
+    if (estimate >= policy.parallel_min_heuristic && threads > 1) {
+        return Algorithm::PARALLEL_IDA;
+    }
+
+    return Algorithm::IDA;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Solver.hh"
+
+namespace TaquinSolve
+{
+    /**
+     * Picks the engine likely to be cheapest for each board and solves with it, see AlgorithmPolicy.
+     *
+     *     Small boards                      EXACT_TABLE
+     *     Estimated close to the goal       ASTAR
+     *     Estimated far from the goal       PARALLEL_IDA, given more than one thread
+     *     Anything else                     IDA
+     *
+     * 4x4 boards are estimated with the pattern databases only if they are already loaded. While
+     * they aren't, boards that look easy enough are solved without them rather than waiting on the load.
+     */
+    class AutoSolver : public Solver
+    {
+        public:
+            AutoSolver(SolverOptions options = SolverOptions());
+
+            void solve_into(std::vector<uint8_t> board, uint8_t board_size, MoveSequence &solution, SolveStats *stats = NULL);
+
+            Algorithm choose(std::vector<uint8_t> board, uint8_t board_size, SolverOptions &engine_options);
+    };
+}
@@ -1,12 +1,22 @@
 #include <queue>
 #include <limits>
-#include <fstream>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 #include <experimental/filesystem>
 
 #include "BFSDatabaseGenerator.hh"
+#include "BoardKernels.hh"
+#include "PatternDatabase.hh"
 
 using namespace TaquinSolve;
 
+//States expanded between progress reports.
+static const uint64_t PROGRESS_INTERVAL = 1 << 20;
+
+//Bitset words handed to a thread at a time by generate_dense.
+static const size_t DENSE_CHUNK_WORDS = 1 << 12;
+
 /**
  * Generate a pattern database using a breadth-first search.
 
@@ -23,7 +33,15 @@ void BFSDatabaseGenerator::generate(std::vector<uint8_t> goal_board, std::set<ui
         return;
     }
 
-    std::queue<std::shared_ptr<Board> > frontier;
+    //Hashes of larger boards don't fit the sets below, and their groups wouldn't fit in memory as sets anyway
+    if (board_size * board_size > 16) {
+        this->generate_dense(goal_board, group_tiles, board_size, output_file);
+        return;
+    }
+
+    //The frontier, its boards and the visited set all come from the thread's search arena
+    ArenaScope arena_scope;
+    std::queue<std::shared_ptr<Board>, std::deque<std::shared_ptr<Board>, ArenaAllocator<std::shared_ptr<Board>>>> frontier;
 
     std::shared_ptr< std::set<uint8_t> > group_tiles_nozero_ptr = std::shared_ptr< std::set<uint8_t> >(new std::set<uint8_t>(group_tiles));
     group_tiles.insert(0);
@@ -35,20 +53,25 @@ void BFSDatabaseGenerator::generate(std::vector<uint8_t> goal_board, std::set<ui
     this->database_insert(initial_board, group_tiles_nozero_ptr, group_tiles_ptr);
     frontier.push(initial_board);
 
+    uint64_t expanded = 0;
     while (!frontier.empty()) {
         std::shared_ptr<Board> current = frontier.front();
         frontier.pop();
 
+        if (this->progress_callback && ++expanded % PROGRESS_INTERVAL == 0) {
+            this->progress_callback(this->visited.size(), current->get_cost());
+        }
+
         //Find the neighbors by applying each possible move
-        std::vector< std::shared_ptr<Board> > neighbors = this->perform_moves(current.get(), current->get_available_moves(), group_tiles_nozero_ptr);
+        BoardList neighbors = this->perform_moves(current.get(), group_tiles_nozero_ptr);
 
         for (
-            std::vector< std::shared_ptr<Board> >::iterator it = neighbors.begin();
+            BoardList::iterator it = neighbors.begin();
             it != neighbors.end();
             ++it
         ) {
             std::shared_ptr<Board> neighbor = *it;
-            uint64_t neighbor_hash = neighbor->get_partial_state_hash(group_tiles_ptr);
+            uint64_t neighbor_hash = (uint64_t) neighbor->get_partial_state_hash(group_tiles_ptr);
             if (this->check_visited(neighbor_hash)) {
                 this->database_insert(neighbor, group_tiles_nozero_ptr, group_tiles_ptr);
                 frontier.push(neighbor);
@@ -56,23 +79,221 @@ void BFSDatabaseGenerator::generate(std::vector<uint8_t> goal_board, std::set<ui
         }
     }
 
-    this->save_database(output_file);
+    this->save_database(output_file, board_size, BoardKernels::get_group_mask(*group_tiles_nozero_ptr));
+    this->database_clear();
+}
+
+/**
+ * Find the cells the empty cell can reach from the given cell without moving a tile of the group.
+ *
+ * @param tables    The geometry of the board.
+ * @param cell      The cell to start from.
+ * @param occupied  Bit c is set if cell c holds a tile of the group.
+ *
+ * @return Bit c is set for each cell reached.
+ */
+static uint32_t find_free_region(const BoardTables *tables, uint8_t cell, uint32_t occupied)
+{
+    uint32_t region = 1u << cell;
+    uint32_t grown;
+    do {
+        grown = region;
+        for (uint32_t remaining = region; remaining != 0; remaining &= remaining - 1) {
+            uint8_t current = __builtin_ctz(remaining);
+            for (uint8_t m = 0; m < tables->move_count[current]; m++) {
+                uint8_t neighbour = tables->neighbours[current][tables->moves[current][m]];
+                if (!(occupied & (1u << neighbour))) {
+                    region |= 1u << neighbour;
+                }
+            }
+        }
+    } while (region != grown);
+
+    return region;
+}
+
+/**
+ * Generate a pattern database with a breadth-first search over bitsets rather than sets of boards.
+ * Used for boards larger than 4x4, where a group of six tiles has hundreds of millions of placements.
+ *
+ * A state is the placement of the group's tiles, indexed as in the database table, and the region of
+ * cells the empty cell can reach without moving one of them, named by its lowest cell. Moves within
+ * a region are free, so every edge left costs one move of a group tile and the depth a placement is
+ * first reached at is its cost. Each depth is expanded across threads, three bits per state are
+ * kept: visited, this depth and the next. A 5x5 group of six tiles takes about 3GB.
+ *
+ * @param goal_board    The intended goal board that represents a solved solution.
+ * @param group_tiles   The set of tiles to consider for this database.
+ * @param board_size    The size of the game board.
+ * @param output_file   The file to write the generated database data to.
+ * @param thread_count  The number of threads to search with, 0 for one per hardware thread.
+ */
+void BFSDatabaseGenerator::generate_dense(std::vector<uint8_t> goal_board, std::set<uint8_t> group_tiles, uint8_t board_size, std::string output_file, uint32_t thread_count)
+{
+    if (std::experimental::filesystem::exists(output_file)) {
+        return;
+    }
+
+    const BoardTables *tables = get_board_tables(board_size);
+    if (tables == NULL || goal_board.size() != tables->cell_count) {
+        throw std::string("Board size invalid.\nThis library only supports board sizes 2-5.");
+    }
+    uint8_t cell_count = tables->cell_count;
+
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    //The table the costs end up in decides how placements are indexed
+    PatternDatabase pattern_database(board_size);
+    pattern_database.add_group(BoardKernels::get_group_mask(group_tiles));
+    std::vector<uint8_t> tiles = pattern_database.get_tile_order(0);
+
+    std::vector<uint64_t> multipliers;
+    size_t placement_count = 1;
+    for (size_t i = 0; i < tiles.size(); i++) {
+        multipliers.push_back(placement_count);
+        placement_count *= cell_count;
+    }
+
+    size_t word_count = (placement_count * cell_count + 63) / 64;
+    std::vector<uint64_t> visited(word_count, 0);
+    std::vector<uint64_t> current(word_count, 0);
+    std::vector<uint64_t> next(word_count, 0);
+    std::vector<uint8_t> costs(placement_count, UINT8_MAX);
+
+    //Start from the goal
+    uint8_t positions[MAX_CELLS] = {0};
+    uint32_t occupied = 0;
+    uint8_t zero_position = 0;
+    for (uint8_t cell = 0; cell < cell_count; cell++) {
+        positions[goal_board[cell]] = cell;
+        if (group_tiles.count(goal_board[cell])) {
+            occupied |= 1u << cell;
+        } else if (goal_board[cell] == 0) {
+            zero_position = cell;
+        }
+    }
+
+    uint32_t index;
+    pattern_database.get_indices(positions, &index);
+    size_t initial_state = (size_t) index * cell_count + __builtin_ctz(find_free_region(tables, zero_position, occupied));
+    visited[initial_state / 64] |= 1ull << (initial_state % 64);
+    current[initial_state / 64] |= 1ull << (initial_state % 64);
+    costs[index] = 0;
+
+    uint64_t visited_count = 1;
+    uint8_t depth = 0;
+    std::atomic<uint64_t> found(1);
+
+    while (found > 0) {
+        found = 0;
+        std::atomic<size_t> next_chunk(0);
+
+        auto worker = [&]() {
+            size_t chunk;
+            while ((chunk = next_chunk++) * DENSE_CHUNK_WORDS < word_count) {
+                size_t end = std::min(word_count, (chunk + 1) * DENSE_CHUNK_WORDS);
+                for (size_t word = chunk * DENSE_CHUNK_WORDS; word < end; word++) {
+                    for (uint64_t bits = current[word]; bits != 0; bits &= bits - 1) {
+                        size_t state = word * 64 + __builtin_ctzll(bits);
+                        size_t placement = state / cell_count;
+                        uint8_t region_cell = state % cell_count;
+
+                        uint8_t cells[MAX_CELLS];
+                        uint32_t state_occupied = 0;
+                        size_t remainder = placement;
+                        for (size_t i = 0; i < tiles.size(); i++) {
+                            cells[i] = remainder % cell_count;
+                            remainder /= cell_count;
+                            state_occupied |= 1u << cells[i];
+                        }
+                        uint32_t region = find_free_region(tables, region_cell, state_occupied);
+
+                        //Slide each group tile next to the region into it
+                        for (size_t i = 0; i < tiles.size(); i++) {
+                            uint8_t cell = cells[i];
+                            for (uint8_t m = 0; m < tables->move_count[cell]; m++) {
+                                uint8_t target = tables->neighbours[cell][tables->moves[cell][m]];
+                                if (!(region & (1u << target))) {
+                                    continue;
+                                }
+
+                                uint32_t new_occupied = state_occupied ^ (1u << cell) ^ (1u << target);
+                                size_t new_placement = placement + multipliers[i] * target - multipliers[i] * cell;
+                                size_t new_state = new_placement * cell_count + __builtin_ctz(find_free_region(tables, cell, new_occupied));
+
+                                uint64_t bit = 1ull << (new_state % 64);
+                                if (__atomic_fetch_or(&visited[new_state / 64], bit, __ATOMIC_RELAXED) & bit) {
+                                    continue;
+                                }
+                                __atomic_fetch_or(&next[new_state / 64], bit, __ATOMIC_RELAXED);
+                                found++;
+
+                                //Every thread reaching a placement first at this depth writes the same cost
+                                if (__atomic_load_n(&costs[new_placement], __ATOMIC_RELAXED) == UINT8_MAX) {
+                                    __atomic_store_n(&costs[new_placement], (uint8_t)(depth + 1), __ATOMIC_RELAXED);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (uint32_t t = 1; t < thread_count; t++) {
+            threads.push_back(std::thread(worker));
+        }
+        worker();
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        current.swap(next);
+        std::fill(next.begin(), next.end(), 0);
+        visited_count += found;
+        depth++;
+
+        if (this->progress_callback) {
+            this->progress_callback(visited_count, depth);
+        }
+    }
+
+    //Placements never reached are unknown, which reads as 0
+    for (size_t placement = 0; placement < placement_count; placement++) {
+        pattern_database.set_entry(0, placement, costs[placement] == UINT8_MAX ? 0 : costs[placement]);
+    }
+
+    pattern_database.save(0, output_file);
 }
 
 /**
- * Create a list of new boards by applied each of the given moves to the given board.
+ * Set a function to report progress to during generation.
+ * It is given the number of states visited and the cost of the states being expanded.
  *
- * @param board The reference board state.
- * @param moves A list of moves to apply.
+ * @param progress_callback The function to call.
+ */
+void BFSDatabaseGenerator::set_progress_callback(std::function<void(uint64_t visited, uint8_t depth)> progress_callback)
+{
+    this->progress_callback = progress_callback;
+}
+
+/**
+ * Create a list of new boards by applying each possible move to the given board.
+ *
+ * @param board         The reference board state.
+ * @param group_tiles   If given, only moves of these tiles count towards the cost.
  *
  * @return A list of new boards with the moves performed.
  */
-std::vector< std::shared_ptr<Board> > BFSDatabaseGenerator::perform_moves(Board *board, std::vector<Moves> moves, std::shared_ptr< std::set<uint8_t> > group_tiles) {
-    std::vector< std::shared_ptr<Board> > results;
+BoardList BFSDatabaseGenerator::perform_moves(Board *board, std::shared_ptr< std::set<uint8_t> > group_tiles) {
+    uint8_t move_count = board->get_available_move_count();
+    BoardList results;
+    results.reserve(move_count);
 
-    for (Moves move : moves) {
-        std::shared_ptr<Board> new_board = std::shared_ptr<Board>(board->perform_move(move, group_tiles));
-        results.push_back(new_board);
+    for (uint8_t i = 0; i < move_count; i++) {
+        results.push_back(board->perform_move_in_arena(board->get_available_move(i), group_tiles));
     }
 
     return results;
@@ -101,8 +322,8 @@ void BFSDatabaseGenerator::database_insert(
     std::shared_ptr< std::set<uint8_t> > group_tiles_nozero,
     std::shared_ptr< std::set<uint8_t> > group_tiles
 ) {
-    this->visited.insert(board->get_partial_state_hash(group_tiles));
-    uint64_t db_index = board->get_partial_state_hash(group_tiles_nozero);
+    this->visited.insert((uint64_t) board->get_partial_state_hash(group_tiles));
+    uint64_t db_index = (uint64_t) board->get_partial_state_hash(group_tiles_nozero);
 
     if (board->get_cost() < this->database_get_value(db_index)) {
         this->database.insert(
@@ -136,7 +357,7 @@ bool BFSDatabaseGenerator::check_visited(uint64_t index)
  */
 uint8_t BFSDatabaseGenerator::database_get_value(uint64_t index)
 {
-    std::map<uint64_t, uint8_t>::iterator it = this->database.find(index);
+    auto it = this->database.find(index);
     if (it == this->database.end()) {
         return std::numeric_limits<uint8_t>::max();
     } else {
@@ -145,21 +366,24 @@ uint8_t BFSDatabaseGenerator::database_get_value(uint64_t index)
 }
 
 /**
- * Write the completed database to file as binary.
+ * Write the completed database to file as a dense table, in the group's default tile order.
  *
- * @param std::string output_file The path to write the database to.
+ * @param output_file   The path to write the database to.
+ * @param board_size    The size of the game board.
+ * @param group_mask    Bit t is set for each tile t in the group.
  */
-void BFSDatabaseGenerator::save_database(std::string output_file)
+void BFSDatabaseGenerator::save_database(std::string output_file, uint8_t board_size, uint32_t group_mask)
 {
-    std::ofstream file (output_file, std::ios::out | std::ios::binary);
+    PatternDatabase pattern_database(board_size);
+    pattern_database.add_group(group_mask);
 
     for (
-        std::map<uint64_t, uint8_t>::iterator it = this->database.begin();
+        auto it = this->database.begin();
         it != this->database.end();
         ++it
     ) {
-        file.write((char *)(&it->first), 8);
-        file.write((char *)(&it->second), 1);
+        pattern_database.insert(it->first, it->second);
     }
-    file.close();
+
+    pattern_database.save(0, output_file);
 }
@@ -4,6 +4,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <functional>
 #include <cstdint>
 
 #include "Board.hh"
@@ -14,12 +15,18 @@ namespace TaquinSolve
     {
         public:
             void generate(std::vector<uint8_t> goal_board, std::set<uint8_t> group_tiles, uint8_t board_size, std::string output_file);
+            void generate_dense(std::vector<uint8_t> goal_board, std::set<uint8_t> group_tiles, uint8_t board_size, std::string output_file, uint32_t thread_count = 0);
+            void set_progress_callback(std::function<void(uint64_t visited, uint8_t depth)> progress_callback);
 
-            std::vector< std::shared_ptr<Board> > perform_moves(Board *board, std::vector<Moves> moves, std::shared_ptr< std::set<uint8_t> > group_tiles = NULL);
+            BoardList perform_moves(Board *board, std::shared_ptr< std::set<uint8_t> > group_tiles = NULL);
 
         protected:
-            std::set<uint64_t> visited;
-            std::map<uint64_t, uint8_t> database;
+            //Held in the search arena during generation and emptied afterwards
+            std::set<uint64_t, std::less<uint64_t>, ArenaAllocator<uint64_t>> visited;
+            std::map<uint64_t, uint8_t, std::less<uint64_t>, ArenaAllocator<std::pair<const uint64_t, uint8_t>>> database;
+
+            //Called every so often during generation, if set
+            std::function<void(uint64_t visited, uint8_t depth)> progress_callback;
 
             void database_clear();
 
@@ -33,6 +40,6 @@ namespace TaquinSolve
 
             uint8_t database_get_value(uint64_t index);
 
-            void save_database(std::string output_file);
+            void save_database(std::string output_file, uint8_t board_size, uint32_t group_mask);
     };
 }
@@ -3,6 +3,11 @@
 #include <cstddef>
 
 #include "Board.hh"
+#include "Heuristics.hh"
+#include "PerimeterDatabase.hh"
+#include "BoardKernels.hh"
+#include "BoardParser.hh"
+#include "WalkingDistance.hh"
 #include "taquinsolve.hh"
 
 using namespace TaquinSolve;
@@ -15,23 +20,54 @@ using namespace TaquinSolve;
  * @param state         An array of integers representing the board state in row major encoding.
  * @param board_size    The width/height of the board.
  *                      The board state must contain board_size^2 entries.
- * @param move_history  A queue of moves taken to get to this board state.
+ * @param pattern_database    The pattern database used by the heuristic, if any.
+ * @param perimeter_database  The goal perimeter database used by the heuristic, if any.
+ * @param move_history  The moves taken to get to this board state.
  */
 Board::Board(
-    std::vector<uint8_t> state,
+    const std::vector<uint8_t> &state,
     uint8_t board_size,
-    std::shared_ptr< std::map<uint64_t, uint8_t> > pattern_database,
-    std::queue<Moves> move_history
-) : state(state), board_size(board_size), pattern_database(pattern_database), move_history(move_history)
+    std::shared_ptr<PatternDatabase> pattern_database,
+    std::shared_ptr<PerimeterDatabase> perimeter_database,
+    MoveSequence move_history
+) : board_size(board_size), tables(get_board_tables(board_size)), move_history(move_history), pattern_database(pattern_database), perimeter_database(perimeter_database)
 {
+    //Oversized states are kept only as a count, for validate_state() to report
+    this->cell_count = std::min(state.size(), (size_t) MAX_CELLS);
+    this->given_cell_count = std::min(state.size(), (size_t) UINT16_MAX);
+    std::copy(state.begin(), state.begin() + this->cell_count, this->state);
+
     //Find where the empty cell is
-    for (uint8_t i = 0; i < this->state.size(); i++) {
+    for (uint8_t i = 0; i < this->cell_count; i++) {
         if (this->state[i] == 0) {
             this->zero_position = i;
         }
     }
 }
 
+/**
+ * Constructor used when applying moves.
+ * The tables and empty cell position are already known from the parent board.
+ *
+ * @param state                 The tiles in row major order, board_size^2 of them.
+ * @param tables                The geometry tables of the parent board.
+ * @param zero_position         The cell holding the empty tile.
+ * @param pattern_database      The pattern database used by the heuristic, if any.
+ * @param perimeter_database    The goal perimeter database used by the heuristic, if any.
+ * @param move_history          The moves taken to get to this board state.
+ */
+Board::Board(
+    const uint8_t *state,
+    const BoardTables *tables,
+    uint8_t zero_position,
+    std::shared_ptr<PatternDatabase> pattern_database,
+    std::shared_ptr<PerimeterDatabase> perimeter_database,
+    const MoveSequence &move_history
+) : cell_count(tables->cell_count), given_cell_count(tables->cell_count), board_size(tables->board_size), tables(tables), zero_position(zero_position), move_history(move_history), pattern_database(pattern_database), perimeter_database(perimeter_database)
+{
+    std::copy(state, state + this->cell_count, this->state);
+}
+
 /**
  * Validates the current board state.
  * Are there the right number of tiles?
@@ -39,33 +75,28 @@ Board::Board(
  */
 void Board::validate_state()
 {
-    //Check if the board size is valid (2-4).
-    if (this->board_size < 2 || this->board_size > 4) {
-        throw std::string("Board size invalid.\nThis library only supports board sizes 2-4.");
+    //Check if the board size is valid (2-5).
+    if (this->board_size < 2 || this->board_size > MAX_BOARD_SIZE) {
+        throw std::string("Board size invalid.\nThis library only supports board sizes 2-5.");
     }
 
     //Ensure we have the right number of positions
-    if (this->state.size() != this->board_size * this->board_size) {
-        throw std::string("Not enough tiles to fill board: ") + std::to_string(this->state.size()) + "/" + std::to_string(this->board_size * this->board_size);
+    if (this->given_cell_count != this->board_size * this->board_size) {
+        throw std::string("Not enough tiles to fill board: ") + std::to_string(this->given_cell_count) + "/" + std::to_string(this->board_size * this->board_size);
     }
 
-    //Sort the indices and make sure they are a sequence from 0.
-    std::vector<uint8_t> sorted_state = this->state;
-    std::sort(sorted_state.begin(), sorted_state.end());
+    //Check the tiles are a sequence from 0 and the board is solvable in one pass.
+    ParseError error = BoardParser::validate(this->state, this->board_size);
 
-    uint8_t last = 0;
-    for (
-        std::vector<uint8_t>::iterator it = sorted_state.begin();
-        it != sorted_state.end();
-        ++it
-    ) {
-        if ((*it) != last) {
-            throw std::string("Improper sequence given, missing: ") + std::to_string(last);
+    if (error == ParseError::TILE_OUT_OF_RANGE || error == ParseError::DUPLICATE_TILE) {
+        uint8_t missing = 0;
+        while (std::find(this->state, this->state + this->cell_count, missing) != this->state + this->cell_count) {
+            missing++;
         }
-        last = (*it)+1;
+        throw std::string("Improper sequence given, missing: ") + std::to_string(missing);
     }
 
-    if (!taquin_check_solvable(this->state, this->board_size)) {
+    if (error == ParseError::UNSOLVABLE) {
         throw std::string("Board state is unsolvable");
     }
 
@@ -79,26 +110,32 @@ void Board::validate_state()
  */
 std::vector<Moves> Board::get_available_moves()
 {
-    std::vector<Moves> output;
-
-    //Get cartesian coordinates of the zero position
-    uint8_t empty_x = this->zero_position % this->board_size;
-    uint8_t empty_y = this->zero_position / this->board_size;
-
-    //Check if zero is on any boundary
-    if (empty_x > 0)
-        output.push_back(Moves::LEFT);
-
-    if (empty_x < this->board_size-1)
-        output.push_back(Moves::RIGHT);
+    if (this->tables == NULL) {
+        return std::vector<Moves>();
+    }
 
-    if (empty_y > 0)
-        output.push_back(Moves::UP);
+    const Moves *moves = this->tables->moves[this->zero_position];
+    return std::vector<Moves>(moves, moves + this->tables->move_count[this->zero_position]);
+}
 
-    if (empty_y < this->board_size-1)
-        output.push_back(Moves::DOWN);
+/**
+ * Count the moves that can be taken from this board state, without allocating a list of them.
+ *
+ * @return The number of possible moves.
+ */
+uint8_t Board::get_available_move_count()
+{
+    return this->tables == NULL ? 0 : this->tables->move_count[this->zero_position];
+}
 
-    return output;
+/**
+ * @param index Which of the possible moves, less than get_available_move_count().
+ *
+ * @return The move.
+ */
+Moves Board::get_available_move(uint8_t index)
+{
+    return this->tables->moves[this->zero_position][index];
 }
 
 /**
@@ -110,8 +147,8 @@ bool Board::check_solved()
 {
     uint8_t compare = 1;
     for (
-        std::vector<uint8_t>::iterator it = this->state.begin();
-        it != this->state.end()-1;
+        const uint8_t *it = this->state;
+        it < this->state + this->cell_count - 1;
         ++it
     ) {
         if ((*it) != compare++) {
@@ -124,6 +161,8 @@ bool Board::check_solved()
 
 /**
  * Perform the given move upon a copy of this board and return it.
+ * Unlike the search, boards moved this way can go on past MoveSequence::CAPACITY moves,
+ * from then on they stop recording their history, see has_move_history().
  *
  * @param move The move to apply.
  *
@@ -131,34 +170,72 @@ bool Board::check_solved()
  */
 Board *Board::perform_move(Moves move, std::shared_ptr<std::set<uint8_t> > group_tiles)
 {
-    std::vector<uint8_t> new_state = this->state;
-    uint8_t tile;
-    switch (move) {
-        case Moves::UP:
-            tile = new_state[this->zero_position - this->board_size];
-            new_state[this->zero_position] = tile;
-            new_state[this->zero_position - this->board_size] = 0;
-            break;
-
-        case Moves::DOWN:
-            tile = new_state[this->zero_position + this->board_size];
-            new_state[this->zero_position] = tile;
-            new_state[this->zero_position + this->board_size] = 0;
-            break;
-
-        case Moves::LEFT:
-            tile = new_state[this->zero_position - 1];
-            new_state[this->zero_position] = tile;
-            new_state[this->zero_position - 1] = 0;
-            break;
-
-        case Moves::RIGHT:
-            tile = new_state[this->zero_position + 1];
-            new_state[this->zero_position] = tile;
-            new_state[this->zero_position + 1] = 0;
-            break;
+    uint8_t new_state[MAX_CELLS];
+    MoveSequence new_history;
+    bool track_history = this->track_history && this->move_history.size() < MoveSequence::CAPACITY;
+    uint8_t new_zero_position = this->move_state(move, group_tiles, new_state, new_history, track_history);
+
+    Board *board = new Board(new_state, this->tables, new_zero_position, this->pattern_database, this->perimeter_database, new_history);
+    board->track_history = track_history;
+    board->follow_parent(*this, move);
+
+    return board;
+}
+
+/**
+ * Perform the given move upon a copy of this board, allocated from the calling thread's search arena.
+ * The board and its reference count share one allocation.
+ *
+ * @param move The move to apply.
+ *
+ * @return A new board object with the move applied.
+ */
+std::shared_ptr<Board> Board::perform_move_in_arena(Moves move, std::shared_ptr<std::set<uint8_t> > group_tiles)
+{
+    uint8_t new_state[MAX_CELLS];
+    MoveSequence new_history;
+    uint8_t new_zero_position = this->move_state(move, group_tiles, new_state, new_history, this->track_history);
+
+    std::shared_ptr<Board> board = std::allocate_shared<Board>(
+        ArenaAllocator<Board>(),
+        (const uint8_t *) new_state,
+        this->tables,
+        new_zero_position,
+        this->pattern_database,
+        this->perimeter_database,
+        new_history
+    );
+    board->track_history = this->track_history;
+    board->follow_parent(*this, move);
+
+    return board;
+}
+
+/**
+ * Work out the state and history after the given move.
+ *
+ * @param move          The move to apply.
+ * @param group_tiles   If given, only moves of these tiles are added to the history.
+ * @param new_state     Filled with the tiles after the move.
+ * @param new_history   Filled with the history after the move.
+ * @param track_history If false the history is left empty.
+ *
+ * @return The new position of the empty tile.
+ */
+uint8_t Board::move_state(Moves move, std::shared_ptr<std::set<uint8_t> > group_tiles, uint8_t *new_state, MoveSequence &new_history, bool track_history)
+{
+    std::copy(this->state, this->state + this->cell_count, new_state);
+
+    //Slide the neighbouring tile into the empty cell
+    uint8_t new_zero_position = this->tables->neighbours[this->zero_position][move];
+    uint8_t tile = new_state[new_zero_position];
+    new_state[this->zero_position] = tile;
+    new_state[new_zero_position] = 0;
+
+    if (!track_history) {
+        return new_zero_position;
     }
-    std::queue<Moves> new_history;
+
     new_history = this->move_history;
 
     if (group_tiles != NULL) {
@@ -171,7 +248,7 @@ Board *Board::perform_move(Moves move, std::shared_ptr<std::set<uint8_t> > group
         new_history.push(move);
     }
 
-    return new Board(new_state, this->board_size, this->pattern_database, new_history);
+    return new_zero_position;
 }
 
 /**
@@ -179,49 +256,85 @@ Board *Board::perform_move(Moves move, std::shared_ptr<std::set<uint8_t> > group
  *
  * @return Move history.
  */
-std::queue<Moves> Board::get_move_history()
+const MoveSequence &Board::get_move_history()
 {
     return this->move_history;
 }
 
 /**
- * Replace the move history of this board state with the given one.
+ * Check whether the history of this board is recorded.
+ * Boards moved past MoveSequence::CAPACITY moves with perform_move() stop recording,
+ * their history reads as empty and their cost as 0 until it is replaced.
+ *
+ * @return True if the history is recorded.
+ */
+bool Board::has_move_history()
+{
+    return this->track_history;
+}
+
+/**
+ * Replace the move history of this board state with the given one, recording moves again if it had stopped.
  * This is used in the search algorithm when the same board state is found by a more efficient route.
  *
- * @param move_history A new move history queue.
+ * @param move_history A new move history.
  */
-void Board::replace_move_history(std::queue<Moves> move_history)
+void Board::replace_move_history(const MoveSequence &move_history)
 {
     this->move_history = move_history;
+    this->track_history = true;
     this->heuristic_dirty = true;
 }
 
 
 std::vector<uint8_t> Board::get_state()
+{
+    return std::vector<uint8_t>(this->state, this->state + this->cell_count);
+}
+
+uint8_t Board::get_board_size()
+{
+    return this->board_size;
+}
+
+/**
+ * @return The tiles in row major order, get_board_size() squared of them.
+ */
+const uint8_t *Board::get_cells()
 {
     return this->state;
 }
 
+/**
+ * @return The precomputed geometry for this board size, NULL if the size is unsupported.
+ */
+const BoardTables *Board::get_tables()
+{
+    return this->tables;
+}
+
 /**
  * Create a unique hash of the board state to act as a simple
  * identifier.
+ * Each cell takes get_state_hash_bits() bits, so boards up to 4x4 hash below 2^64.
  *
  * @return A unique hash of the board state.
  */
-uint64_t Board::get_state_hash()
+StateHash Board::get_state_hash()
 {
     if (!this->state_hash_dirty) {
         return this->state_hash;
     }
 
-    uint64_t state_representation = 0;
+    uint8_t bits = get_state_hash_bits(this->cell_count);
+    StateHash state_representation = 0;
     unsigned int i=0;
     for (
-        std::vector<uint8_t>::iterator it = this->state.begin();
-        it != this->state.end();
+        const uint8_t *it = this->state;
+        it < this->state + this->cell_count;
         ++it, i++
     ) {
-        state_representation += ((uint64_t)(*it)) << (i*4);
+        state_representation += ((StateHash)(*it)) << (i*bits);
     }
 
     this->state_hash = state_representation;
@@ -230,6 +343,21 @@ uint64_t Board::get_state_hash()
     return this->state_hash;
 }
 
+/**
+ * Unpack a hash from get_state_hash() back into the tiles of the board.
+ *
+ * @param state_hash    The hash of a valid board state.
+ * @param cell_count    The number of cells on the board.
+ * @param cells         Filled with cell_count tiles.
+ */
+void Board::unpack_state_hash(StateHash state_hash, uint8_t cell_count, uint8_t *cells)
+{
+    uint8_t bits = get_state_hash_bits(cell_count);
+    for (uint8_t i = 0; i < cell_count; i++) {
+        cells[i] = (state_hash >> (i * bits)) & ((1 << bits) - 1);
+    }
+}
+
 /**
  * Create a unique hash of the board state to act as a simple
  * identifier.
@@ -239,35 +367,23 @@ uint64_t Board::get_state_hash()
  *
  * @return A unique hash of the partial board state.
  */
-uint64_t Board::get_partial_state_hash(std::shared_ptr<std::set<uint8_t> > group_tiles)
+StateHash Board::get_partial_state_hash(std::shared_ptr<std::set<uint8_t> > group_tiles)
 {
-    uint64_t state_representation = 0;
-    uint8_t unused_tile;
-
-    //Find an unused tile to mark as a tile in the out group.
-    for (uint8_t n : {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}) {
-        std::set<uint8_t>::iterator tile = group_tiles->find(n);
-        if (tile == group_tiles->end()) {
-            unused_tile = n;
-            break;
-        }
-    }
+    return this->get_partial_state_hash(BoardKernels::get_group_mask(*group_tiles));
+}
 
-    //Loop over the state and add the tile to the representation in the right position.
-    uint8_t i=0;
-    for (
-        std::vector<uint8_t>::iterator it = this->state.begin();
-        it != this->state.end();
-        ++it, i++
-    ) {
-        std::set<uint8_t>::iterator tile = group_tiles->find(*it);
-        if (tile == group_tiles->end()) {
-            state_representation += ((uint64_t)(unused_tile)) << (i*4);
-        } else {
-            state_representation += ((uint64_t)(*it)) << (i*4);
-        }
-    }
-    return state_representation;
+/**
+ * Create a unique hash of the board state to act as a simple
+ * identifier.
+ * Only include the tiles set in the given mask in the hash.
+ *
+ * @param group_mask Bit t is set if tile t is considered for this hash.
+ *
+ * @return A unique hash of the partial board state.
+ */
+StateHash Board::get_partial_state_hash(uint32_t group_mask)
+{
+    return BoardKernels::partial_state_hash(this->state, this->cell_count, group_mask);
 }
 
 /**
@@ -282,67 +398,251 @@ uint8_t Board::get_cost()
 }
 
 /**
- * Returns a simple heuristic which measures how many tiles are currently misplaced.
+ * Estimate the number of moves to the goal with the default heuristic, see Heuristics.hh.
  *
  * @return A heuristic value.
  */
 uint8_t Board::get_heuristic()
 {
-    if (!this->heuristic_dirty) {
-        return this->heuristic;
+    if (this->heuristic_dirty) {
+        this->set_heuristic(DefaultHeuristic().estimate(*this));
     }
 
-    uint8_t pattern_database_heuristic = this->get_pattern_db_heuristic();
+    return this->heuristic;
+}
 
-    uint8_t manhattan_sum = 0;
-    for (
-        uint8_t i = 0;
-        i < this->state.size();
-        i++
-    ) {
-        uint8_t j = this->state.at(i);
-        if (j == 0) {
-            continue;
-        }
+/**
+ * @return True if a heuristic value is cached for this board.
+ */
+bool Board::has_heuristic()
+{
+    return !this->heuristic_dirty;
+}
 
-        manhattan_sum += abs((i / this->board_size) - ((j-1) / this->board_size)) + abs((i % this->board_size) - ((j-1) % this->board_size));
+/**
+ * Cache a heuristic value for this board, returned by get_heuristic() from then on.
+ * Lets a search evaluate boards with a heuristic other than the default.
+ *
+ * @param heuristic The heuristic value.
+ */
+void Board::set_heuristic(uint8_t heuristic)
+{
+    this->heuristic = heuristic;
+    this->heuristic_dirty = false;
+}
+
+uint8_t Board::get_pattern_db_heuristic()
+{
+    if (this->pattern_database == NULL || this->pattern_database->get_board_size() != this->board_size) {
+        return 0;
     }
 
-    this->heuristic = std::max(pattern_database_heuristic, manhattan_sum);
-    this->heuristic_dirty = false;
+    this->update_pattern_db_indices();
 
-    return this->heuristic;
+    return this->pattern_database->lookup(this->pattern_db_indices);
 }
 
+/**
+ * The walking distance of this board, the sum of the row and column distances in its walking
+ * distance table. The table states are cached, and boards made by a move follow them from their parent.
+ *
+ * @return The walking distance, 0 if the board size has no table.
+ */
+uint8_t Board::get_walking_distance()
+{
+    if (this->tables == NULL) {
+        return 0;
+    }
 
-uint8_t Board::get_pattern_db_heuristic()
+    WalkingDistanceTable *table = WalkingDistanceTable::get(this->board_size);
+    if (table == NULL) {
+        return 0;
+    }
+
+    if (this->walking_distance_dirty) {
+        this->walking_distance_states[0] = table->get_state(this->state, this->tables, false);
+        this->walking_distance_states[1] = table->get_state(this->state, this->tables, true);
+        this->walking_distance_dirty = false;
+    }
+
+    return table->get_distance(this->walking_distance_states[0]) + table->get_distance(this->walking_distance_states[1]);
+}
+
+/**
+ * Carry the values the parent keeps incrementally through the move that made this board.
+ *
+ * @param parent    The board the move was applied to.
+ * @param move      The move.
+ */
+void Board::follow_parent(Board &parent, Moves move)
+{
+    this->follow_walking_distance(parent, move);
+    this->follow_linear_conflicts(parent, move);
+}
+
+/**
+ * Follow the parent's walking distance states through the move that made this board.
+ * Only the rows change on a vertical move and only the columns on a horizontal one.
+ * Nothing is done if the parent's states were never computed.
+ *
+ * @param parent    The board the move was applied to.
+ * @param move      The move.
+ */
+void Board::follow_walking_distance(Board &parent, Moves move)
+{
+    if (parent.walking_distance_dirty) {
+        return;
+    }
+
+    //The moved tile now sits where the parent's empty cell was
+    uint8_t tile = this->state[parent.zero_position];
+    bool columns = move == Moves::LEFT || move == Moves::RIGHT;
+    uint8_t goal_line = columns ? this->tables->goal_x[tile] : this->tables->goal_y[tile];
+
+    WalkingDistanceTable *table = WalkingDistanceTable::get(this->board_size);
+    this->walking_distance_states[columns] = table->move(parent.walking_distance_states[columns], move & 1, goal_line);
+    this->walking_distance_states[!columns] = parent.walking_distance_states[!columns];
+    this->walking_distance_dirty = false;
+}
+
+/**
+ * The number of tiles that must leave their row or column to let the others in it past, see LinearConflict.
+ * Counts are cached per line, and boards made by a move only recount the two lines the moved tile
+ * left and entered.
+ *
+ * @return The number of tiles over all rows and columns, 0 if the board size is unsupported.
+ */
+uint8_t Board::get_linear_conflicts()
 {
-    if (this->board_size != 4 || this->pattern_database == NULL) {
+    if (this->tables == NULL) {
         return 0;
     }
 
-    uint8_t pattern_database_heuristic = 0;
+    this->update_line_conflicts();
+
+    uint8_t conflicts = 0;
+    for (uint8_t line = 0; line < this->board_size; line++) {
+        conflicts += this->line_conflicts[0][line] + this->line_conflicts[1][line];
+    }
 
-    std::set<uint8_t> group_tiles = {2,3,4};
-    std::map<uint64_t, uint8_t>::iterator search = this->pattern_database->find(this->get_partial_state_hash(std::shared_ptr< std::set<uint8_t> >(new std::set<uint8_t>(group_tiles))));
+    return conflicts;
+}
 
-    if (search != this->pattern_database->end()) {
-        pattern_database_heuristic += search->second;
+/**
+ * @param columns   True for a column, false for a row.
+ * @param line      The row or column index.
+ *
+ * @return The number of tiles that must leave the line to resolve its linear conflicts.
+ */
+uint8_t Board::get_line_conflicts(bool columns, uint8_t line)
+{
+    this->update_line_conflicts();
+
+    return this->line_conflicts[columns][line];
+}
+
+/**
+ * Count the linear conflicts of every line from scratch, if they aren't already known.
+ */
+void Board::update_line_conflicts()
+{
+    if (!this->line_conflicts_dirty) {
+        return;
+    }
+
+    for (uint8_t line = 0; line < this->board_size; line++) {
+        this->line_conflicts[0][line] = LinearConflict::count_conflicts(this->state, this->tables, line, true);
+        this->line_conflicts[1][line] = LinearConflict::count_conflicts(this->state, this->tables, line, false);
+    }
+    this->line_conflicts_dirty = false;
+}
+
+/**
+ * Follow the parent's linear conflicts through the move that made this board.
+ * A vertical move takes a tile from one row to the next without changing the order of any column,
+ * so only those two rows are recounted, and likewise for columns on a horizontal move.
+ * Nothing is done if the parent's conflicts were never counted.
+ *
+ * @param parent    The board the move was applied to.
+ * @param move      The move.
+ */
+void Board::follow_linear_conflicts(Board &parent, Moves move)
+{
+    if (parent.line_conflicts_dirty) {
+        return;
+    }
+
+    std::copy(&parent.line_conflicts[0][0], &parent.line_conflicts[0][0] + 2 * MAX_BOARD_SIZE, &this->line_conflicts[0][0]);
+
+    bool columns = move == Moves::LEFT || move == Moves::RIGHT;
+    const uint8_t *lines = columns ? this->tables->x : this->tables->y;
+    for (uint8_t cell : {parent.zero_position, this->zero_position}) {
+        this->line_conflicts[columns][lines[cell]] = LinearConflict::count_conflicts(this->state, this->tables, lines[cell], !columns);
+    }
+    this->line_conflicts_dirty = false;
+}
+
+/**
+ * @return True if pattern databases for this board size are attached.
+ */
+bool Board::has_pattern_database()
+{
+    return this->pattern_database != NULL && this->pattern_database->get_board_size() == this->board_size;
+}
+
+/**
+ * Compute the pattern database indices of this board and start fetching their entries.
+ * Calling this on a batch of boards before evaluating them overlaps the memory accesses.
+ */
+void Board::prefetch_heuristic()
+{
+    if (!this->heuristic_dirty || this->pattern_database == NULL || this->pattern_database->get_board_size() != this->board_size) {
+        return;
     }
 
-    group_tiles = {1,5,6,9,10,13};
-    search = this->pattern_database->find(this->get_partial_state_hash(std::shared_ptr< std::set<uint8_t> >(new std::set<uint8_t>(group_tiles))));
+    this->update_pattern_db_indices();
+    this->pattern_database->prefetch(this->pattern_db_indices);
+}
+
+/**
+ * Compute and cache the pattern database table indices of this board.
+ */
+void Board::update_pattern_db_indices()
+{
+    if (!this->pattern_db_indices_dirty) {
+        return;
+    }
 
-    if (search != this->pattern_database->end()) {
-        pattern_database_heuristic += search->second;
+    //Invert the state to find the cell holding each tile.
+    uint8_t positions[MAX_CELLS];
+    for (uint8_t i = 0; i < this->cell_count; i++) {
+        positions[this->state[i]] = i;
     }
 
-    group_tiles = {7,8,11,12,14,15};
-    search = this->pattern_database->find(this->get_partial_state_hash(std::shared_ptr< std::set<uint8_t> >(new std::set<uint8_t>(group_tiles))));
+    this->pattern_database->get_indices(positions, this->pattern_db_indices);
+    this->pattern_db_indices_dirty = false;
+}
+
+/**
+ * @return The perimeter database given during construction, NULL if none.
+ */
+PerimeterDatabase *Board::get_perimeter_database()
+{
+    return this->perimeter_database.get();
+}
 
-    if (search != this->pattern_database->end()) {
-        pattern_database_heuristic += search->second;
+/**
+ * Look up the exact distance to the goal in the perimeter database.
+ *
+ * @param distance Set to the distance if this state is within the perimeter.
+ *
+ * @return True if this state is within the perimeter.
+ */
+bool Board::get_perimeter_distance(uint8_t &distance)
+{
+    if (this->perimeter_database == NULL) {
+        return false;
     }
 
-    return pattern_database_heuristic;
+    return this->perimeter_database->lookup(this->get_state_hash(), distance);
 }
@@ -10,9 +10,19 @@
 #include <cstdint>
 
 #include "taquinsolve.hh"
+#include "BoardTables.hh"
+#include "MoveSequence.hh"
+#include "PatternDatabase.hh"
+#include "SearchArena.hh"
 
 namespace TaquinSolve
 {
+    class PerimeterDatabase;
+    class Board;
+
+    //Boards generated during a search, held in the search arena
+    typedef std::vector<std::shared_ptr<Board>, ArenaAllocator<std::shared_ptr<Board>>> BoardList;
+
     /**
      * Represents a board state with operations that affect it or describe it.
      */
@@ -20,10 +30,11 @@ namespace TaquinSolve
     {
         public:
             Board(
-                std::vector<uint8_t> state,
+                const std::vector<uint8_t> &state,
                 uint8_t board_size,
-                std::shared_ptr< std::map<uint64_t, uint8_t> > pattern_database = NULL,
-                std::queue<Moves> move_history = std::queue<Moves>()
+                std::shared_ptr<PatternDatabase> pattern_database = NULL,
+                std::shared_ptr<PerimeterDatabase> perimeter_database = NULL,
+                MoveSequence move_history = MoveSequence()
             );
             Board(const Board&) = delete;
             ~Board() = default;
@@ -31,7 +42,8 @@ namespace TaquinSolve
 
             //Modify
             virtual Board *perform_move(Moves move, std::shared_ptr<std::set<uint8_t> > group_tiles = NULL);
-            void replace_move_history(std::queue<Moves> move_history);
+            std::shared_ptr<Board> perform_move_in_arena(Moves move, std::shared_ptr<std::set<uint8_t> > group_tiles = NULL);
+            void replace_move_history(const MoveSequence &move_history);
 
             //Validate
             void validate_state();
@@ -39,21 +51,66 @@ namespace TaquinSolve
 
             //Read
             std::vector<Moves> get_available_moves();
-            std::queue<Moves> get_move_history();
+            uint8_t get_available_move_count();
+            Moves get_available_move(uint8_t index);
+            const MoveSequence &get_move_history();
+            bool has_move_history();
             std::vector<uint8_t> get_state();
-            uint64_t get_state_hash();
-            uint64_t get_partial_state_hash(std::shared_ptr<std::set<uint8_t> > group_tiles);
+            uint8_t get_board_size();
+            const uint8_t *get_cells();
+            const BoardTables *get_tables();
+            StateHash get_state_hash();
+            StateHash get_partial_state_hash(std::shared_ptr<std::set<uint8_t> > group_tiles);
+            StateHash get_partial_state_hash(uint32_t group_mask);
             uint8_t get_cost();
             uint8_t get_heuristic();
+            bool has_heuristic();
+            void set_heuristic(uint8_t heuristic);
             uint8_t get_pattern_db_heuristic();
+            uint8_t get_walking_distance();
+            uint8_t get_linear_conflicts();
+            uint8_t get_line_conflicts(bool columns, uint8_t line);
+            bool has_pattern_database();
+            void prefetch_heuristic();
+            PerimeterDatabase *get_perimeter_database();
+            bool get_perimeter_distance(uint8_t &distance);
+
+            static void unpack_state_hash(StateHash state_hash, uint8_t cell_count, uint8_t *cells);
 
         protected:
-            //An int vector representation of the state
-            std::vector<uint8_t> state;
+            friend class ArenaAllocator<Board>;
+
+            Board(
+                const uint8_t *state,
+                const BoardTables *tables,
+                uint8_t zero_position,
+                std::shared_ptr<PatternDatabase> pattern_database,
+                std::shared_ptr<PerimeterDatabase> perimeter_database,
+                const MoveSequence &move_history
+            );
+
+            void update_pattern_db_indices();
+            void follow_parent(Board &parent, Moves move);
+            void follow_walking_distance(Board &parent, Moves move);
+            void follow_linear_conflicts(Board &parent, Moves move);
+            void update_line_conflicts();
+            uint8_t move_state(Moves move, std::shared_ptr<std::set<uint8_t> > group_tiles, uint8_t *new_state, MoveSequence &new_history, bool track_history = true);
+
+            //The tiles in row major order, held inline so a board is a single allocation
+            uint8_t state[MAX_CELLS] = {0};
+
+            //The number of tiles held, at most MAX_CELLS
+            uint8_t cell_count = 0;
+
+            //The number of tiles given, which only differs from board_size^2 before validation
+            uint16_t given_cell_count = 0;
 
             //The size of the board
             uint8_t board_size = 0;
 
+            //Precomputed geometry for this board size, NULL if the size is unsupported
+            const BoardTables *tables = NULL;
+
             //The current position of the empty tile
             //(represented by 0)
             uint8_t zero_position = 0;
@@ -64,16 +121,40 @@ namespace TaquinSolve
             //Heuristic dirty flag
             bool heuristic_dirty = true;
 
+            //Cached pattern database table indices
+            uint32_t pattern_db_indices[MAX_PATTERN_GROUPS];
+
+            //Pattern database indices dirty flag
+            bool pattern_db_indices_dirty = true;
+
+            //Cached walking distance table states of the rows and columns
+            uint16_t walking_distance_states[2];
+
+            //Walking distance states dirty flag
+            bool walking_distance_dirty = true;
+
+            //Cached number of tiles to remove from each row and column to resolve its linear conflicts
+            uint8_t line_conflicts[2][MAX_BOARD_SIZE];
+
+            //Linear conflicts dirty flag
+            bool line_conflicts_dirty = true;
+
             //Cached hash value
-            uint64_t state_hash = 0;
+            StateHash state_hash = 0;
 
             //Hash dirty flag
             bool state_hash_dirty = true;
 
-            //A queue structure that contains all the moves taken to get to this board state
-            std::queue<Moves> move_history;
+            //All the moves taken to get to this board state
+            MoveSequence move_history;
+
+            //Cleared once perform_move() takes the board past the history capacity
+            bool track_history = true;
 
             //A pointer to the pattern database given during construction.
-            std::shared_ptr< std::map<uint64_t, uint8_t> > pattern_database;
+            std::shared_ptr<PatternDatabase> pattern_database;
+
+            //A pointer to the perimeter database given during construction.
+            std::shared_ptr<PerimeterDatabase> perimeter_database;
     };
 }
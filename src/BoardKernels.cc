@@ -0,0 +1,215 @@
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TAQUIN_X86 1
+#include <immintrin.h>
+#endif
+
+#include "BoardKernels.hh"
+
+using namespace TaquinSolve;
+
+/**
+ * Find the best instruction set the running CPU supports.
+ *
+ * @return The instruction set the dispatching kernels use.
+ */
+static InstructionSet detect_instruction_set()
+{
+#ifdef TAQUIN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.1")) {
+        return InstructionSet::SSE41;
+    }
+#endif
+    return InstructionSet::SCALAR;
+}
+
+/**
+ * @return The instruction set chosen for this CPU.
+ */
+InstructionSet BoardKernels::get_instruction_set()
+{
+    static const InstructionSet instruction_set = detect_instruction_set();
+    return instruction_set;
+}
+
+/**
+ * Check whether the running CPU can execute the given kernels.
+ *
+ * @param instruction_set The instruction set to check.
+ *
+ * @return True if the kernels can be called.
+ */
+bool BoardKernels::check_supported(InstructionSet instruction_set)
+{
+    return instruction_set == InstructionSet::SCALAR || instruction_set == BoardKernels::get_instruction_set();
+}
+
+/**
+ * Convert a set of tiles into a bitmask with bit t set for each tile t.
+ *
+ * @param group_tiles The set of tiles.
+ *
+ * @return The bitmask.
+ */
+uint32_t BoardKernels::get_group_mask(const std::set<uint8_t> &group_tiles)
+{
+    uint32_t mask = 0;
+    for (uint8_t tile : group_tiles) {
+        mask |= 1 << tile;
+    }
+    return mask;
+}
+
+/**
+ * Pack the board into get_state_hash_bits() per cell, replacing tiles outside the group with a common unused tile.
+ *
+ * @param cells         The board state, one tile per cell.
+ * @param cell_count    The number of cells, at most MAX_CELLS.
+ * @param group_mask    Bit t is set if tile t is in the group.
+ *
+ * @return The partial state hash.
+ */
+StateHash BoardKernels::partial_state_hash(const uint8_t *cells, uint8_t cell_count, uint32_t group_mask)
+{
+#ifdef TAQUIN_X86
+    if (cell_count <= 16 && BoardKernels::get_instruction_set() == InstructionSet::SSE41) {
+        return BoardKernels::partial_state_hash_sse41(cells, cell_count, group_mask);
+    }
+#endif
+    return BoardKernels::partial_state_hash_scalar(cells, cell_count, group_mask);
+}
+
+/**
+ * Sum the Manhattan distance of each tile from its goal cell.
+ *
+ * @param cells     The board state, one tile per cell.
+ * @param tables    The geometry tables for the board size.
+ *
+ * @return The Manhattan distance.
+ */
+uint8_t BoardKernels::manhattan_distance(const uint8_t *cells, const BoardTables *tables)
+{
+#ifdef TAQUIN_X86
+    if (tables->cell_count <= 16 && BoardKernels::get_instruction_set() == InstructionSet::SSE41) {
+        return BoardKernels::manhattan_distance_sse41(cells, tables);
+    }
+#endif
+    return BoardKernels::manhattan_distance_scalar(cells, tables);
+}
+
+StateHash BoardKernels::partial_state_hash_scalar(const uint8_t *cells, uint8_t cell_count, uint32_t group_mask)
+{
+    //The lowest tile not in the group marks the tiles outside it.
+    uint8_t unused_tile = __builtin_ctz(~group_mask);
+    uint8_t bits = get_state_hash_bits(cell_count);
+
+    StateHash state_representation = 0;
+    for (uint8_t i = 0; i < cell_count; i++) {
+        uint8_t tile = (group_mask >> cells[i]) & 1 ? cells[i] : unused_tile;
+        state_representation |= ((StateHash)tile) << (i * bits);
+    }
+    return state_representation;
+}
+
+uint8_t BoardKernels::manhattan_distance_scalar(const uint8_t *cells, const BoardTables *tables)
+{
+    uint8_t manhattan_sum = 0;
+    for (uint8_t i = 0; i < tables->cell_count; i++) {
+        manhattan_sum += tables->manhattan[cells[i]][i];
+    }
+    return manhattan_sum;
+}
+
+#ifdef TAQUIN_X86
+
+/**
+ * Load the board into a register, zeroing the lanes past the last cell.
+ */
+__attribute__((target("sse4.1")))
+static inline __m128i load_cells(const uint8_t *cells, uint8_t cell_count, __m128i &lane_mask)
+{
+    alignas(16) uint8_t padded[16] = {0};
+    memcpy(padded, cells, cell_count);
+
+    const __m128i lane_index = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    lane_mask = _mm_cmplt_epi8(lane_index, _mm_set1_epi8(cell_count));
+
+    return _mm_load_si128((const __m128i *)padded);
+}
+
+/**
+ * Expand a 16 bit tile mask into a byte lookup table with 0xFF for each tile in the mask.
+ */
+__attribute__((target("sse4.1")))
+static inline __m128i expand_mask(uint16_t mask)
+{
+    const __m128i bit_select = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    __m128i bytes = _mm_setr_epi8(
+        mask & 0xFF, mask & 0xFF, mask & 0xFF, mask & 0xFF, mask & 0xFF, mask & 0xFF, mask & 0xFF, mask & 0xFF,
+        mask >> 8, mask >> 8, mask >> 8, mask >> 8, mask >> 8, mask >> 8, mask >> 8, mask >> 8
+    );
+    return _mm_cmpeq_epi8(_mm_and_si128(bytes, bit_select), bit_select);
+}
+
+__attribute__((target("sse4.1")))
+uint64_t BoardKernels::partial_state_hash_sse41(const uint8_t *cells, uint8_t cell_count, uint32_t group_mask)
+{
+    __m128i lane_mask;
+    __m128i state = load_cells(cells, cell_count, lane_mask);
+
+    //Look up group membership of each tile and replace the others with the unused tile.
+    __m128i in_group = _mm_shuffle_epi8(expand_mask(group_mask), state);
+    __m128i unused_tile = _mm_set1_epi8(__builtin_ctz(~group_mask));
+    __m128i masked = _mm_and_si128(_mm_blendv_epi8(unused_tile, state, in_group), lane_mask);
+
+    //Combine each pair of cells into a byte (low + 16 * high) and narrow to 8 bytes.
+    __m128i pairs = _mm_maddubs_epi16(masked, _mm_set1_epi16(0x1001));
+    __m128i packed = _mm_packus_epi16(pairs, _mm_setzero_si128());
+
+    uint64_t state_representation;
+    _mm_storel_epi64((__m128i *)&state_representation, packed);
+    return state_representation;
+}
+
+__attribute__((target("sse4.1")))
+uint8_t BoardKernels::manhattan_distance_sse41(const uint8_t *cells, const BoardTables *tables)
+{
+    __m128i lane_mask;
+    __m128i state = load_cells(cells, tables->cell_count, lane_mask);
+
+    //Gather the goal coordinates of each tile.
+    __m128i goal_x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)tables->goal_x), state);
+    __m128i goal_y = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)tables->goal_y), state);
+
+    __m128i cell_x = _mm_loadu_si128((const __m128i *)tables->x);
+    __m128i cell_y = _mm_loadu_si128((const __m128i *)tables->y);
+
+    __m128i distance = _mm_add_epi8(
+        _mm_abs_epi8(_mm_sub_epi8(cell_x, goal_x)),
+        _mm_abs_epi8(_mm_sub_epi8(cell_y, goal_y))
+    );
+
+    //The empty tile and the lanes past the board add nothing.
+    __m128i counted = _mm_andnot_si128(_mm_cmpeq_epi8(state, _mm_setzero_si128()), lane_mask);
+    distance = _mm_and_si128(distance, counted);
+
+    //Horizontal sum of the bytes.
+    __m128i sums = _mm_sad_epu8(distance, _mm_setzero_si128());
+    return _mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4);
+}
+
+#else
+
+uint64_t BoardKernels::partial_state_hash_sse41(const uint8_t *cells, uint8_t cell_count, uint32_t group_mask)
+{
+    return BoardKernels::partial_state_hash_scalar(cells, cell_count, group_mask);
+}
+
+uint8_t BoardKernels::manhattan_distance_sse41(const uint8_t *cells, const BoardTables *tables)
+{
+    return BoardKernels::manhattan_distance_scalar(cells, tables);
+}
+
+#endif
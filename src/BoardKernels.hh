@@ -0,0 +1,42 @@
+#pragma once
+
+#include <set>
+#include <cstdint>
+
+#include "BoardTables.hh"
+
+namespace TaquinSolve
+{
+    /**
+     * The instruction sets the board kernels are implemented with.
+     */
+    enum class InstructionSet
+    {
+        SCALAR,
+        SSE41
+    };
+
+    /**
+     * Hot per-node computations over a board state of up to MAX_CELLS tiles.
+     * The SIMD version is chosen once at runtime from the CPU features, with a scalar fallback.
+     * The SIMD versions hold a board in one 16 byte register, larger boards always take the scalar path.
+     */
+    class BoardKernels
+    {
+        public:
+            static StateHash partial_state_hash(const uint8_t *cells, uint8_t cell_count, uint32_t group_mask);
+            static uint8_t manhattan_distance(const uint8_t *cells, const BoardTables *tables);
+
+            static InstructionSet get_instruction_set();
+            static bool check_supported(InstructionSet instruction_set);
+            static uint32_t get_group_mask(const std::set<uint8_t> &group_tiles);
+
+            //Scalar implementations
+            static StateHash partial_state_hash_scalar(const uint8_t *cells, uint8_t cell_count, uint32_t group_mask);
+            static uint8_t manhattan_distance_scalar(const uint8_t *cells, const BoardTables *tables);
+
+            //SSE4.1 implementations, only callable when check_supported(InstructionSet::SSE41) and for up to 16 cells
+            static uint64_t partial_state_hash_sse41(const uint8_t *cells, uint8_t cell_count, uint32_t group_mask);
+            static uint8_t manhattan_distance_sse41(const uint8_t *cells, const BoardTables *tables);
+    };
+}
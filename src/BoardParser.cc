@@ -0,0 +1,255 @@
+#include <fstream>
+#include <cstring>
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "BoardParser.hh"
+#include "BoardTables.hh"
+
+using namespace TaquinSolve;
+
+/**
+ * Constructor.
+ *
+ * @param board_size        The width/height of the boards to read (2-5).
+ * @param separator         The character between tiles.
+ * @param check_solvable    Reject boards that cannot reach the standard goal.
+ */
+BoardParser::BoardParser(uint8_t board_size, char separator, bool check_solvable)
+    : board_size(board_size), cell_count(board_size * board_size), separator(separator), check_solvable(check_solvable)
+{
+    if (board_size < 2 || board_size > MAX_BOARD_SIZE) {
+        throw std::string("Board size invalid.\nThis library only supports board sizes 2-5.");
+    }
+}
+
+/**
+ * Parse every line of the given text, appending a row to the batch for each non-empty one.
+ *
+ * @param text  The input, one board per line.
+ * @param batch The batch to append to.
+ *
+ * @return The number of rows appended.
+ */
+size_t BoardParser::parse(std::string_view text, BoardBatch &batch)
+{
+    batch.board_size = this->board_size;
+
+    size_t rows = 0;
+    uint32_t line_number = 0;
+    size_t position = 0;
+    while (position < text.size()) {
+        size_t end = text.find('\n', position);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+
+        std::string_view line = text.substr(position, end - position);
+        position = end + 1;
+        line_number++;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.find_first_not_of(" \t") == std::string_view::npos) {
+            continue;
+        }
+
+        size_t offset = batch.tiles.size();
+        batch.tiles.resize(offset + this->cell_count);
+
+        ParseError error = this->parse_line(line, batch.tiles.data() + offset);
+        if (error == ParseError::NONE) {
+            error = BoardParser::validate(batch.tiles.data() + offset, this->board_size, this->check_solvable);
+        }
+        if (error != ParseError::NONE) {
+            memset(batch.tiles.data() + offset, 0, this->cell_count);
+        }
+
+        batch.errors.push_back(error);
+        batch.lines.push_back(line_number);
+        rows++;
+    }
+
+    return rows;
+}
+
+/**
+ * Parse every line of the given file.
+ * The file is mapped into memory rather than read where possible.
+ *
+ * @param path  The file to read.
+ * @param batch The batch to append to.
+ *
+ * @return The number of rows appended.
+ */
+size_t BoardParser::parse_file(std::string path, BoardBatch &batch)
+{
+#ifdef HAVE_SYS_MMAN_H
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::string("Unable to open board file: ") + path;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        throw std::string("Unable to open board file: ") + path;
+    }
+
+    if (file_stat.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+
+    void *data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        throw std::string("Unable to map board file: ") + path;
+    }
+    madvise(data, file_stat.st_size, MADV_SEQUENTIAL);
+
+    size_t rows = this->parse(std::string_view((const char *) data, file_stat.st_size), batch);
+    munmap(data, file_stat.st_size);
+
+    return rows;
+#else
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::string("Unable to open board file: ") + path;
+    }
+
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return this->parse(text, batch);
+#endif
+}
+
+/**
+ * Read the tiles of one line.
+ *
+ * @param line  The line, without its line ending.
+ * @param tiles Filled with cell_count tiles.
+ *
+ * @return The first problem found, if any.
+ */
+ParseError BoardParser::parse_line(std::string_view line, uint8_t *tiles)
+{
+    uint8_t count = 0;
+    uint32_t value = 0;
+    bool in_token = false;
+
+    for (size_t i = 0; i <= line.size(); i++) {
+        char c = i < line.size() ? line[i] : this->separator;
+
+        if (c >= '0' && c <= '9') {
+            //Anything past two digits is out of range anyway, so saturate rather than overflow
+            value = value < 256 ? value * 10 + (c - '0') : value;
+            in_token = true;
+        } else if (c == this->separator) {
+            if (!in_token) {
+                //Tolerate repeated space separators and a trailing separator
+                if (this->separator == ' ' || i >= line.size() - 1) {
+                    continue;
+                }
+                return ParseError::INVALID_TOKEN;
+            }
+            if (count == this->cell_count) {
+                return ParseError::WRONG_TILE_COUNT;
+            }
+            if (value >= this->cell_count) {
+                return ParseError::TILE_OUT_OF_RANGE;
+            }
+            tiles[count++] = value;
+            value = 0;
+            in_token = false;
+        } else if ((c == ' ' || c == '\t') && !in_token) {
+            continue;
+        } else {
+            return ParseError::INVALID_TOKEN;
+        }
+    }
+
+    if (count != this->cell_count) {
+        return ParseError::WRONG_TILE_COUNT;
+    }
+
+    return ParseError::NONE;
+}
+
+/**
+ * Check a board is a permutation of its tiles and, optionally, that it is solvable.
+ * A single pass tracks the tiles seen in a bitmask, which both finds duplicates and
+ * counts the inversions each tile makes with the larger tiles before it.
+ *
+ * @param tiles             The board state, board_size^2 tiles.
+ * @param board_size        The width/height of the board (2-5).
+ * @param check_solvable    Also check the board can reach the standard goal.
+ *
+ * @return The first problem found, if any.
+ */
+ParseError BoardParser::validate(const uint8_t *tiles, uint8_t board_size, bool check_solvable)
+{
+    uint8_t cell_count = board_size * board_size;
+    uint32_t seen = 0;
+    uint32_t inversion_count = 0;
+    uint8_t zero_position = 0;
+
+    for (uint8_t i = 0; i < cell_count; i++) {
+        uint8_t tile = tiles[i];
+        if (tile >= cell_count) {
+            return ParseError::TILE_OUT_OF_RANGE;
+        }
+
+        uint32_t bit = 1u << tile;
+        if (seen & bit) {
+            return ParseError::DUPLICATE_TILE;
+        }
+
+        if (tile == 0) {
+            zero_position = i;
+        } else {
+            inversion_count += __builtin_popcount(seen >> (tile + 1));
+        }
+        seen |= bit;
+    }
+
+    if (!check_solvable) {
+        return ParseError::NONE;
+    }
+
+    bool solvable;
+    if (board_size % 2 == 0 && (zero_position / board_size) % 2 == 0) {
+        solvable = inversion_count % 2 == 1;
+    } else {
+        solvable = inversion_count % 2 == 0;
+    }
+
+    return solvable ? ParseError::NONE : ParseError::UNSOLVABLE;
+}
+
+/**
+ * @return A human readable description of the given error.
+ */
+std::string BoardParser::describe(ParseError error)
+{
+    switch (error) {
+        case ParseError::NONE:
+            return "Valid";
+        case ParseError::INVALID_TOKEN:
+            return "Invalid token";
+        case ParseError::WRONG_TILE_COUNT:
+            return "Wrong number of tiles";
+        case ParseError::TILE_OUT_OF_RANGE:
+            return "Tile out of range";
+        case ParseError::DUPLICATE_TILE:
+            return "Duplicate tile";
+        case ParseError::UNSOLVABLE:
+        default:
+            return "Board state is unsolvable";
+    }
+}
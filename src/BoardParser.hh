@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace TaquinSolve
+{
+    /**
+     * Why a row of input was rejected.
+     */
+    enum class ParseError : uint8_t
+    {
+        NONE,
+        INVALID_TOKEN,
+        WRONG_TILE_COUNT,
+        TILE_OUT_OF_RANGE,
+        DUPLICATE_TILE,
+        UNSOLVABLE
+    };
+
+    /**
+     * The boards read from an input, one row per non-empty line.
+     * Rejected rows are kept, zero filled, so row indices always line up with the input.
+     */
+    struct BoardBatch
+    {
+        uint8_t board_size = 0;
+
+        //The tiles of every row one after another, board_size^2 per row
+        std::vector<uint8_t> tiles;
+
+        //Why each row was rejected, ParseError::NONE if it is valid
+        std::vector<ParseError> errors;
+
+        //The line of the input each row came from, counting from 1
+        std::vector<uint32_t> lines;
+    };
+
+    /**
+     * Reads and validates boards in bulk, without exceptions or per board allocations.
+     * Each line holds one board with its tiles separated by the given separator.
+     */
+    class BoardParser
+    {
+        public:
+            BoardParser(uint8_t board_size, char separator = ' ', bool check_solvable = true);
+
+            size_t parse(std::string_view text, BoardBatch &batch);
+            size_t parse_file(std::string path, BoardBatch &batch);
+
+            static ParseError validate(const uint8_t *tiles, uint8_t board_size, bool check_solvable = true);
+            static std::string describe(ParseError error);
+
+        protected:
+            uint8_t board_size;
+            uint8_t cell_count;
+            char separator;
+            bool check_solvable;
+
+            ParseError parse_line(std::string_view line, uint8_t *tiles);
+    };
+}
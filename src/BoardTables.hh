@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "taquinsolve.hh"
+
+namespace TaquinSolve
+{
+    //The number of cells on the largest supported board.
+    const uint8_t MAX_CELLS = 25;
+
+    //The width/height of the largest supported board.
+    const uint8_t MAX_BOARD_SIZE = 5;
+
+    //A board state packed into one integer, wide enough for every cell of the largest board.
+    __extension__ typedef unsigned __int128 StateHash;
+
+    /**
+     * The bits each cell takes in a StateHash.
+     * Boards up to 4x4 keep a nibble per cell, so their hashes still fit in 64 bits.
+     *
+     * @param cell_count The number of cells on the board.
+     *
+     * @return The bits per cell.
+     */
+    constexpr uint8_t get_state_hash_bits(uint8_t cell_count)
+    {
+        return cell_count > 16 ? 5 : 4;
+    }
+
+    /**
+     * Hashes a StateHash for unordered containers, the standard library has no hash for 128 bit integers.
+     */
+    struct StateHashHasher
+    {
+        size_t operator()(StateHash state_hash) const
+        {
+            return (uint64_t) state_hash ^ ((uint64_t)(state_hash >> 64) * 0x9E3779B97F4A7C15ull);
+        }
+    };
+
+    /**
+     * Precomputed geometry of a board of one size.
+     * Lets the search look up coordinates, distances and moves instead of dividing by the board size.
+     */
+    struct BoardTables
+    {
+        //The width/height of the board
+        uint8_t board_size;
+
+        //The number of cells on the board
+        uint8_t cell_count;
+
+        //Cartesian coordinates of each cell
+        uint8_t x[MAX_CELLS];
+        uint8_t y[MAX_CELLS];
+
+        //Cartesian coordinates of the goal cell of each tile, 0 for the empty tile
+        uint8_t goal_x[MAX_CELLS];
+        uint8_t goal_y[MAX_CELLS];
+
+        //Manhattan distance of each tile from each cell, indexed [tile][cell]
+        uint8_t manhattan[MAX_CELLS][MAX_CELLS];
+
+        //The moves available when the empty tile is in each cell
+        uint8_t move_count[MAX_CELLS];
+        Moves moves[MAX_CELLS][4];
+
+        //The cell the empty tile moves to from each cell, indexed [cell][move]
+        uint8_t neighbours[MAX_CELLS][4];
+    };
+
+    /**
+     * Build the tables for an NxN board at compile time.
+     */
+    template <uint8_t N>
+    constexpr BoardTables make_board_tables()
+    {
+        static_assert(N * N <= MAX_CELLS, "Board size exceeds MAX_CELLS");
+
+        BoardTables tables{};
+        tables.board_size = N;
+        tables.cell_count = N * N;
+
+        for (uint8_t cell = 0; cell < N * N; cell++) {
+            tables.x[cell] = cell % N;
+            tables.y[cell] = cell / N;
+        }
+
+        //Tile t belongs in cell t-1, the empty tile has no distance.
+        for (uint8_t tile = 1; tile < N * N; tile++) {
+            tables.goal_x[tile] = tables.x[tile - 1];
+            tables.goal_y[tile] = tables.y[tile - 1];
+
+            for (uint8_t cell = 0; cell < N * N; cell++) {
+                uint8_t goal = tile - 1;
+                uint8_t dx = tables.x[cell] > tables.x[goal] ? tables.x[cell] - tables.x[goal] : tables.x[goal] - tables.x[cell];
+                uint8_t dy = tables.y[cell] > tables.y[goal] ? tables.y[cell] - tables.y[goal] : tables.y[goal] - tables.y[cell];
+                tables.manhattan[tile][cell] = dx + dy;
+            }
+        }
+
+        //Same order as the original boundary checks: left, right, up, down.
+        for (uint8_t cell = 0; cell < N * N; cell++) {
+            uint8_t count = 0;
+            if (tables.x[cell] > 0) {
+                tables.moves[cell][count++] = Moves::LEFT;
+            }
+            if (tables.x[cell] < N - 1) {
+                tables.moves[cell][count++] = Moves::RIGHT;
+            }
+            if (tables.y[cell] > 0) {
+                tables.moves[cell][count++] = Moves::UP;
+            }
+            if (tables.y[cell] < N - 1) {
+                tables.moves[cell][count++] = Moves::DOWN;
+            }
+            tables.move_count[cell] = count;
+
+            tables.neighbours[cell][Moves::UP] = cell - N;
+            tables.neighbours[cell][Moves::DOWN] = cell + N;
+            tables.neighbours[cell][Moves::LEFT] = cell - 1;
+            tables.neighbours[cell][Moves::RIGHT] = cell + 1;
+        }
+
+        return tables;
+    }
+
+    /**
+     * Compile-time instance of the tables for an NxN board.
+     */
+    template <uint8_t N>
+    struct BoardGeometry
+    {
+        static constexpr BoardTables tables = make_board_tables<N>();
+    };
+
+    /**
+     * Select the tables for the given board size.
+     * This is the only point where the board size is branched on.
+     *
+     * @param board_size The width/height of the board.
+     *
+     * @return The tables, or NULL if the board size is unsupported.
+     */
+    inline const BoardTables *get_board_tables(uint8_t board_size)
+    {
+        switch (board_size) {
+            case 2:
+                return &BoardGeometry<2>::tables;
+            case 3:
+                return &BoardGeometry<3>::tables;
+            case 4:
+                return &BoardGeometry<4>::tables;
+            case 5:
+                return &BoardGeometry<5>::tables;
+            default:
+                return NULL;
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#include "EmbeddedDatabases.hh"
+
+using namespace TaquinSolve;
+
+#ifdef TAQUINSOLVE_EMBEDDED_DATABASES
+
+/**
+ * Assemble a database file from the build directory into the library's read-only data.
+ * The header is 10 bytes plus one per tile, the padding before it puts the table on a cache line boundary.
+ */
+#define EMBED_DATABASE(symbol, file_name, tile_count) \
+    __asm__( \
+        ".pushsection .rodata\n" \
+        ".balign 64\n" \
+        ".skip 64 - (10 + " #tile_count ")\n" \
+        ".globl " #symbol "_start\n" \
+        ".hidden " #symbol "_start\n" \
+        #symbol "_start:\n" \
+        ".incbin \"" TAQUINSOLVE_EMBEDDED_DATABASES "/" file_name "\"\n" \
+        ".globl " #symbol "_end\n" \
+        ".hidden " #symbol "_end\n" \
+        #symbol "_end:\n" \
+        ".popsection\n" \
+    ); \
+    extern "C" __attribute__((visibility("hidden"))) const uint8_t symbol##_start[]; \
+    extern "C" __attribute__((visibility("hidden"))) const uint8_t symbol##_end[];
+
+EMBED_DATABASE(taquinsolve_database_234, "234.db.bin", 3)
+EMBED_DATABASE(taquinsolve_database_15691013, "15691013.db.bin", 6)
+EMBED_DATABASE(taquinsolve_database_7811121415, "7811121415.db.bin", 6)
+
+static const struct {
+    const char *file_name;
+    const uint8_t *start;
+    const uint8_t *end;
+} embedded_databases[] = {
+    {"234.db.bin", taquinsolve_database_234_start, taquinsolve_database_234_end},
+    {"15691013.db.bin", taquinsolve_database_15691013_start, taquinsolve_database_15691013_end},
+    {"7811121415.db.bin", taquinsolve_database_7811121415_start, taquinsolve_database_7811121415_end}
+};
+
+#endif
+
+/**
+ * Find a database linked into the library.
+ *
+ * @param file_name The name of the database file, as in STANDARD_DATABASES.
+ * @param data      Set to the contents of the file.
+ * @param size      Set to the size of the file.
+ *
+ * @return True if the database is linked in.
+ */
+bool EmbeddedDatabases::find(std::string file_name, const uint8_t *&data, size_t &size)
+{
+#ifdef TAQUINSOLVE_EMBEDDED_DATABASES
+    for (auto &database : embedded_databases) {
+        if (file_name == database.file_name) {
+            data = database.start;
+            size = database.end - database.start;
+            return true;
+        }
+    }
+#else
+    (void) file_name;
+    (void) data;
+    (void) size;
+#endif
+
+    return false;
+}
+
+/**
+ * @return True if the library was built with the standard databases linked in.
+ */
+bool EmbeddedDatabases::is_available()
+{
+#ifdef TAQUINSOLVE_EMBEDDED_DATABASES
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace TaquinSolve
+{
+    /**
+     * The standard pattern databases linked into the library as dense files,
+     * when it is configured with --enable-embedded-databases.
+     */
+    class EmbeddedDatabases
+    {
+        public:
+            static bool find(std::string file_name, const uint8_t *&data, size_t &size);
+            static bool is_available();
+    };
+}
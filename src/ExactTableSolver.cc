@@ -0,0 +1,213 @@
+#include <string>
+#include <queue>
+#include <chrono>
+#include <algorithm>
+
+#include "ExactTableSolver.hh"
+#include "GoalMapping.hh"
+
+using namespace TaquinSolve;
+
+/**
+ * Constructor.
+ *
+ * @param options Tunable parameters for the solver.
+ */
+ExactTableSolver::ExactTableSolver(SolverOptions options) : Solver(options)
+{
+}
+
+/**
+ * Solve the board state given to this object.
+ *
+ * @param board         The board state.
+ * @param board_size    The width/height of the board, at most MAX_BOARD_SIZE.
+ * @param solution      Filled with the moves taken to reach the solution.
+ * @param stats         If given, filled with a description of the work done.
+ */
+void ExactTableSolver::solve_into(std::vector<uint8_t> board, uint8_t board_size, MoveSequence &solution, SolveStats *stats)
+{
+    this->stats = SolveStats();
+    this->stats.algorithm = Algorithm::EXACT_TABLE;
+
+    //Other goals are solved as the equivalent puzzle against the standard goal.
+    std::shared_ptr<GoalMapping> goal_mapping;
+    if (!this->options.goal_board.empty()) {
+        goal_mapping = std::shared_ptr<GoalMapping>(new GoalMapping(this->options.goal_board, board_size));
+        board = goal_mapping->map_board(board);
+    }
+
+    std::chrono::steady_clock::time_point phase_start = std::chrono::steady_clock::now();
+    Board initial_board(board, board_size);
+    initial_board.validate_state();
+    this->stats.validation_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - phase_start).count();
+
+    if (board_size > MAX_BOARD_SIZE) {
+        throw std::string("Exact tables only support board sizes 2-") + std::to_string(MAX_BOARD_SIZE) + ".";
+    }
+
+    phase_start = std::chrono::steady_clock::now();
+    const std::vector<uint8_t> &table = ExactTableSolver::get_table(board_size);
+    this->stats.database_load_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - phase_start).count();
+
+    phase_start = std::chrono::steady_clock::now();
+    const BoardTables *tables = initial_board.get_tables();
+    uint8_t cells[MAX_CELLS];
+    std::copy(initial_board.get_cells(), initial_board.get_cells() + tables->cell_count, cells);
+    uint8_t zero_position = std::find(cells, cells + tables->cell_count, 0) - cells;
+
+    uint8_t distance = table[ExactTableSolver::rank(cells, tables->cell_count)];
+    this->stats.initial_heuristic = distance;
+
+    IterationStats iteration;
+    iteration.bound = distance;
+    solution.clear();
+
+    //Step to whichever neighbour is one move closer
+    while (distance > 0) {
+        iteration.nodes_expanded++;
+        for (uint8_t i = 0; i < tables->move_count[zero_position]; i++) {
+            Moves move = tables->moves[zero_position][i];
+            uint8_t next_position = tables->neighbours[zero_position][move];
+            iteration.nodes_generated++;
+
+            std::swap(cells[zero_position], cells[next_position]);
+            if (table[ExactTableSolver::rank(cells, tables->cell_count)] == distance - 1) {
+                solution.push(move);
+                zero_position = next_position;
+                distance--;
+                break;
+            }
+            std::swap(cells[zero_position], cells[next_position]);
+        }
+    }
+
+    this->stats.iterations.push_back(iteration);
+    this->stats.nodes_expanded = iteration.nodes_expanded;
+    this->stats.nodes_generated = iteration.nodes_generated;
+    this->stats.solution_length = solution.size();
+    this->stats.search_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - phase_start).count();
+    if (stats != NULL) {
+        *stats = this->stats;
+    }
+
+    if (goal_mapping != NULL) {
+        goal_mapping->unmap_moves(solution);
+    }
+}
+
+/**
+ * Get the distance table of a board size, generating it on first use.
+ *
+ * @param board_size The width/height of the board, 2 or 3.
+ *
+ * @return The distance from the goal of every board indexed by rank(), UINT8_MAX for unsolvable boards.
+ */
+const std::vector<uint8_t> &ExactTableSolver::get_table(uint8_t board_size)
+{
+    switch (board_size) {
+        case 2: {
+            static const std::vector<uint8_t> table = ExactTableSolver::generate_table(2);
+            return table;
+        }
+        case 3: {
+            static const std::vector<uint8_t> table = ExactTableSolver::generate_table(3);
+            return table;
+        }
+    }
+
+    throw std::string("Exact tables only support board sizes 2-") + std::to_string(MAX_BOARD_SIZE) + ".";
+}
+
+/**
+ * The index of a board among all permutations of its tiles, in lexicographic order.
+ *
+ * @param cells         The tiles in row major order.
+ * @param cell_count    The number of cells, at most 12.
+ *
+ * @return The rank.
+ */
+uint32_t ExactTableSolver::rank(const uint8_t *cells, uint8_t cell_count)
+{
+    uint32_t rank = 0;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < cell_count; i++) {
+        //The later tiles smaller than this one are the smaller ones not seen yet
+        uint32_t below = (1u << cells[i]) - 1;
+        uint8_t smaller = cells[i] - __builtin_popcount(seen & below);
+        seen |= 1u << cells[i];
+        rank = rank * (cell_count - i) + smaller;
+    }
+    return rank;
+}
+
+/**
+ * Pack a board into four bits per cell.
+ */
+static uint64_t pack_cells(const uint8_t *cells, uint8_t cell_count)
+{
+    uint64_t packed = 0;
+    for (uint8_t i = 0; i < cell_count; i++) {
+        packed |= ((uint64_t) cells[i]) << (i * 4);
+    }
+    return packed;
+}
+
+/**
+ * Breadth first search from the goal over every solvable board.
+ *
+ * @param board_size The width/height of the board.
+ *
+ * @return The table.
+ */
+std::vector<uint8_t> ExactTableSolver::generate_table(uint8_t board_size)
+{
+    const BoardTables *tables = get_board_tables(board_size);
+    uint8_t cell_count = tables->cell_count;
+
+    uint32_t permutations = 1;
+    for (uint8_t i = 2; i <= cell_count; i++) {
+        permutations *= i;
+    }
+    std::vector<uint8_t> table(permutations, UINT8_MAX);
+
+    //Boards are queued packed, four bits per cell
+    std::queue<uint64_t> frontier;
+    uint8_t cells[MAX_CELLS];
+    for (uint8_t i = 0; i < cell_count - 1; i++) {
+        cells[i] = i + 1;
+    }
+    cells[cell_count - 1] = 0;
+
+    table[ExactTableSolver::rank(cells, cell_count)] = 0;
+    frontier.push(pack_cells(cells, cell_count));
+
+    while (!frontier.empty()) {
+        uint64_t packed = frontier.front();
+        frontier.pop();
+
+        uint8_t zero_position = 0;
+        for (uint8_t i = 0; i < cell_count; i++) {
+            cells[i] = (packed >> (i * 4)) & 0xF;
+            if (cells[i] == 0) {
+                zero_position = i;
+            }
+        }
+        uint8_t distance = table[ExactTableSolver::rank(cells, cell_count)];
+
+        for (uint8_t i = 0; i < tables->move_count[zero_position]; i++) {
+            uint8_t next_position = tables->neighbours[zero_position][tables->moves[zero_position][i]];
+            std::swap(cells[zero_position], cells[next_position]);
+
+            uint32_t next_rank = ExactTableSolver::rank(cells, cell_count);
+            if (table[next_rank] == UINT8_MAX) {
+                table[next_rank] = distance + 1;
+                frontier.push(pack_cells(cells, cell_count));
+            }
+
+            std::swap(cells[zero_position], cells[next_position]);
+        }
+    }
+
+    return table;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Solver.hh"
+
+namespace TaquinSolve
+{
+    /**
+     * Solves small boards by reading the path out of a table of every board's distance from the goal.
+     * The table is built by a breadth first search from the goal the first time a size is solved, a
+     * few tens of milliseconds and 363KB for 3x3, and shared by every solver in the process.
+     * Each move then goes to the neighbour one step closer, so a solve is as many lookups as moves.
+     */
+    class ExactTableSolver : public Solver
+    {
+        public:
+            //The largest board size with a table, a 4x4 table wouldn't fit in memory
+            static const uint8_t MAX_BOARD_SIZE = 3;
+
+            ExactTableSolver(SolverOptions options = SolverOptions());
+
+            void solve_into(std::vector<uint8_t> board, uint8_t board_size, MoveSequence &solution, SolveStats *stats = NULL);
+
+            static const std::vector<uint8_t> &get_table(uint8_t board_size);
+            static uint32_t rank(const uint8_t *cells, uint8_t cell_count);
+
+        protected:
+            static std::vector<uint8_t> generate_table(uint8_t board_size);
+    };
+}
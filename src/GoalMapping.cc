@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <string>
+
+#include "GoalMapping.hh"
+#include "BoardTables.hh"
+
+using namespace TaquinSolve;
+
+/**
+ * Constructor.
+ * Only goals with the empty cell in a corner can be reached by reflection.
+ *
+ * @param goal_board    The board state that counts as solved.
+ * @param board_size    The width/height of the board.
+ */
+GoalMapping::GoalMapping(std::vector<uint8_t> goal_board, uint8_t board_size)
+    : board_size(board_size)
+{
+    if (board_size < 2 || board_size > MAX_BOARD_SIZE) {
+        throw std::string("Board size invalid.\nThis library only supports board sizes 2-5.");
+    }
+
+    uint8_t cell_count = board_size * board_size;
+
+    if (goal_board.size() != cell_count) {
+        throw std::string("Not enough tiles to fill goal board: ") + std::to_string(goal_board.size()) + "/" + std::to_string(cell_count);
+    }
+
+    std::vector<uint8_t> sorted_goal = goal_board;
+    std::sort(sorted_goal.begin(), sorted_goal.end());
+    for (uint8_t i = 0; i < cell_count; i++) {
+        if (sorted_goal[i] != i) {
+            throw std::string("Improper goal sequence given, missing: ") + std::to_string(i);
+        }
+    }
+
+    //Pick the reflection taking the empty cell to the bottom right corner
+    uint8_t zero_position = std::find(goal_board.begin(), goal_board.end(), 0) - goal_board.begin();
+    uint8_t zero_x = zero_position % board_size;
+    uint8_t zero_y = zero_position / board_size;
+
+    if ((zero_x != 0 && zero_x != board_size - 1) || (zero_y != 0 && zero_y != board_size - 1)) {
+        throw std::string("Goal board must have the empty tile in a corner.");
+    }
+
+    this->flip_x = zero_x == 0;
+    this->flip_y = zero_y == 0;
+
+    this->cell_map.resize(cell_count);
+    for (uint8_t cell = 0; cell < cell_count; cell++) {
+        uint8_t x = cell % board_size;
+        uint8_t y = cell / board_size;
+        if (this->flip_x) {
+            x = board_size - 1 - x;
+        }
+        if (this->flip_y) {
+            y = board_size - 1 - y;
+        }
+        this->cell_map[cell] = y * board_size + x;
+    }
+
+    //In the standard goal, cell i holds tile i + 1
+    this->tile_map.resize(cell_count);
+    for (uint8_t cell = 0; cell < cell_count; cell++) {
+        uint8_t tile = goal_board[cell];
+        this->tile_map[tile] = tile == 0 ? 0 : this->cell_map[cell] + 1;
+    }
+}
+
+/**
+ * Translate a board into the standard frame.
+ *
+ * @param board The board state in the frame of the goal.
+ *
+ * @return The equivalent board state against the standard goal.
+ */
+std::vector<uint8_t> GoalMapping::map_board(std::vector<uint8_t> board)
+{
+    uint8_t cell_count = this->cell_map.size();
+
+    if (board.size() != cell_count) {
+        throw std::string("Not enough tiles to fill board: ") + std::to_string(board.size()) + "/" + std::to_string(cell_count);
+    }
+
+    std::vector<uint8_t> mapped_board(cell_count);
+    this->map_board_into(board.data(), mapped_board.data());
+
+    return mapped_board;
+}
+
+/**
+ * Translate a board into the standard frame, writing it into the caller's buffer.
+ *
+ * @param board         The board state in the frame of the goal, board_size^2 tiles.
+ * @param mapped_board  Filled with the equivalent board state against the standard goal.
+ */
+void GoalMapping::map_board_into(const uint8_t *board, uint8_t *mapped_board)
+{
+    uint8_t cell_count = this->cell_map.size();
+
+    for (uint8_t cell = 0; cell < cell_count; cell++) {
+        if (board[cell] >= cell_count) {
+            throw std::string("Improper sequence given, unexpected: ") + std::to_string(board[cell]);
+        }
+        mapped_board[this->cell_map[cell]] = this->tile_map[board[cell]];
+    }
+}
+
+/**
+ * Translate a move made in the standard frame back into the frame of the goal.
+ *
+ * @param move The move in the standard frame.
+ *
+ * @return The same move in the frame of the goal.
+ */
+Moves GoalMapping::unmap_move(Moves move)
+{
+    switch (move) {
+        case UP:
+            return this->flip_y ? DOWN : UP;
+        case DOWN:
+            return this->flip_y ? UP : DOWN;
+        case LEFT:
+            return this->flip_x ? RIGHT : LEFT;
+        case RIGHT:
+        default:
+            return this->flip_x ? LEFT : RIGHT;
+    }
+}
+
+/**
+ * Translate a solution back into the frame of the goal, in place.
+ *
+ * @param moves The moves in the standard frame.
+ */
+void GoalMapping::unmap_moves(MoveSequence &moves)
+{
+    for (uint8_t i = 0; i < moves.size(); i++) {
+        moves.set(i, this->unmap_move(moves[i]));
+    }
+}
+
+/**
+ * @return Whether the goal is the standard goal, so mapping can be skipped.
+ */
+bool GoalMapping::is_identity()
+{
+    if (this->flip_x || this->flip_y) {
+        return false;
+    }
+
+    for (uint8_t tile = 0; tile < this->tile_map.size(); tile++) {
+        if (this->tile_map[tile] != tile) {
+            return false;
+        }
+    }
+    return true;
+}
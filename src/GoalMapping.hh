@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "taquinsolve.hh"
+#include "MoveSequence.hh"
+
+namespace TaquinSolve
+{
+    /**
+     * Translates a puzzle with an arbitrary goal into one with the standard goal.
+     * The board is reflected so the goal's empty cell lands in the bottom right corner,
+     * then the tiles are relabelled by their goal cell, so the standard databases apply unchanged.
+     */
+    class GoalMapping
+    {
+        public:
+            GoalMapping(std::vector<uint8_t> goal_board, uint8_t board_size);
+
+            std::vector<uint8_t> map_board(std::vector<uint8_t> board);
+            void map_board_into(const uint8_t *board, uint8_t *mapped_board);
+            Moves unmap_move(Moves move);
+            void unmap_moves(MoveSequence &moves);
+
+            bool is_identity();
+
+        protected:
+            uint8_t board_size;
+
+            //Whether the board is mirrored left to right and top to bottom
+            bool flip_x = false;
+            bool flip_y = false;
+
+            //Cell in the standard frame of each cell in the given frame
+            std::vector<uint8_t> cell_map;
+
+            //Standard label of each tile of the given goal
+            std::vector<uint8_t> tile_map;
+    };
+}
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <algorithm>
+#include <tuple>
+#include <cstdint>
+
+#include "Board.hh"
+#include "BoardKernels.hh"
+#include "PerimeterDatabase.hh"
+
+namespace TaquinSolve
+{
+    /**
+     * Heuristic policies, chosen and combined at compile time.
+     *
+     * A policy estimates the number of moves from a board to the standard goal and must never
+     * overestimate it. Solvers take the policy as a template parameter and call it directly, so
+     * a composition inlines into the search loop. A policy provides:
+     *
+     *     uint8_t estimate(Board &board);     The estimate for the board
+     *     void prefetch(Board &board);        Start fetching any tables estimate() will read
+     *
+     * Policies may hold state, one copy is kept per solver.
+     */
+
+    /**
+     * The sum of the distances of each tile from its goal cell.
+     */
+    struct ManhattanDistance
+    {
+        uint8_t estimate(Board &board)
+        {
+            if (board.get_tables() == NULL) {
+                return 0;
+            }
+
+            return BoardKernels::manhattan_distance(board.get_cells(), board.get_tables());
+        }
+
+        void prefetch(Board &) {}
+    };
+
+    /**
+     * Manhattan distance plus two moves for every tile that has to leave its goal row or column
+     * to let another tile in the same line past.
+     * The counts are kept by the board per line and followed from move to move.
+     */
+    struct LinearConflict
+    {
+        uint8_t estimate(Board &board)
+        {
+            const BoardTables *tables = board.get_tables();
+            if (tables == NULL) {
+                return 0;
+            }
+
+            return BoardKernels::manhattan_distance(board.get_cells(), tables) + 2 * board.get_linear_conflicts();
+        }
+
+        void prefetch(Board &) {}
+
+        /**
+         * Count the tiles that must leave a line for the rest to reach their goals along it.
+         *
+         * @param cells     The board state.
+         * @param tables    The geometry of the board.
+         * @param line      The row or column index.
+         * @param row       True to check a row, false a column.
+         *
+         * @return The number of tiles outside the longest run already in goal order.
+         */
+        static uint8_t count_conflicts(const uint8_t *cells, const BoardTables *tables, uint8_t line, bool row)
+        {
+            uint8_t size = tables->board_size;
+
+            //The goal position along the line of each tile already in its goal line, in board order
+            uint8_t goals[MAX_CELLS];
+            uint8_t count = 0;
+            for (uint8_t i = 0; i < size; i++) {
+                uint8_t tile = cells[row ? line * size + i : i * size + line];
+                if (tile == 0) {
+                    continue;
+                }
+                if (row && tables->goal_y[tile] == line) {
+                    goals[count++] = tables->goal_x[tile];
+                } else if (!row && tables->goal_x[tile] == line) {
+                    goals[count++] = tables->goal_y[tile];
+                }
+            }
+
+            //Longest increasing run, lines are short enough for the quadratic version
+            uint8_t lengths[MAX_CELLS];
+            uint8_t longest = 0;
+            for (uint8_t i = 0; i < count; i++) {
+                lengths[i] = 1;
+                for (uint8_t j = 0; j < i; j++) {
+                    if (goals[j] < goals[i]) {
+                        lengths[i] = std::max(lengths[i], (uint8_t)(lengths[j] + 1));
+                    }
+                }
+                longest = std::max(longest, lengths[i]);
+            }
+
+            return count - longest;
+        }
+    };
+
+    /**
+     * Linear conflicts plus two more kinds of tiles that must step out of the way, from Korf and Taylor:
+     *
+     *     Corner tiles    A corner holding the wrong tile while both of its neighbours are in place.
+     *                     The right tile can only come in through a neighbour, so one of them moves out and back.
+     *     Last move       The last move slides in the tile left of or above the empty cell's goal, so
+     *                     one of the two has to visit the goal corner. If neither is in the empty cell's
+     *                     goal column or row respectively, that costs two moves Manhattan distance misses.
+     *
+     * A tile only ever pays for one of these, and tiles in a row or column with linear conflicts pay for none.
+     */
+    struct EnhancedLinearConflict
+    {
+        uint8_t estimate(Board &board)
+        {
+            const BoardTables *tables = board.get_tables();
+            if (tables == NULL) {
+                return 0;
+            }
+
+            const uint8_t *cells = board.get_cells();
+            uint8_t manhattan = BoardKernels::manhattan_distance(cells, tables);
+            if (manhattan == 0) {
+                return 0;
+            }
+
+            uint8_t estimate = manhattan + 2 * board.get_linear_conflicts();
+            uint8_t size = tables->board_size;
+            if (size < 3) {
+                return estimate;
+            }
+
+            //Tiles that have already paid for moves beyond their Manhattan distance
+            uint32_t charged = 0;
+
+            //The corners other than the empty cell's, each with its two neighbours
+            const uint8_t corners[3][3] = {
+                {0, 1, size},
+                {(uint8_t)(size - 1), (uint8_t)(size - 2), (uint8_t)(2 * size - 1)},
+                {(uint8_t)(size * (size - 1)), (uint8_t)(size * (size - 2)), (uint8_t)(size * (size - 1) + 1)}
+            };
+            for (const uint8_t *corner : corners) {
+                if (
+                    cells[corner[0]] != corner[0] + 1 &&
+                    is_free(board, tables, cells, charged, corner[1]) &&
+                    is_free(board, tables, cells, charged, corner[2])
+                ) {
+                    charged |= (1 << cells[corner[1]]) | (1 << cells[corner[2]]);
+                    estimate += 2;
+                }
+            }
+
+            //The tiles left of and above the empty cell's goal
+            uint8_t left_tile = size * size - 1;
+            uint8_t above_tile = size * size - size;
+            uint8_t left_cell = 0;
+            uint8_t above_cell = 0;
+            for (uint8_t cell = 0; cell < tables->cell_count; cell++) {
+                if (cells[cell] == left_tile) {
+                    left_cell = cell;
+                } else if (cells[cell] == above_tile) {
+                    above_cell = cell;
+                }
+            }
+            if (
+                tables->x[left_cell] != size - 1 &&
+                tables->y[above_cell] != size - 1 &&
+                !(charged & ((1 << left_tile) | (1 << above_tile))) &&
+                is_conflict_free(board, tables, left_cell) &&
+                is_conflict_free(board, tables, above_cell)
+            ) {
+                estimate += 2;
+            }
+
+            return estimate;
+        }
+
+        void prefetch(Board &) {}
+
+        /**
+         * @return True if the cell holds its goal tile, not yet charged and free of linear conflicts.
+         */
+        static bool is_free(Board &board, const BoardTables *tables, const uint8_t *cells, uint32_t charged, uint8_t cell)
+        {
+            return cells[cell] == cell + 1 && !(charged & (1 << cells[cell])) && is_conflict_free(board, tables, cell);
+        }
+
+        /**
+         * @return True if neither the row nor the column of the cell has linear conflicts.
+         */
+        static bool is_conflict_free(Board &board, const BoardTables *tables, uint8_t cell)
+        {
+            return board.get_line_conflicts(false, tables->y[cell]) == 0 && board.get_line_conflicts(true, tables->x[cell]) == 0;
+        }
+    };
+
+    /**
+     * The fewest moves between rows plus the fewest between columns, counting tiles by the line
+     * they belong in. At least Manhattan distance, and kept up to date incrementally as moves are made.
+     * Zero for board sizes without a table.
+     */
+    struct WalkingDistance
+    {
+        uint8_t estimate(Board &board)
+        {
+            return board.get_walking_distance();
+        }
+
+        void prefetch(Board &) {}
+    };
+
+    /**
+     * The additive pattern databases attached to the board, whatever groups they were built for.
+     * Zero if none are attached or they are for another board size.
+     */
+    struct PatternDatabaseHeuristic
+    {
+        uint8_t estimate(Board &board)
+        {
+            return board.get_pattern_db_heuristic();
+        }
+
+        void prefetch(Board &board)
+        {
+            board.prefetch_heuristic();
+        }
+    };
+
+    /**
+     * The largest estimate of any of the policies.
+     */
+    template<typename... Policies>
+    struct MaxOf
+    {
+        std::tuple<Policies...> policies;
+
+        uint8_t estimate(Board &board)
+        {
+            return std::apply([&board](Policies &... policy) {
+                uint8_t estimate = 0;
+                ((estimate = std::max(estimate, policy.estimate(board))), ...);
+                return estimate;
+            }, this->policies);
+        }
+
+        void prefetch(Board &board)
+        {
+            std::apply([&board](Policies &... policy) {
+                (policy.prefetch(board), ...);
+            }, this->policies);
+        }
+    };
+
+    /**
+     * The sum of the estimates of the policies.
+     * Only admissible if no move is counted by more than one of them, such as disjoint pattern groups.
+     */
+    template<typename... Policies>
+    struct SumOf
+    {
+        std::tuple<Policies...> policies;
+
+        uint8_t estimate(Board &board)
+        {
+            return std::apply([&board](Policies &... policy) {
+                uint32_t estimate = 0;
+                ((estimate += policy.estimate(board)), ...);
+                return (uint8_t) std::min(estimate, (uint32_t) UINT8_MAX);
+            }, this->policies);
+        }
+
+        void prefetch(Board &board)
+        {
+            std::apply([&board](Policies &... policy) {
+                (policy.prefetch(board), ...);
+            }, this->policies);
+        }
+    };
+
+    /**
+     * The exact distance for boards within the perimeter attached to the board, otherwise the
+     * inner estimate raised to at least one more than the perimeter radius.
+     */
+    template<typename Inner>
+    struct WithPerimeter
+    {
+        Inner inner;
+
+        uint8_t estimate(Board &board)
+        {
+            uint8_t distance;
+            if (board.get_perimeter_distance(distance)) {
+                return distance;
+            }
+
+            uint8_t estimate = this->inner.estimate(board);
+
+            //Outside the perimeter the state must be further away than its radius.
+            PerimeterDatabase *perimeter_database = board.get_perimeter_database();
+            if (perimeter_database != NULL) {
+                estimate = std::max(estimate, (uint8_t)(perimeter_database->get_radius() + 1));
+            }
+
+            return estimate;
+        }
+
+        void prefetch(Board &board)
+        {
+            this->inner.prefetch(board);
+        }
+    };
+
+    /**
+     * One policy for boards with pattern databases of their size attached, another for the rest.
+     * Boards switch over when databases loaded in the background are attached mid-search.
+     */
+    template<typename WithDatabase, typename WithoutDatabase>
+    struct IfPatternDatabase
+    {
+        WithDatabase with_database;
+        WithoutDatabase without_database;
+
+        uint8_t estimate(Board &board)
+        {
+            if (board.has_pattern_database()) {
+                return this->with_database.estimate(board);
+            }
+
+            return this->without_database.estimate(board);
+        }
+
+        void prefetch(Board &board)
+        {
+            if (board.has_pattern_database()) {
+                this->with_database.prefetch(board);
+            }
+        }
+    };
+
+    //The heuristic used by Board::get_heuristic() and IDASolver
+    typedef WithPerimeter<IfPatternDatabase<MaxOf<PatternDatabaseHeuristic, ManhattanDistance>, EnhancedLinearConflict>> DefaultHeuristic;
+}
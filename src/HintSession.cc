@@ -0,0 +1,135 @@
+#include <algorithm>
+
+#include "HintSession.hh"
+#include "GoalMapping.hh"
+
+using namespace TaquinSolve;
+
+/**
+ * Constructor.
+ * Validates the board, the first search happens when a hint is requested.
+ *
+ * @param board         The starting board state.
+ * @param board_size    The width/height of the board.
+ * @param options       Tunable parameters for the solver.
+ */
+HintSession::HintSession(std::vector<uint8_t> board, uint8_t board_size, SolverOptions options)
+    : solver(options), board_size(board_size), goal_board(options.goal_board)
+{
+    this->board = std::shared_ptr<Board>(new Board(board, board_size));
+
+    //Solvability depends on the goal, so validate the board as the solver will see it.
+    if (this->goal_board.empty()) {
+        this->board->validate_state();
+    } else {
+        Board(GoalMapping(this->goal_board, board_size).map_board(board), board_size).validate_state();
+    }
+}
+
+/**
+ * Find the best next move from the current board.
+ * Answered from the cached path while the player follows it, otherwise the board is solved again.
+ *
+ * @return The first move of an optimal solution.
+ */
+Moves HintSession::get_hint()
+{
+    if (this->check_solved()) {
+        throw std::string("Board is already solved.");
+    }
+
+    if (!this->path_valid) {
+        this->resolve();
+    }
+
+    return this->path[this->path_position];
+}
+
+/**
+ * Apply a move made by the player.
+ *
+ * @param move The move to apply.
+ */
+void HintSession::apply_move(Moves move)
+{
+    std::vector<Moves> available_moves = this->board->get_available_moves();
+    if (std::find(available_moves.begin(), available_moves.end(), move) == available_moves.end()) {
+        throw std::string("Move is not possible from the current board.");
+    }
+
+    this->board = std::shared_ptr<Board>(this->board->perform_move(move));
+    this->board->replace_move_history(MoveSequence());
+
+    //Following the path keeps the rest of it optimal.
+    if (this->path_valid && this->path_position < this->path.size() && this->path[this->path_position] == move) {
+        this->path_position++;
+        this->distance_lower_bound = this->path.size() - this->path_position;
+        return;
+    }
+
+    //One move changes the distance to the goal by exactly one either way.
+    this->path_valid = false;
+    if (this->distance_lower_bound > 0) {
+        this->distance_lower_bound--;
+    }
+}
+
+/**
+ * Search again from the current board, starting from the known lower bound.
+ */
+void HintSession::resolve()
+{
+    this->solver.solve_from_bound(this->board->get_state(), this->board_size, this->distance_lower_bound, this->path);
+    this->solve_count++;
+
+    this->path_position = 0;
+    this->path_valid = true;
+    this->distance_lower_bound = this->path.size();
+}
+
+bool HintSession::check_solved()
+{
+    if (!this->goal_board.empty()) {
+        return this->board->get_state() == this->goal_board;
+    }
+    return this->board->check_solved();
+}
+
+std::vector<uint8_t> HintSession::get_board()
+{
+    return this->board->get_state();
+}
+
+/**
+ * Get the length of an optimal solution from the current board.
+ *
+ * @return The number of moves remaining.
+ */
+uint8_t HintSession::get_remaining_moves()
+{
+    if (this->check_solved()) {
+        return 0;
+    }
+
+    if (!this->path_valid) {
+        this->resolve();
+    }
+
+    return this->path.size() - this->path_position;
+}
+
+/**
+ * @return The number of searches performed so far.
+ */
+uint32_t HintSession::get_solve_count()
+{
+    return this->solve_count;
+}
+
+/**
+ * @return The statistics of the most recent search.
+ */
+SolveStats HintSession::get_stats()
+{
+    return this->solver.get_stats();
+}
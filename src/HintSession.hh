@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "IDASolver.hh"
+
+namespace TaquinSolve
+{
+    /**
+     * Follows a game in progress and answers "what is the best next move?".
+     * Keeps the optimal path from the last solve and only searches again when the player leaves it.
+     */
+    class HintSession
+    {
+        public:
+            HintSession(std::vector<uint8_t> board, uint8_t board_size, SolverOptions options = SolverOptions());
+
+            Moves get_hint();
+            void apply_move(Moves move);
+
+            bool check_solved();
+            std::vector<uint8_t> get_board();
+            uint8_t get_remaining_moves();
+            uint32_t get_solve_count();
+            SolveStats get_stats();
+
+        protected:
+            //Kept between solves so its databases stay loaded
+            IDASolver solver;
+
+            //The current board
+            std::shared_ptr<Board> board;
+            uint8_t board_size;
+
+            //The board state counted as solved, empty for the standard goal
+            std::vector<uint8_t> goal_board;
+
+            //The optimal path from the last solve and how far along it the board is, valid if path_valid
+            MoveSequence path;
+            uint8_t path_position = 0;
+            bool path_valid = false;
+
+            //A lower bound on the current distance to the goal
+            uint32_t distance_lower_bound = 0;
+
+            //The number of searches performed
+            uint32_t solve_count = 0;
+
+            void resolve();
+    };
+}
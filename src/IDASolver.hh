@@ -2,9 +2,15 @@
 
 #include <string>
 #include <queue>
+#include <limits>
+#include <chrono>
+#include <algorithm>
 #include <cstdint>
 
 #include "Solver.hh"
+#include "Heuristics.hh"
+#include "GoalMapping.hh"
+#include "PerimeterDatabase.hh"
 
 namespace TaquinSolve
 {
@@ -19,14 +25,349 @@ namespace TaquinSolve
         }
     };
 
-    class IDASolver : public Solver
+    /**
+     * Iterative Deepening A* search with the heuristic given as a policy, see Heuristics.hh.
+     * The policy is called directly rather than through a virtual function so it inlines into the search.
+     */
+    template<typename Heuristic>
+    class BasicIDASolver : public Solver
     {
         public:
-            IDASolver();
-            std::queue<Moves> solve(std::vector<uint8_t> board, uint8_t board_size);
+            BasicIDASolver(SolverOptions options = SolverOptions(), Heuristic heuristic = Heuristic())
+                : Solver(options), heuristic(heuristic)
+            {
+            }
+
+            void solve_into(std::vector<uint8_t> board, uint8_t board_size, MoveSequence &solution, SolveStats *stats = NULL);
+            void solve_from_bound(std::vector<uint8_t> board, uint8_t board_size, uint32_t minimum_bound, MoveSequence &solution, SolveStats *stats = NULL);
+            void solve_validated(const std::vector<uint8_t> &board, uint8_t board_size, MoveSequence &solution, SolveStats *stats = NULL);
             SearchResult search(std::shared_ptr<Board> board, uint32_t bound);
-            std::vector< std::shared_ptr<Board> > perform_moves(Board *board, std::vector<Moves> moves);
+            BoardList perform_moves(Board *board);
         protected:
-            std::map<uint64_t, uint8_t> visited_cache;
+            template<typename> friend class BasicParallelIDASolver;
+
+            Heuristic heuristic;
+
+            //Emptied at the end of every solve so the search arena can be reset
+            std::map<StateHash, uint8_t, std::less<StateHash>, ArenaAllocator<std::pair<const StateHash, uint8_t>>> visited_cache;
+
+            //Counters for the iteration in progress
+            IterationStats iteration_stats;
+
+            void solve_standard(const std::vector<uint8_t> &board, uint8_t board_size, uint32_t minimum_bound, bool validate, MoveSequence &solution, SolveStats *stats);
+            uint8_t evaluate(Board &board);
+
+            /**
+             * Return the microseconds elapsed since the given time point.
+             */
+            static uint64_t elapsed_microseconds(std::chrono::steady_clock::time_point start)
+            {
+                return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            }
+    };
+
+    /**
+     * IDA* with the default heuristic, compiled once into the library.
+     */
+    class IDASolver : public BasicIDASolver<DefaultHeuristic>
+    {
+        public:
+            IDASolver(SolverOptions options = SolverOptions());
     };
+
+    extern template class BasicIDASolver<DefaultHeuristic>;
+
+    /**
+     * Solve the board state given to this object.
+     * Uses an Iterative Deepening A* search algorithm.
+     *
+     * @param board         The board state.
+     * @param board_size    The width/height of the board.
+     * @param solution      Filled with the moves taken to reach the solution.
+     * @param stats         If given, filled with a description of the work done.
+     */
+    template<typename Heuristic>
+    void BasicIDASolver<Heuristic>::solve_into(std::vector<uint8_t> board, uint8_t board_size, MoveSequence &solution, SolveStats *stats)
+    {
+        this->solve_from_bound(board, board_size, 0, solution, stats);
+    }
+
+    /**
+     * Solve the board state given to this object, starting the search at a known lower bound.
+     * The bound must not exceed the optimal solution length, otherwise a longer solution may be returned.
+     *
+     * @param board         The board state.
+     * @param board_size    The width/height of the board.
+     * @param minimum_bound A lower bound on the solution length, used if it beats the heuristic.
+     * @param solution      Filled with the moves taken to reach the solution.
+     * @param stats         If given, filled with a description of the work done.
+     */
+    template<typename Heuristic>
+    void BasicIDASolver<Heuristic>::solve_from_bound(std::vector<uint8_t> board, uint8_t board_size, uint32_t minimum_bound, MoveSequence &solution, SolveStats *stats)
+    {
+        //Other goals are solved as the equivalent puzzle against the standard goal.
+        std::shared_ptr<GoalMapping> goal_mapping;
+        if (!this->options.goal_board.empty()) {
+            goal_mapping = std::shared_ptr<GoalMapping>(new GoalMapping(this->options.goal_board, board_size));
+            board = goal_mapping->map_board(board);
+        }
+
+        this->solve_standard(board, board_size, minimum_bound, true, solution, stats);
+
+        if (goal_mapping != NULL) {
+            goal_mapping->unmap_moves(solution);
+        }
+    }
+
+    /**
+     * Solve a board the caller has already validated, reading it in place.
+     * The board must be solvable against the standard goal, SolverOptions::goal_board is not applied.
+     *
+     * @param board         The board state.
+     * @param board_size    The width/height of the board.
+     * @param solution      Filled with the moves taken to reach the solution.
+     * @param stats         If given, filled with a description of the work done.
+     */
+    template<typename Heuristic>
+    void BasicIDASolver<Heuristic>::solve_validated(const std::vector<uint8_t> &board, uint8_t board_size, MoveSequence &solution, SolveStats *stats)
+    {
+        this->solve_standard(board, board_size, 0, false, solution, stats);
+    }
+
+    /**
+     * Search from a board against the standard goal.
+     *
+     * @param board         The board state.
+     * @param board_size    The width/height of the board.
+     * @param minimum_bound A lower bound on the solution length, used if it beats the heuristic.
+     * @param validate      Check the board before searching.
+     * @param solution      Filled with the moves taken to reach the solution.
+     * @param stats         If given, filled with a description of the work done.
+     */
+    template<typename Heuristic>
+    void BasicIDASolver<Heuristic>::solve_standard(const std::vector<uint8_t> &board, uint8_t board_size, uint32_t minimum_bound, bool validate, MoveSequence &solution, SolveStats *stats)
+    {
+        //Every node of the search comes from the thread's arena, released in one go when the solve ends.
+        //The cache is emptied first, however the solve ends, so nothing is left in the arena.
+        ArenaScope arena_scope;
+        struct CacheGuard {
+            BasicIDASolver *solver;
+            ~CacheGuard() { solver->visited_cache.clear(); }
+        } cache_guard = {this};
+
+        //Since we're starting a new solve, clear the visited cache and statistics.
+        this->visited_cache.clear();
+        this->stats = SolveStats();
+
+        //Load the pattern databases if the board size has them.
+        std::chrono::steady_clock::time_point phase_start = std::chrono::steady_clock::now();
+        if (this->uses_pattern_databases(board_size)) {
+            this->load_pattern_database(board_size);
+        }
+        this->stats.database_load_time = this->elapsed_microseconds(phase_start);
+
+        std::shared_ptr<Board> initial_board = std::shared_ptr<Board>(new Board(board, board_size, this->pattern_database));
+
+        //Ensure the given board state is valid
+        if (validate) {
+            phase_start = std::chrono::steady_clock::now();
+            initial_board->validate_state();
+            this->stats.validation_time = this->elapsed_microseconds(phase_start);
+        }
+
+        //Build the goal perimeter and search against it
+        phase_start = std::chrono::steady_clock::now();
+        this->load_perimeter_database(board_size);
+        if (this->perimeter_database != NULL) {
+            initial_board = std::shared_ptr<Board>(new Board(board, board_size, this->pattern_database, this->perimeter_database));
+        }
+        this->stats.database_load_time += this->elapsed_microseconds(phase_start);
+
+        this->stats.initial_heuristic = this->evaluate(*initial_board);
+        uint32_t bound = std::max((uint32_t)this->stats.initial_heuristic, minimum_bound);
+
+        phase_start = std::chrono::steady_clock::now();
+        while (true) {
+            this->iteration_stats = IterationStats();
+            this->iteration_stats.bound = bound;
+
+            SearchResult result = this->search(initial_board, bound);
+
+            this->stats.iterations.push_back(this->iteration_stats);
+            this->stats.nodes_expanded += this->iteration_stats.nodes_expanded;
+            this->stats.nodes_generated += this->iteration_stats.nodes_generated;
+
+            if (result.solved) {
+                this->stats.search_time = this->elapsed_microseconds(phase_start);
+                this->stats.solution_length = result.board->get_cost();
+                this->stats.arena_high_water = SearchArena::get_thread_arena().get_high_water_mark();
+                if (stats != NULL) {
+                    *stats = this->stats;
+                }
+
+                solution = result.board->get_move_history();
+                return;
+            }
+            if (result.cost == std::numeric_limits<std::uint8_t>::max()) {
+                throw std::string("Puzzle is unsolvable.");
+            }
+
+            bound = result.cost;
+
+            //Databases loading in the background are picked up between iterations.
+            //The bound found so far stays a valid lower bound, the cached costs don't.
+            if (this->uses_pattern_databases(board_size) && this->pattern_database == NULL) {
+                this->load_pattern_database(board_size);
+                if (this->pattern_database != NULL) {
+                    initial_board = std::shared_ptr<Board>(new Board(board, board_size, this->pattern_database, this->perimeter_database));
+                    this->visited_cache.clear();
+                    this->stats.database_upgrade_iteration = this->stats.iterations.size() + 1;
+                    bound = std::max(bound, (uint32_t) this->evaluate(*initial_board));
+                }
+            }
+        }
+    }
+
+    /**
+     * Recursively search until the bound is reached.
+     *
+     * @param board The root to search from.
+     * @oaram bound The bound to stop at.
+     *
+     * @return a struct representing either a solution or the lowest cost board which exceeded the bound.
+     */
+    template<typename Heuristic>
+    SearchResult BasicIDASolver<Heuristic>::search(std::shared_ptr<Board> board, uint32_t bound)
+    {
+        uint8_t board_cost = board->get_cost() + this->evaluate(*board);
+
+        //If this board cost is above the bound return it.
+        if (board_cost > bound) {
+            return SearchResult(
+                false,
+                board_cost,
+                board
+            );
+        }
+
+        //If this board is solved return it.
+        if (board->check_solved()) {
+            return SearchResult(
+                true,
+                board_cost,
+                board
+            );
+        }
+
+        //If this board is within the perimeter the rest of the path is known exactly.
+        uint8_t perimeter_distance;
+        if (board->get_perimeter_distance(perimeter_distance)) {
+            return SearchResult(
+                true,
+                board_cost,
+                this->perimeter_database->complete_path(board)
+            );
+        }
+
+        //Find the neighbors by applying each possible move
+        this->iteration_stats.nodes_expanded++;
+        BoardList neighbors = this->perform_moves(board.get());
+
+        //Find the neighbor with the minimum search() value
+        SearchResult min_result(
+            false,
+            std::numeric_limits<uint8_t>::max(),
+            board
+        );
+
+        for (
+            BoardList::iterator it = neighbors.begin();
+            it != neighbors.end();
+            ++it
+        ) {
+            std::shared_ptr<Board> neighbor = *it;
+            SearchResult neighbor_result = this->search(neighbor, bound);
+
+            //If this neighbor produced a solved state, return it.
+            if (neighbor_result.solved) {
+                return neighbor_result;
+            }
+
+            //Check if this neighbor is the new minimum
+            if (neighbor_result.cost < min_result.cost) {
+                min_result = neighbor_result;
+            }
+        }
+
+        //Return the minimum found result.
+        return min_result;
+    }
+
+    /**
+     * Estimate the distance of a board from the goal with this solver's heuristic, cached on the board.
+     *
+     * @param board The board to estimate.
+     *
+     * @return The heuristic value.
+     */
+    template<typename Heuristic>
+    uint8_t BasicIDASolver<Heuristic>::evaluate(Board &board)
+    {
+        if (!board.has_heuristic()) {
+            board.set_heuristic(this->heuristic.estimate(board));
+        }
+
+        return board.get_heuristic();
+    }
+
+    /**
+     * Create a list of new boards by applying each possible move to the given board.
+     * The boards and the lists are allocated from the thread's search arena.
+     *
+     * @param board The reference board state.
+     */
+    template<typename Heuristic>
+    BoardList BasicIDASolver<Heuristic>::perform_moves(Board *board) {
+        uint8_t move_count = board->get_available_move_count();
+        BoardList children;
+        BoardList results;
+        children.reserve(move_count);
+        results.reserve(move_count);
+
+        //Create every child first and start fetching their pattern database entries,
+        //so the table reads overlap instead of stalling one after another.
+        for (uint8_t i = 0; i < move_count; i++) {
+            std::shared_ptr<Board> new_board = board->perform_move_in_arena(board->get_available_move(i));
+            this->heuristic.prefetch(*new_board);
+            children.push_back(new_board);
+        }
+
+        this->iteration_stats.nodes_generated += children.size();
+        if (this->pattern_database != NULL && this->pattern_database->get_board_size() == board->get_board_size()) {
+            this->stats.pdb_lookups += children.size() * this->pattern_database->get_group_count();
+        }
+
+        for (std::shared_ptr<Board> new_board : children) {
+            auto it = this->visited_cache.find(new_board->get_state_hash());
+            uint8_t new_cost = new_board->get_cost() + this->evaluate(*new_board);
+
+            if (it != this->visited_cache.end()) {
+                this->stats.transposition_hits++;
+                if ( new_cost > it->second) {
+                    continue;
+                }
+            }
+            if (this->options.visited_cache_limit == 0 || this->visited_cache.size() < this->options.visited_cache_limit) {
+                this->visited_cache.insert(std::pair<StateHash, uint8_t>(new_board->get_state_hash(), new_cost));
+            }
+
+            results.push_back(new_board);
+        }
+
+        //Every result has its heuristic cached by now
+        std::sort (results.begin(), results.end(), [](const std::shared_ptr<Board> &l, const std::shared_ptr<Board> &r){
+            return (l->get_cost() + l->get_heuristic()) < (r->get_cost() + r->get_heuristic());
+        });
+        return results;
+    }
 }
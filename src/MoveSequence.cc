@@ -0,0 +1,205 @@
+#include <cstring>
+
+#include "MoveSequence.hh"
+
+using namespace TaquinSolve;
+
+//The letter of each move when written as text, indexed by Moves.
+static const char MOVE_LETTERS[4] = {'U', 'D', 'L', 'R'};
+
+MoveSequence::MoveSequence()
+{
+    memset(this->data, 0, sizeof(this->data));
+}
+
+/**
+ * Constructor.
+ * Unpacks a sequence previously stored from get_data().
+ *
+ * @param data      The packed moves.
+ * @param length    The number of moves.
+ */
+MoveSequence::MoveSequence(const uint8_t *data, uint8_t length) : MoveSequence()
+{
+    if (length > CAPACITY) {
+        throw std::string("Move sequence too long: ") + std::to_string(length);
+    }
+
+    this->length = length;
+    memcpy(this->data, data, (length + 3) / 4);
+
+    //Keep the unused bits clear so sequences compare bytewise
+    if (length % 4 != 0) {
+        this->data[length / 4] &= (1 << ((length % 4) * 2)) - 1;
+    }
+}
+
+/**
+ * Constructor.
+ *
+ * @param moves A queue of moves in order.
+ */
+MoveSequence::MoveSequence(std::queue<Moves> moves) : MoveSequence()
+{
+    while (!moves.empty()) {
+        this->push(moves.front());
+        moves.pop();
+    }
+}
+
+/**
+ * Append a move.
+ *
+ * @param move The move to append.
+ */
+void MoveSequence::push(Moves move)
+{
+    if (this->length >= CAPACITY) {
+        throw std::string("Move sequence is full.");
+    }
+
+    this->data[this->length / 4] |= move << ((this->length % 4) * 2);
+    this->length++;
+}
+
+/**
+ * Remove the last move.
+ */
+void MoveSequence::pop()
+{
+    if (this->length == 0) {
+        return;
+    }
+
+    this->length--;
+    this->data[this->length / 4] &= ~(3 << ((this->length % 4) * 2));
+}
+
+/**
+ * Replace the move at the given index.
+ *
+ * @param index The index of the move, less than size().
+ * @param move  The new move.
+ */
+void MoveSequence::set(uint8_t index, Moves move)
+{
+    uint8_t shift = (index % 4) * 2;
+    this->data[index / 4] = (this->data[index / 4] & ~(3 << shift)) | (move << shift);
+}
+
+void MoveSequence::clear()
+{
+    memset(this->data, 0, sizeof(this->data));
+    this->length = 0;
+}
+
+/**
+ * Fetch the move at the given index.
+ *
+ * @param index The index of the move, less than size().
+ *
+ * @return The move.
+ */
+Moves MoveSequence::get(uint8_t index) const
+{
+    return (Moves) ((this->data[index / 4] >> ((index % 4) * 2)) & 3);
+}
+
+Moves MoveSequence::back() const
+{
+    return this->get(this->length - 1);
+}
+
+uint8_t MoveSequence::size() const
+{
+    return this->length;
+}
+
+bool MoveSequence::empty() const
+{
+    return this->length == 0;
+}
+
+MoveSequence::const_iterator MoveSequence::begin() const
+{
+    return const_iterator(this, 0);
+}
+
+MoveSequence::const_iterator MoveSequence::end() const
+{
+    return const_iterator(this, this->length);
+}
+
+/**
+ * Fetch the packed moves, for storing or sending a sequence.
+ *
+ * @return get_data_size() bytes holding 4 moves each.
+ */
+const uint8_t *MoveSequence::get_data() const
+{
+    return this->data;
+}
+
+/**
+ * @return The number of bytes needed to store the packed moves.
+ */
+uint8_t MoveSequence::get_data_size() const
+{
+    return (this->length + 3) / 4;
+}
+
+/**
+ * @return The moves as a queue, in order.
+ */
+std::queue<Moves> MoveSequence::to_queue() const
+{
+    std::queue<Moves> moves;
+    for (Moves move : *this) {
+        moves.push(move);
+    }
+    return moves;
+}
+
+/**
+ * Write the moves as text, one letter per move (U, D, L or R).
+ *
+ * @return The moves as a string.
+ */
+std::string MoveSequence::to_string() const
+{
+    std::string str(this->length, ' ');
+    for (uint8_t i = 0; i < this->length; i++) {
+        str[i] = MOVE_LETTERS[this->get(i)];
+    }
+    return str;
+}
+
+/**
+ * Read moves written by to_string().
+ *
+ * @param str The moves as a string.
+ *
+ * @return The move sequence.
+ */
+MoveSequence MoveSequence::from_string(std::string str)
+{
+    MoveSequence sequence;
+    for (char letter : str) {
+        const char *found = (const char *) memchr(MOVE_LETTERS, letter, sizeof(MOVE_LETTERS));
+        if (found == NULL) {
+            throw std::string("Unknown move: ") + letter;
+        }
+        sequence.push((Moves) (found - MOVE_LETTERS));
+    }
+    return sequence;
+}
+
+bool MoveSequence::operator==(const MoveSequence &other) const
+{
+    return this->length == other.length && memcmp(this->data, other.data, this->get_data_size()) == 0;
+}
+
+bool MoveSequence::operator!=(const MoveSequence &other) const
+{
+    return !(*this == other);
+}
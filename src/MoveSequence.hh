@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <queue>
+#include <cstdint>
+#include <iterator>
+
+#include "taquinsolve.hh"
+
+namespace TaquinSolve
+{
+    /**
+     * A sequence of moves packed at 2 bits per move into a fixed buffer.
+     * Copying one never allocates, so it is carried by every board in the search
+     * and can be filled in place by the solver.
+     */
+    class MoveSequence
+    {
+        public:
+            //The most moves a sequence can hold, enough for any optimal 5x5 solution (at most 208 moves)
+            static const uint16_t CAPACITY = 208;
+
+            /**
+             * Iterates over the moves of a sequence in order.
+             */
+            class const_iterator
+            {
+                public:
+                    typedef std::forward_iterator_tag iterator_category;
+                    typedef Moves value_type;
+                    typedef std::ptrdiff_t difference_type;
+                    typedef const Moves *pointer;
+                    typedef Moves reference;
+
+                    const_iterator(const MoveSequence *sequence, uint16_t index) : sequence(sequence), index(index) {}
+
+                    Moves operator*() const { return this->sequence->get(this->index); }
+                    const_iterator &operator++() { this->index++; return *this; }
+                    const_iterator operator++(int) { const_iterator previous = *this; this->index++; return previous; }
+                    bool operator==(const const_iterator &other) const { return this->index == other.index; }
+                    bool operator!=(const const_iterator &other) const { return this->index != other.index; }
+
+                protected:
+                    const MoveSequence *sequence;
+                    uint16_t index;
+            };
+
+            MoveSequence();
+            MoveSequence(const uint8_t *data, uint8_t length);
+            MoveSequence(std::queue<Moves> moves);
+
+            //Modify
+            void push(Moves move);
+            void pop();
+            void set(uint8_t index, Moves move);
+            void clear();
+
+            //Read
+            Moves get(uint8_t index) const;
+            Moves operator[](uint8_t index) const { return this->get(index); }
+            Moves back() const;
+            uint8_t size() const;
+            bool empty() const;
+            const_iterator begin() const;
+            const_iterator end() const;
+
+            //Packed representation, 4 moves per byte with the first in the lowest bits
+            const uint8_t *get_data() const;
+            uint8_t get_data_size() const;
+
+            //Conversion
+            std::queue<Moves> to_queue() const;
+            std::string to_string() const;
+            static MoveSequence from_string(std::string str);
+
+            bool operator==(const MoveSequence &other) const;
+            bool operator!=(const MoveSequence &other) const;
+
+        protected:
+            uint8_t data[CAPACITY / 4];
+            uint8_t length = 0;
+    };
+}
@@ -0,0 +1,10 @@
+#include "ParallelIDASolver.hh"
+
+using namespace TaquinSolve;
+
+namespace TaquinSolve
+{
+    template class BasicParallelIDASolver<DefaultHeuristic>;
+}
+
+ParallelIDASolver::ParallelIDASolver(SolverOptions options) : BasicParallelIDASolver<DefaultHeuristic>(options) {}
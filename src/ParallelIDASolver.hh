@@ -0,0 +1,270 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <unordered_set>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "IDASolver.hh"
+
+namespace TaquinSolve
+{
+    /**
+     * IDA* across several threads.
+     *
+     * The boards a few moves from the start are found breadth first, enough for every thread to take
+     * many of them, then each iteration the threads take frontier boards in turn and search below them
+     * to the iteration's bound. Every thread searches with its own BasicIDASolver, from its own search
+     * arena, sharing only the databases. The iteration that finds a solution ends once the boards being
+     * searched are done, and as every board was searched to the same bound the solution is optimal.
+     */
+    template<typename Heuristic>
+    class BasicParallelIDASolver : public Solver
+    {
+        public:
+            //Frontier boards per thread, so threads with shallow subtrees take more of them
+            static const uint32_t FRONTIER_PER_THREAD = 32;
+
+            BasicParallelIDASolver(SolverOptions options = SolverOptions(), Heuristic heuristic = Heuristic())
+                : Solver(options), heuristic(heuristic)
+            {
+            }
+
+            void solve_into(std::vector<uint8_t> board, uint8_t board_size, MoveSequence &solution, SolveStats *stats = NULL);
+            uint32_t get_thread_count();
+
+        protected:
+            Heuristic heuristic;
+
+            BoardList expand_frontier(std::shared_ptr<Board> initial_board, size_t size, std::shared_ptr<Board> &solved);
+
+            static uint64_t elapsed_microseconds(std::chrono::steady_clock::time_point start)
+            {
+                return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            }
+    };
+
+    /**
+     * Parallel IDA* with the default heuristic, compiled once into the library.
+     */
+    class ParallelIDASolver : public BasicParallelIDASolver<DefaultHeuristic>
+    {
+        public:
+            ParallelIDASolver(SolverOptions options = SolverOptions());
+    };
+
+    extern template class BasicParallelIDASolver<DefaultHeuristic>;
+
+    /**
+     * Solve the board state given to this object.
+     *
+     * @param board         The board state.
+     * @param board_size    The width/height of the board.
+     * @param solution      Filled with the moves taken to reach the solution.
+     * @param stats         If given, filled with a description of the work done.
+     */
+    template<typename Heuristic>
+    void BasicParallelIDASolver<Heuristic>::solve_into(std::vector<uint8_t> board, uint8_t board_size, MoveSequence &solution, SolveStats *stats)
+    {
+        ArenaScope arena_scope;
+        this->stats = SolveStats();
+        this->stats.algorithm = Algorithm::PARALLEL_IDA;
+
+        //Other goals are solved as the equivalent puzzle against the standard goal.
+        std::shared_ptr<GoalMapping> goal_mapping;
+        if (!this->options.goal_board.empty()) {
+            goal_mapping = std::shared_ptr<GoalMapping>(new GoalMapping(this->options.goal_board, board_size));
+            board = goal_mapping->map_board(board);
+        }
+
+        std::chrono::steady_clock::time_point phase_start = std::chrono::steady_clock::now();
+        if (this->uses_pattern_databases(board_size)) {
+            this->load_pattern_database(board_size);
+        }
+        this->stats.database_load_time = this->elapsed_microseconds(phase_start);
+
+        phase_start = std::chrono::steady_clock::now();
+        std::shared_ptr<Board> initial_board = std::shared_ptr<Board>(new Board(board, board_size, this->pattern_database));
+        initial_board->validate_state();
+        this->stats.validation_time = this->elapsed_microseconds(phase_start);
+
+        phase_start = std::chrono::steady_clock::now();
+        this->load_perimeter_database(board_size);
+        if (this->perimeter_database != NULL) {
+            initial_board = std::shared_ptr<Board>(new Board(board, board_size, this->pattern_database, this->perimeter_database));
+        }
+        this->stats.database_load_time += this->elapsed_microseconds(phase_start);
+
+        this->stats.initial_heuristic = this->heuristic.estimate(*initial_board);
+        uint32_t thread_count = this->get_thread_count();
+
+        phase_start = std::chrono::steady_clock::now();
+        std::shared_ptr<Board> solved;
+        BoardList frontier = this->expand_frontier(initial_board, thread_count * FRONTIER_PER_THREAD, solved);
+
+        //One solver per thread, sharing the databases
+        std::vector<std::unique_ptr<BasicIDASolver<Heuristic>>> workers;
+        for (uint32_t t = 0; t < thread_count; t++) {
+            workers.push_back(std::unique_ptr<BasicIDASolver<Heuristic>>(new BasicIDASolver<Heuristic>(this->options, this->heuristic)));
+            workers[t]->pattern_database = this->pattern_database;
+            workers[t]->perimeter_database = this->perimeter_database;
+        }
+
+        MoveSequence found;
+        bool solution_found = solved != NULL;
+        if (solved != NULL) {
+            found = solved->get_move_history();
+        }
+
+        uint32_t bound = this->stats.initial_heuristic;
+        while (!solution_found) {
+            IterationStats iteration;
+            iteration.bound = bound;
+            uint8_t next_bound = UINT8_MAX;
+
+            std::atomic<size_t> next_board(0);
+            std::atomic<bool> done(false);
+            std::mutex mutex;
+            std::vector<std::thread> threads;
+
+            for (uint32_t t = 0; t < thread_count; t++) {
+                threads.push_back(std::thread([&, t]() {
+                    BasicIDASolver<Heuristic> &worker = *workers[t];
+                    worker.iteration_stats = IterationStats();
+
+                    uint8_t minimum = UINT8_MAX;
+                    MoveSequence local_solution;
+                    bool local_found = false;
+
+                    size_t i;
+                    while (!done && (i = next_board++) < frontier.size()) {
+                        SearchResult result = worker.search(frontier[i], bound);
+                        if (result.solved) {
+                            local_solution = result.board->get_move_history();
+                            local_found = true;
+                            done = true;
+                            break;
+                        }
+                        minimum = std::min(minimum, result.cost);
+                    }
+
+                    //The cache lives in this thread's arena
+                    worker.visited_cache.clear();
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    iteration.nodes_expanded += worker.iteration_stats.nodes_expanded;
+                    iteration.nodes_generated += worker.iteration_stats.nodes_generated;
+                    next_bound = std::min(next_bound, minimum);
+                    if (local_found && (!solution_found || local_solution.size() < found.size())) {
+                        found = local_solution;
+                        solution_found = true;
+                    }
+                }));
+            }
+
+            for (std::thread &thread : threads) {
+                thread.join();
+            }
+
+            this->stats.iterations.push_back(iteration);
+            this->stats.nodes_expanded += iteration.nodes_expanded;
+            this->stats.nodes_generated += iteration.nodes_generated;
+
+            if (!solution_found && next_bound == UINT8_MAX) {
+                throw std::string("Puzzle is unsolvable.");
+            }
+            bound = next_bound;
+        }
+
+        for (std::unique_ptr<BasicIDASolver<Heuristic>> &worker : workers) {
+            this->stats.pdb_lookups += worker->stats.pdb_lookups;
+            this->stats.transposition_hits += worker->stats.transposition_hits;
+        }
+        this->stats.search_time = this->elapsed_microseconds(phase_start);
+        this->stats.solution_length = found.size();
+        this->stats.arena_high_water = SearchArena::get_thread_arena().get_high_water_mark();
+        if (stats != NULL) {
+            *stats = this->stats;
+        }
+
+        solution = found;
+        if (goal_mapping != NULL) {
+            goal_mapping->unmap_moves(solution);
+        }
+    }
+
+    /**
+     * Find the boards at the shallowest depth with at least the given number of them, breadth first.
+     * Each state is kept only at the depth it is first found.
+     *
+     * @param initial_board The board to start from.
+     * @param size          The number of boards wanted.
+     * @param solved        Set to the solved board if one is found on the way.
+     *
+     * @return The boards at that depth, empty if a solved board was found.
+     */
+    template<typename Heuristic>
+    BoardList BasicParallelIDASolver<Heuristic>::expand_frontier(std::shared_ptr<Board> initial_board, size_t size, std::shared_ptr<Board> &solved)
+    {
+        if (initial_board->check_solved()) {
+            solved = initial_board;
+            return BoardList();
+        }
+
+        std::unordered_set<StateHash, StateHashHasher> seen = {initial_board->get_state_hash()};
+        BoardList level;
+        level.push_back(initial_board);
+
+        while (level.size() < size) {
+            BoardList next_level;
+            for (std::shared_ptr<Board> board : level) {
+                for (uint8_t i = 0; i < board->get_available_move_count(); i++) {
+                    std::shared_ptr<Board> child = board->perform_move_in_arena(board->get_available_move(i));
+                    if (!seen.insert(child->get_state_hash()).second) {
+                        continue;
+                    }
+                    if (child->check_solved()) {
+                        solved = child;
+                        return BoardList();
+                    }
+                    next_level.push_back(child);
+                }
+            }
+
+            if (next_level.empty()) {
+                break;
+            }
+            level.swap(next_level);
+        }
+
+        //The most promising boards first, so a solution is found before the rest are handed out
+        for (std::shared_ptr<Board> board : level) {
+            if (!board->has_heuristic()) {
+                board->set_heuristic(this->heuristic.estimate(*board));
+            }
+        }
+        std::sort(level.begin(), level.end(), [](const std::shared_ptr<Board> &l, const std::shared_ptr<Board> &r) {
+            return l->get_heuristic() < r->get_heuristic();
+        });
+
+        return level;
+    }
+
+    /**
+     * @return The number of threads searched with.
+     */
+    template<typename Heuristic>
+    uint32_t BasicParallelIDASolver<Heuristic>::get_thread_count()
+    {
+        if (this->options.search_threads > 0) {
+            return this->options.search_threads;
+        }
+
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+}
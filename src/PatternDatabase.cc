@@ -0,0 +1,507 @@
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#include "PatternDatabase.hh"
+
+using namespace TaquinSolve;
+
+//Huge page size assumed when rounding table allocations.
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+/**
+ * Constructor.
+ *
+ * @param board_size        The width/height of the board the databases describe.
+ * @param use_huge_pages    Back the tables with huge pages to reduce TLB misses, where supported.
+ */
+PatternDatabase::PatternDatabase(uint8_t board_size, bool use_huge_pages)
+    : board_size(board_size), use_huge_pages(use_huge_pages)
+{
+}
+
+/**
+ * Destructor.
+ * Releases the tables.
+ */
+PatternDatabase::~PatternDatabase()
+{
+    for (Group &group : this->groups) {
+        this->release_table(group);
+    }
+}
+
+/**
+ * Free a group's table, unless it is attached read-only memory.
+ */
+void PatternDatabase::release_table(Group &group)
+{
+    if (group.read_only) {
+        return;
+    }
+
+#ifdef HAVE_SYS_MMAN_H
+    munmap(group.table, group.allocated_size);
+#else
+    free(group.table);
+#endif
+}
+
+/**
+ * Get the index digit order to use for a group when none is given.
+ * The standard 4x4 groups are ordered by how often each tile moved while solving random-walk boards,
+ * other groups by ascending tile.
+ *
+ * @param board_size    The width/height of the board.
+ * @param group_mask    Bit t is set for each tile t in the group.
+ *
+ * @return The tiles of the group, lowest digit first.
+ */
+std::vector<uint8_t> PatternDatabase::get_default_tile_order(uint8_t board_size, uint32_t group_mask)
+{
+    if (board_size == 4) {
+        switch (group_mask) {
+            case 0x001C: return {4, 3, 2};
+            case 0x2662: return {10, 6, 1, 5, 9, 13};
+            case 0xD980: return {11, 8, 7, 12, 14, 15};
+        }
+    }
+
+    std::vector<uint8_t> tiles;
+    for (uint8_t tile = 1; tile < board_size * board_size; tile++) {
+        if (group_mask & (1 << tile)) {
+            tiles.push_back(tile);
+        }
+    }
+    return tiles;
+}
+
+/**
+ * Add an empty table for a group of tiles.
+ *
+ * @param group_mask    Bit t is set for each tile t in the group.
+ * @param tile_order    The group's tiles, lowest index digit first. Defaults to get_default_tile_order().
+ */
+void PatternDatabase::add_group(uint32_t group_mask, std::vector<uint8_t> tile_order)
+{
+    if (this->groups.size() >= MAX_PATTERN_GROUPS) {
+        throw std::string("Too many pattern database groups.");
+    }
+
+    uint8_t cell_count = this->board_size * this->board_size;
+
+    if (tile_order.empty()) {
+        tile_order = get_default_tile_order(this->board_size, group_mask);
+    }
+
+    //The order must hold each tile of the group exactly once
+    uint32_t order_mask = 0;
+    for (uint8_t tile : tile_order) {
+        if (tile == 0 || tile >= cell_count || (order_mask & (1 << tile))) {
+            throw std::string("Invalid pattern database tile order.");
+        }
+        order_mask |= 1 << tile;
+    }
+    if (order_mask != group_mask) {
+        throw std::string("Invalid pattern database tile order.");
+    }
+
+    Group group;
+    group.mask = group_mask;
+    group.size = 1;
+
+    for (uint8_t tile : tile_order) {
+        group.tiles.push_back(tile);
+        group.multipliers.push_back(group.size);
+        group.size *= cell_count;
+    }
+
+    group.table = this->allocate_table(group.size, group.allocated_size);
+    this->groups.push_back(group);
+}
+
+/**
+ * Allocate a zeroed table.
+ *
+ * @param size              The number of entries.
+ * @param allocated_size    Set to the number of bytes actually allocated.
+ *
+ * @return The table.
+ */
+uint8_t *PatternDatabase::allocate_table(size_t size, size_t &allocated_size)
+{
+    allocated_size = size;
+
+#ifdef HAVE_SYS_MMAN_H
+    if (this->use_huge_pages) {
+        allocated_size = ((size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE) * HUGE_PAGE_SIZE;
+    }
+
+    void *table = mmap(NULL, allocated_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (table == MAP_FAILED) {
+        throw std::string("Unable to allocate pattern database table.");
+    }
+
+#ifdef MADV_HUGEPAGE
+    //Only a hint, the kernel falls back to normal pages.
+    if (this->use_huge_pages) {
+        madvise(table, allocated_size, MADV_HUGEPAGE);
+    }
+#endif
+
+    return (uint8_t *)table;
+#else
+    void *table = calloc(size, 1);
+    if (table == NULL) {
+        throw std::string("Unable to allocate pattern database table.");
+    }
+
+    return (uint8_t *)table;
+#endif
+}
+
+/**
+ * Store a cost read from a database file or generated.
+ * The group is identified by which tiles appear in the hash.
+ *
+ * @param partial_state_hash    get_state_hash_bits() per cell, holding the group's tiles and 0 elsewhere.
+ * @param cost                  The number of moves of group tiles needed to reach the goal.
+ */
+void PatternDatabase::insert(StateHash partial_state_hash, uint8_t cost)
+{
+    uint8_t cell_count = this->board_size * this->board_size;
+    uint8_t bits = get_state_hash_bits(cell_count);
+    uint8_t positions[MAX_CELLS] = {0};
+    uint32_t mask = 0;
+
+    for (uint8_t cell = 0; cell < cell_count; cell++) {
+        uint8_t tile = (partial_state_hash >> (cell * bits)) & ((1 << bits) - 1);
+        if (tile != 0) {
+            positions[tile] = cell;
+            mask |= 1 << tile;
+        }
+    }
+
+    for (Group &group : this->groups) {
+        if (group.mask == mask) {
+            if (group.read_only) {
+                throw std::string("Pattern database group is read only.");
+            }
+
+            uint32_t index = 0;
+            for (uint8_t i = 0; i < group.tiles.size(); i++) {
+                index += positions[group.tiles[i]] * group.multipliers[i];
+            }
+            group.table[index] = cost;
+            return;
+        }
+    }
+
+    throw std::string("Pattern database entry matches no tile group.");
+}
+
+/**
+ * Store a cost by its table index, as computed by get_indices().
+ *
+ * @param group The index of the group.
+ * @param index The table index.
+ * @param cost  The number of moves of group tiles needed to reach the goal.
+ */
+void PatternDatabase::set_entry(uint8_t group, uint32_t index, uint8_t cost)
+{
+    if (group >= this->groups.size() || index >= this->groups[group].size) {
+        throw std::string("No such pattern database entry.");
+    }
+    if (this->groups[group].read_only) {
+        throw std::string("Pattern database group is read only.");
+    }
+
+    this->groups[group].table[index] = cost;
+}
+
+/**
+ * Read a database file into the group it was generated for, in either file format.
+ *
+ * @param path The file to read.
+ */
+void PatternDatabase::load(std::string path)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file.is_open()) {
+        throw std::string("Error: database file doesn't exist.\nMake sure you generate the pattern databases first.");
+    }
+
+    char magic[sizeof(DENSE_DATABASE_MAGIC)];
+    file.read(magic, sizeof(magic));
+    if (file.gcount() == sizeof(magic) && memcmp(magic, DENSE_DATABASE_MAGIC, sizeof(magic)) == 0) {
+        this->load_dense(file, path);
+        return;
+    }
+
+    file.clear();
+    file.seekg(0, std::ios::beg);
+    this->load_sparse(file);
+}
+
+/**
+ * Read the table of a dense file, after its magic.
+ * Tables written in this database's tile order are read straight in, others are reordered entry by entry.
+ */
+void PatternDatabase::load_dense(std::ifstream &file, std::string path)
+{
+    uint8_t header[2];
+    file.read((char *) header, sizeof(header));
+    if (!file || header[0] != this->board_size) {
+        throw std::string("Pattern database file is for a different board size: ") + path;
+    }
+
+    std::vector<uint8_t> file_order(header[1]);
+    file.read((char *) file_order.data(), file_order.size());
+
+    Group *group = this->find_group(file_order);
+    if (group == NULL) {
+        throw std::string("Pattern database file matches no tile group: ") + path;
+    }
+
+    std::vector<uint8_t> table;
+    uint8_t *destination = group->table;
+    if (group->tiles != file_order) {
+        table.resize(group->size);
+        destination = table.data();
+    }
+
+    file.read((char *) destination, group->size);
+    if ((size_t) file.gcount() != group->size) {
+        throw std::string("Pattern database file is truncated: ") + path;
+    }
+
+    if (group->tiles != file_order) {
+        this->reorder_table(*group, file_order, table.data());
+    }
+}
+
+/**
+ * Use the contents of a dense file held in memory, such as one linked into the program.
+ * If it is in the group's tile order the table is used in place and the group becomes read only,
+ * otherwise it is copied in entry by entry.
+ *
+ * @param data  The file contents, which must outlive this object if used in place.
+ * @param size  The size of the file.
+ */
+void PatternDatabase::attach(const uint8_t *data, size_t size)
+{
+    size_t header_size = sizeof(DENSE_DATABASE_MAGIC) + 2;
+    if (size < header_size || memcmp(data, DENSE_DATABASE_MAGIC, sizeof(DENSE_DATABASE_MAGIC)) != 0) {
+        throw std::string("Not a dense pattern database.");
+    }
+    if (data[sizeof(DENSE_DATABASE_MAGIC)] != this->board_size) {
+        throw std::string("Pattern database is for a different board size.");
+    }
+
+    uint8_t tile_count = data[sizeof(DENSE_DATABASE_MAGIC) + 1];
+    if (size < header_size + tile_count) {
+        throw std::string("Pattern database is truncated.");
+    }
+
+    std::vector<uint8_t> order(data + header_size, data + header_size + tile_count);
+    Group *group = this->find_group(order);
+    if (group == NULL) {
+        throw std::string("Pattern database matches no tile group.");
+    }
+
+    const uint8_t *table = data + header_size + tile_count;
+    if (size - header_size - tile_count != group->size) {
+        throw std::string("Pattern database is truncated.");
+    }
+
+    if (group->tiles != order) {
+        this->reorder_table(*group, order, table);
+        return;
+    }
+
+    this->release_table(*group);
+    group->table = (uint8_t *) table;
+    group->read_only = true;
+}
+
+/**
+ * Find the group holding the given tiles.
+ *
+ * @param tiles The tiles, in any order.
+ *
+ * @return The group, NULL if there is none.
+ */
+PatternDatabase::Group *PatternDatabase::find_group(const std::vector<uint8_t> &tiles)
+{
+    uint32_t mask = 0;
+    for (uint8_t tile : tiles) {
+        mask |= 1 << tile;
+    }
+
+    for (Group &group : this->groups) {
+        if (group.mask == mask && group.tiles.size() == tiles.size()) {
+            return &group;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Copy a table written in another tile order into a group, moving every entry to where the group's order puts it.
+ *
+ * @param group The group to fill.
+ * @param order The tile order the table was written in.
+ * @param table The table.
+ */
+void PatternDatabase::reorder_table(Group &group, const std::vector<uint8_t> &order, const uint8_t *table)
+{
+    if (group.read_only) {
+        throw std::string("Pattern database group is read only.");
+    }
+
+    uint8_t cell_count = this->board_size * this->board_size;
+    uint8_t positions[MAX_CELLS] = {0};
+
+    for (size_t table_index = 0; table_index < group.size; table_index++) {
+        size_t remainder = table_index;
+        for (uint8_t tile : order) {
+            positions[tile] = remainder % cell_count;
+            remainder /= cell_count;
+        }
+
+        uint32_t index = 0;
+        for (uint8_t i = 0; i < group.tiles.size(); i++) {
+            index += positions[group.tiles[i]] * group.multipliers[i];
+        }
+        group.table[index] = table[table_index];
+    }
+}
+
+/**
+ * Read the entries of a sparse file.
+ */
+void PatternDatabase::load_sparse(std::ifstream &file)
+{
+    uint64_t hash;
+    uint8_t cost;
+
+    //Loop over the whole file and import each entry.
+    while (file.read((char *) &hash, 8) && file.read((char *) &cost, 1)) {
+        this->insert(hash, cost);
+    }
+}
+
+/**
+ * Write the table of one group to a dense file, recording its tile order.
+ *
+ * @param group The index of the group.
+ * @param path  The file to write.
+ */
+void PatternDatabase::save(uint8_t group, std::string path)
+{
+    if (group >= this->groups.size()) {
+        throw std::string("No such pattern database group.");
+    }
+
+    const Group &saved = this->groups[group];
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::string("Unable to write pattern database file: ") + path;
+    }
+
+    uint8_t header[2] = {this->board_size, (uint8_t) saved.tiles.size()};
+    file.write(DENSE_DATABASE_MAGIC, sizeof(DENSE_DATABASE_MAGIC));
+    file.write((const char *) header, sizeof(header));
+    file.write((const char *) saved.tiles.data(), saved.tiles.size());
+    file.write((const char *) saved.table, saved.size);
+
+    if (!file) {
+        throw std::string("Unable to write pattern database file: ") + path;
+    }
+}
+
+/**
+ * Compute the table index of each group.
+ *
+ * @param positions The cell holding each tile, indexed by tile.
+ * @param indices   Filled with one index per group.
+ */
+void PatternDatabase::get_indices(const uint8_t *positions, uint32_t *indices)
+{
+    for (uint8_t g = 0; g < this->groups.size(); g++) {
+        const Group &group = this->groups[g];
+
+        uint32_t index = 0;
+        for (uint8_t i = 0; i < group.tiles.size(); i++) {
+            index += positions[group.tiles[i]] * group.multipliers[i];
+        }
+        indices[g] = index;
+    }
+}
+
+/**
+ * Start fetching the table entries for the given indices into cache.
+ *
+ * @param indices One index per group, from get_indices.
+ */
+void PatternDatabase::prefetch(const uint32_t *indices)
+{
+    for (uint8_t g = 0; g < this->groups.size(); g++) {
+        __builtin_prefetch(this->groups[g].table + indices[g]);
+    }
+}
+
+/**
+ * Sum the costs of each group.
+ *
+ * @param indices One index per group, from get_indices.
+ *
+ * @return The additive pattern database heuristic.
+ */
+uint8_t PatternDatabase::lookup(const uint32_t *indices)
+{
+    uint8_t cost = 0;
+    for (uint8_t g = 0; g < this->groups.size(); g++) {
+        cost += this->groups[g].table[indices[g]];
+    }
+    return cost;
+}
+
+uint8_t PatternDatabase::get_board_size()
+{
+    return this->board_size;
+}
+
+uint8_t PatternDatabase::get_group_count()
+{
+    return this->groups.size();
+}
+
+/**
+ * @param group The index of the group.
+ *
+ * @return The group's tiles, lowest index digit first.
+ */
+std::vector<uint8_t> PatternDatabase::get_tile_order(uint8_t group)
+{
+    return this->groups[group].tiles;
+}
+
+/**
+ * @return The number of bytes held by the tables.
+ */
+size_t PatternDatabase::get_memory_size()
+{
+    size_t size = 0;
+    for (Group &group : this->groups) {
+        size += group.allocated_size;
+    }
+    return size;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+
+#include "BoardTables.hh"
+
+namespace TaquinSolve
+{
+    //The largest number of tile groups in one set of additive pattern databases.
+    const uint8_t MAX_PATTERN_GROUPS = 4;
+
+    //The standard 4x4 databases: the file each is kept in and its tile group.
+    struct StandardDatabase {
+        const char *file_name;
+        uint32_t group_mask;
+    };
+    const StandardDatabase STANDARD_DATABASES[] = {
+        {"234.db.bin", 0x001C},
+        {"15691013.db.bin", 0x2662},
+        {"7811121415.db.bin", 0xD980}
+    };
+
+    //The standard 5x5 databases, four groups of six tiles around the board.
+    //At about 244MB each they are only ever read from files, never linked into the library.
+    const StandardDatabase STANDARD_DATABASES_5X5[] = {
+        {"123678.db.bin", 0x00001CE},
+        {"459101415.db.bin", 0x000C630},
+        {"111216172122.db.bin", 0x0631800},
+        {"131819202324.db.bin", 0x19C2000}
+    };
+
+    //Starts a dense database file. Can't start a sparse one, where no tile appears twice in the first entry.
+    const char DENSE_DATABASE_MAGIC[8] = {'T', 'Q', 'P', 'D', 'B', '0', '0', '1'};
+
+    /**
+     * A set of additive pattern databases stored as dense tables.
+     * Each group is indexed by the cells its tiles occupy, one base board-cells digit per tile.
+     *
+     * A move changes one tile's digit, so the tiles that move most often are given the lowest digits:
+     * the entries of a board and its children then tend to share cache lines and pages.
+     *
+     * Files are either sparse, a 64 bit partial state hash and a cost per entry (4x4 and smaller only), or dense:
+     * DENSE_DATABASE_MAGIC, the board size, the tile count, the tiles lowest digit first, then the table.
+     */
+    class PatternDatabase
+    {
+        public:
+            PatternDatabase(uint8_t board_size, bool use_huge_pages = false);
+            PatternDatabase(const PatternDatabase&) = delete;
+            ~PatternDatabase();
+            PatternDatabase& operator=(const PatternDatabase&) = delete;
+
+            void add_group(uint32_t group_mask, std::vector<uint8_t> tile_order = std::vector<uint8_t>());
+            void insert(StateHash partial_state_hash, uint8_t cost);
+            void set_entry(uint8_t group, uint32_t index, uint8_t cost);
+            void load(std::string path);
+            void attach(const uint8_t *data, size_t size);
+            void save(uint8_t group, std::string path);
+
+            void get_indices(const uint8_t *positions, uint32_t *indices);
+            void prefetch(const uint32_t *indices);
+            uint8_t lookup(const uint32_t *indices);
+
+            uint8_t get_board_size();
+            uint8_t get_group_count();
+            std::vector<uint8_t> get_tile_order(uint8_t group);
+            size_t get_memory_size();
+
+            static std::vector<uint8_t> get_default_tile_order(uint8_t board_size, uint32_t group_mask);
+
+        protected:
+            struct Group {
+                //Bit t is set for each tile t in the group
+                uint32_t mask;
+
+                //The tiles in the group, lowest index digit first
+                std::vector<uint8_t> tiles;
+
+                //The place value of each tile's cell in the index
+                std::vector<uint32_t> multipliers;
+
+                //Cost for every arrangement of the group's tiles, 0 if unknown
+                uint8_t *table;
+                size_t size;
+                size_t allocated_size;
+
+                //Set if the table is attached memory this object doesn't own
+                bool read_only = false;
+            };
+
+            //The size of the board the databases were built for
+            uint8_t board_size;
+
+            //Whether to back the tables with huge pages
+            bool use_huge_pages;
+
+            std::vector<Group> groups;
+
+            uint8_t *allocate_table(size_t size, size_t &allocated_size);
+            void release_table(Group &group);
+            Group *find_group(const std::vector<uint8_t> &tiles);
+            void reorder_table(Group &group, const std::vector<uint8_t> &order, const uint8_t *table);
+            void load_dense(std::ifstream &file, std::string path);
+            void load_sparse(std::ifstream &file);
+    };
+}
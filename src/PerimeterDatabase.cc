@@ -0,0 +1,128 @@
+#include <queue>
+#include <vector>
+
+#include "PerimeterDatabase.hh"
+
+using namespace TaquinSolve;
+
+/**
+ * Constructor.
+ *
+ * @param board_size    The width/height of the board.
+ * @param radius        The number of moves from the goal to store.
+ */
+PerimeterDatabase::PerimeterDatabase(uint8_t board_size, uint8_t radius)
+    : board_size(board_size), radius(radius)
+{
+}
+
+/**
+ * Fill the database with a breadth-first search outwards from the goal.
+ * Moves are reversible, so the depth a state is first found at is its exact distance to the goal.
+ */
+void PerimeterDatabase::generate()
+{
+    this->distances.clear();
+
+    //Build the standard goal state
+    uint8_t len = this->board_size * this->board_size;
+    std::vector<uint8_t> goal_board;
+    for (uint8_t i = 1; i < len; i++) {
+        goal_board.push_back(i);
+    }
+    goal_board.push_back(0);
+
+    std::queue<std::shared_ptr<Board> > frontier;
+
+    std::shared_ptr<Board> initial_board = std::shared_ptr<Board>(new Board(goal_board, this->board_size));
+    this->distances.insert(std::pair<StateHash, uint8_t>(initial_board->get_state_hash(), 0));
+    frontier.push(initial_board);
+
+    while (!frontier.empty()) {
+        std::shared_ptr<Board> current = frontier.front();
+        frontier.pop();
+
+        //Don't expand beyond the radius
+        if (current->get_cost() >= this->radius) {
+            continue;
+        }
+
+        for (Moves move : current->get_available_moves()) {
+            std::shared_ptr<Board> neighbor = std::shared_ptr<Board>(current->perform_move(move));
+            StateHash neighbor_hash = neighbor->get_state_hash();
+
+            if (this->distances.find(neighbor_hash) == this->distances.end()) {
+                this->distances.insert(std::pair<StateHash, uint8_t>(neighbor_hash, neighbor->get_cost()));
+                frontier.push(neighbor);
+            }
+        }
+    }
+}
+
+/**
+ * Find the exact distance to the goal of the given state.
+ *
+ * @param state_hash    The full state hash of the board.
+ * @param distance      Set to the distance if the state is within the perimeter.
+ *
+ * @return True if the state is within the perimeter.
+ */
+bool PerimeterDatabase::lookup(StateHash state_hash, uint8_t &distance)
+{
+    std::unordered_map<StateHash, uint8_t, StateHashHasher>::iterator it = this->distances.find(state_hash);
+    if (it == this->distances.end()) {
+        return false;
+    }
+
+    distance = it->second;
+    return true;
+}
+
+/**
+ * Walk a board within the perimeter down to the goal.
+ * At each step a neighbor one move closer is guaranteed to exist.
+ *
+ * @param board A board state within the perimeter.
+ *
+ * @return The solved board, with the remaining moves appended to its history.
+ */
+std::shared_ptr<Board> PerimeterDatabase::complete_path(std::shared_ptr<Board> board)
+{
+    uint8_t distance;
+    if (!this->lookup(board->get_state_hash(), distance)) {
+        throw std::string("Board state is outside the perimeter.");
+    }
+
+    while (distance > 0) {
+        for (Moves move : board->get_available_moves()) {
+            std::shared_ptr<Board> neighbor = std::shared_ptr<Board>(board->perform_move(move));
+            uint8_t neighbor_distance;
+
+            if (this->lookup(neighbor->get_state_hash(), neighbor_distance) && neighbor_distance < distance) {
+                board = neighbor;
+                distance = neighbor_distance;
+                break;
+            }
+        }
+    }
+
+    return board;
+}
+
+uint8_t PerimeterDatabase::get_board_size()
+{
+    return this->board_size;
+}
+
+uint8_t PerimeterDatabase::get_radius()
+{
+    return this->radius;
+}
+
+/**
+ * @return The number of states stored.
+ */
+size_t PerimeterDatabase::size()
+{
+    return this->distances.size();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+
+#include "Board.hh"
+
+namespace TaquinSolve
+{
+    /**
+     * Exact distances for every board state within a given radius of the goal.
+     * Used by the search as a perfect heuristic and as an early stop condition.
+     */
+    class PerimeterDatabase
+    {
+        public:
+            PerimeterDatabase(uint8_t board_size, uint8_t radius);
+
+            void generate();
+
+            bool lookup(StateHash state_hash, uint8_t &distance);
+            std::shared_ptr<Board> complete_path(std::shared_ptr<Board> board);
+
+            uint8_t get_board_size();
+            uint8_t get_radius();
+            size_t size();
+
+        protected:
+            //The size of the board this perimeter surrounds the goal of
+            uint8_t board_size;
+
+            //The maximum distance from the goal stored
+            uint8_t radius;
+
+            //Distance to the goal keyed by full state hash
+            std::unordered_map<StateHash, uint8_t, StateHashHasher> distances;
+    };
+}
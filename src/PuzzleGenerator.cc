@@ -0,0 +1,385 @@
+#include <string>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include "PuzzleGenerator.hh"
+#include "IDASolver.hh"
+
+using namespace TaquinSolve;
+
+//Boards generated per independently seeded chunk of a batch.
+static const size_t BATCH_CHUNK_SIZE = 4096;
+
+/**
+ * Constructor.
+ *
+ * @param board_size        The width/height of the boards to generate (2-5).
+ * @param seed              Seeds the generator, the same seed gives the same boards.
+ * @param pattern_database  Used to judge difficulty by heuristic, if given.
+ */
+PuzzleGenerator::PuzzleGenerator(uint8_t board_size, uint64_t seed, std::shared_ptr<PatternDatabase> pattern_database)
+    : board_size(board_size), tables(get_board_tables(board_size)), rng(seed), pattern_database(pattern_database)
+{
+    if (this->tables == NULL) {
+        throw std::string("Board size invalid.\nThis library only supports board sizes 2-5.");
+    }
+}
+
+/**
+ * Generate a board uniformly at random from all solvable boards.
+ *
+ * @return The board state.
+ */
+std::vector<uint8_t> PuzzleGenerator::generate()
+{
+    std::vector<uint8_t> board(this->tables->cell_count);
+    this->generate_into(board.data());
+    return board;
+}
+
+/**
+ * Generate a board uniformly at random from all solvable boards.
+ * The digits of a uniform rank are drawn directly and unranked as they are drawn.
+ * Each digit counts the inversions its tile makes, so the parity comes for free.
+ * If the board is unsolvable tiles 1 and 2 are swapped, which pairs every unsolvable
+ * board with exactly one solvable board, so the result stays uniform.
+ *
+ * @param tiles Filled with board_size^2 tiles.
+ */
+void PuzzleGenerator::generate_into(uint8_t *tiles)
+{
+    uint8_t cell_count = this->tables->cell_count;
+
+    //The tiles not placed yet in ascending order, one per nibble.
+    //Boards of more than 16 cells keep them as a bitmask instead.
+    uint64_t unused = 0xFEDCBA9876543210ull;
+    uint32_t unused_mask = cell_count < 32 ? (1u << cell_count) - 1 : UINT32_MAX;
+
+    uint32_t inversion_count = 0;
+    uint8_t zero_position = 0;
+
+    for (uint8_t cell = 0; cell < cell_count; cell++) {
+        uint8_t remaining = cell_count - cell;
+
+        uint8_t digit = this->next_random(remaining);
+
+        uint8_t tile;
+        if (cell_count <= 16) {
+            //Take the digit'th nibble and close the gap
+            uint8_t shift = digit * 4;
+            tile = (unused >> shift) & 0xF;
+            uint64_t below = unused & ((1ull << shift) - 1);
+            unused = below | ((unused >> shift >> 4) << shift);
+        } else {
+            //Take the digit'th smallest unused tile
+            uint32_t remaining = unused_mask;
+            for (uint8_t i = 0; i < digit; i++) {
+                remaining &= remaining - 1;
+            }
+            tile = __builtin_ctz(remaining);
+            unused_mask &= ~(1u << tile);
+        }
+
+        tiles[cell] = tile;
+        inversion_count += digit;
+        if (tile == 0) {
+            zero_position = cell;
+        }
+    }
+
+    //Inversions with the empty tile don't count towards solvability
+    inversion_count -= zero_position;
+
+    bool solvable;
+    if (this->board_size % 2 == 0 && (zero_position / this->board_size) % 2 == 0) {
+        solvable = inversion_count % 2 == 1;
+    } else {
+        solvable = inversion_count % 2 == 0;
+    }
+
+    if (!solvable) {
+        uint8_t *one = std::find(tiles, tiles + cell_count, 1);
+        uint8_t *two = std::find(tiles, tiles + cell_count, 2);
+        std::iter_swap(one, two);
+    }
+}
+
+/**
+ * Draw a number uniformly from [0, range).
+ * Each 64 bit draw of the generator is split into two 32 bit halves, and the range is applied
+ * by multiplying and keeping the high half, rejecting the rare draws that would bias the result.
+ *
+ * @param range The number of possible results.
+ *
+ * @return The number.
+ */
+uint32_t PuzzleGenerator::next_random(uint32_t range)
+{
+    while (true) {
+        uint32_t bits;
+        if (this->has_spare_bits) {
+            bits = this->spare_bits;
+            this->has_spare_bits = false;
+        } else {
+            uint64_t draw = this->rng();
+            bits = draw;
+            this->spare_bits = draw >> 32;
+            this->has_spare_bits = true;
+        }
+
+        uint64_t product = (uint64_t) bits * range;
+        uint32_t low = product;
+
+        //Only draws below 2^32 mod range are biased, and that is checked only when it might be
+        if (low >= range || low >= (uint32_t) -range % range) {
+            return product >> 32;
+        }
+    }
+}
+
+/**
+ * Generate a board by walking the empty tile randomly back from the goal.
+ *
+ * @param length The number of moves to walk, an upper bound on the distance to the goal.
+ *
+ * @return The board state.
+ */
+std::vector<uint8_t> PuzzleGenerator::generate_walk(uint32_t length)
+{
+    std::vector<uint8_t> board(this->tables->cell_count);
+    this->generate_walk_into(board.data(), length);
+    return board;
+}
+
+/**
+ * Generate a board by walking the empty tile randomly back from the goal.
+ * The walk never immediately undoes its last move.
+ *
+ * @param tiles     Filled with board_size^2 tiles.
+ * @param length    The number of moves to walk, an upper bound on the distance to the goal.
+ */
+void PuzzleGenerator::generate_walk_into(uint8_t *tiles, uint32_t length)
+{
+    uint8_t cell_count = this->tables->cell_count;
+    for (uint8_t cell = 0; cell < cell_count - 1; cell++) {
+        tiles[cell] = cell + 1;
+    }
+    tiles[cell_count - 1] = 0;
+
+    uint8_t zero_position = cell_count - 1;
+    int8_t last_move = -1;
+
+    for (uint32_t step = 0; step < length; step++) {
+        const Moves *moves = this->tables->moves[zero_position];
+        uint8_t move_count = this->tables->move_count[zero_position];
+
+        //UP/DOWN and LEFT/RIGHT are adjacent, so a move's inverse differs in the lowest bit
+        Moves move;
+        do {
+            move = moves[this->next_random(move_count)];
+        } while (move == (last_move ^ 1));
+
+        uint8_t new_zero_position = this->tables->neighbours[zero_position][move];
+        tiles[zero_position] = tiles[new_zero_position];
+        tiles[new_zero_position] = 0;
+        zero_position = new_zero_position;
+        last_move = move;
+    }
+}
+
+/**
+ * Generate a board whose difficulty falls within the given band.
+ * Candidates come from random walks of varying length, which reach both short and
+ * long distances, and are rejected until one falls within the band.
+ *
+ * @param minimum       The lowest difficulty accepted.
+ * @param maximum       The highest difficulty accepted.
+ * @param measure       How difficulty is judged.
+ * @param max_attempts  The number of candidates to try before giving up.
+ *
+ * @return The board state.
+ */
+std::vector<uint8_t> PuzzleGenerator::generate_in_band(uint8_t minimum, uint8_t maximum, DifficultyMeasure measure, uint32_t max_attempts)
+{
+    if (minimum > maximum) {
+        throw std::string("Difficulty band is empty.");
+    }
+
+    //Walks longer than twice the maximum rarely end close enough to the goal
+    std::uniform_int_distribution<uint32_t> lengths(minimum, std::max(2 * maximum, 1));
+    std::vector<uint8_t> board(this->tables->cell_count);
+
+    for (uint32_t attempt = 0; attempt < max_attempts; attempt++) {
+        //Mix in uniform boards for bands around the typical distance
+        if (attempt % 2 == 1) {
+            this->generate_into(board.data());
+        } else {
+            this->generate_walk_into(board.data(), lengths(this->rng));
+        }
+
+        //Cheap reject first, the heuristic never exceeds the solution length
+        uint8_t difficulty = this->measure_difficulty(board, DifficultyMeasure::HEURISTIC);
+        if (difficulty > maximum) {
+            continue;
+        }
+
+        if (measure == DifficultyMeasure::SOLUTION_LENGTH) {
+            difficulty = this->measure_difficulty(board, measure);
+        }
+
+        if (difficulty >= minimum && difficulty <= maximum) {
+            return board;
+        }
+    }
+
+    throw std::string("Unable to generate a board in the difficulty band ") + std::to_string(minimum) + "-" + std::to_string(maximum) + ".";
+}
+
+/**
+ * Judge the difficulty of a board.
+ *
+ * @param board     The board state.
+ * @param measure   How difficulty is judged.
+ *
+ * @return The difficulty.
+ */
+uint8_t PuzzleGenerator::measure_difficulty(const std::vector<uint8_t> &board, DifficultyMeasure measure)
+{
+    if (measure == DifficultyMeasure::HEURISTIC) {
+        std::shared_ptr<PatternDatabase> pattern_database = this->pattern_database;
+        if (pattern_database != NULL && pattern_database->get_board_size() != this->board_size) {
+            pattern_database = NULL;
+        }
+        return Board(board, this->board_size, pattern_database).get_heuristic();
+    }
+
+    if (this->solver == NULL) {
+        this->solver = std::shared_ptr<IDASolver>(new IDASolver());
+    }
+
+    MoveSequence solution;
+    this->solver->solve_into(board, this->board_size, solution);
+    return solution.size();
+}
+
+/**
+ * @return The number of arrangements of a board, (board_size^2)!.
+ *         Only boards up to 4x4 have a count that fits in 64 bits.
+ */
+uint64_t PuzzleGenerator::get_permutation_count(uint8_t board_size)
+{
+    if (board_size > 4) {
+        throw std::string("Permutation ranks only support board sizes 2-4.");
+    }
+
+    uint64_t count = 1;
+    for (uint8_t i = 2; i <= board_size * board_size; i++) {
+        count *= i;
+    }
+    return count;
+}
+
+/**
+ * Find the arrangement with the given lexicographic rank.
+ *
+ * @param rank          The rank, less than get_permutation_count().
+ * @param board_size    The width/height of the board.
+ * @param tiles         Filled with board_size^2 tiles.
+ */
+void PuzzleGenerator::unrank(uint64_t rank, uint8_t board_size, uint8_t *tiles)
+{
+    uint8_t cell_count = board_size * board_size;
+    uint64_t factorial = PuzzleGenerator::get_permutation_count(board_size);
+
+    //Tiles not placed yet, as a bitmask
+    uint32_t unused = (1u << cell_count) - 1;
+
+    for (uint8_t cell = 0; cell < cell_count; cell++) {
+        factorial /= cell_count - cell;
+        uint8_t digit = rank / factorial;
+        rank %= factorial;
+
+        //Take the digit'th smallest unused tile
+        uint32_t remaining = unused;
+        for (uint8_t i = 0; i < digit; i++) {
+            remaining &= remaining - 1;
+        }
+        uint8_t tile = __builtin_ctz(remaining);
+
+        tiles[cell] = tile;
+        unused &= ~(1u << tile);
+    }
+}
+
+/**
+ * Find the lexicographic rank of an arrangement.
+ *
+ * @param tiles         The board state, a permutation of 0..board_size^2-1.
+ * @param board_size    The width/height of the board.
+ *
+ * @return The rank.
+ */
+uint64_t PuzzleGenerator::rank(const uint8_t *tiles, uint8_t board_size)
+{
+    if (board_size > 4) {
+        throw std::string("Permutation ranks only support board sizes 2-4.");
+    }
+
+    uint8_t cell_count = board_size * board_size;
+    uint32_t unused = (1u << cell_count) - 1;
+    uint64_t rank = 0;
+
+    for (uint8_t cell = 0; cell < cell_count; cell++) {
+        //Count the unused tiles smaller than this one
+        uint8_t digit = __builtin_popcount(unused & ((1u << tiles[cell]) - 1));
+        rank = rank * (cell_count - cell) + digit;
+        unused &= ~(1u << tiles[cell]);
+    }
+
+    return rank;
+}
+
+/**
+ * Generate many uniform boards across several threads.
+ * The output is split into chunks seeded from the seed and chunk index,
+ * so it is the same whatever the number of threads.
+ *
+ * @param board_size    The width/height of the boards (2-5).
+ * @param seed          Seeds the batch.
+ * @param count         The number of boards.
+ * @param tiles         Filled with count * board_size^2 tiles.
+ * @param thread_count  The number of threads to generate with.
+ */
+void PuzzleGenerator::generate_batch(uint8_t board_size, uint64_t seed, size_t count, uint8_t *tiles, uint32_t thread_count)
+{
+    uint8_t cell_count = board_size * board_size;
+    size_t chunk_count = (count + BATCH_CHUNK_SIZE - 1) / BATCH_CHUNK_SIZE;
+    std::atomic<size_t> next_chunk(0);
+
+    //Check the size before starting any threads
+    PuzzleGenerator check(board_size, seed);
+
+    auto worker = [&]() {
+        size_t chunk;
+        while ((chunk = next_chunk++) < chunk_count) {
+            std::seed_seq chunk_seed = {(uint32_t) seed, (uint32_t) (seed >> 32), (uint32_t) chunk, (uint32_t) (chunk >> 32)};
+            std::mt19937_64 chunk_rng(chunk_seed);
+            PuzzleGenerator generator(board_size, chunk_rng());
+
+            size_t end = std::min(count, (chunk + 1) * BATCH_CHUNK_SIZE);
+            for (size_t i = chunk * BATCH_CHUNK_SIZE; i < end; i++) {
+                generator.generate_into(tiles + i * cell_count);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 1; t < thread_count; t++) {
+        threads.push_back(std::thread(worker));
+    }
+    worker();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
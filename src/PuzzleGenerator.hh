@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <random>
+#include <cstdint>
+
+#include "taquinsolve.hh"
+#include "BoardTables.hh"
+#include "PatternDatabase.hh"
+
+namespace TaquinSolve
+{
+    class IDASolver;
+
+    /**
+     * How the difficulty of a generated board is judged.
+     */
+    enum class DifficultyMeasure
+    {
+        //The heuristic estimate, cheap but only a lower bound
+        HEURISTIC,
+
+        //The optimal solution length, exact but needs a full solve
+        SOLUTION_LENGTH
+    };
+
+    /**
+     * Generates solvable boards from its own seeded random number generator.
+     * Each generator is independent, so use one per thread.
+     */
+    class PuzzleGenerator
+    {
+        public:
+            PuzzleGenerator(uint8_t board_size, uint64_t seed, std::shared_ptr<PatternDatabase> pattern_database = NULL);
+
+            //Uniform over all solvable boards
+            std::vector<uint8_t> generate();
+            void generate_into(uint8_t *tiles);
+
+            //Backwards from the goal
+            std::vector<uint8_t> generate_walk(uint32_t length);
+            void generate_walk_into(uint8_t *tiles, uint32_t length);
+
+            //Within a difficulty band
+            std::vector<uint8_t> generate_in_band(
+                uint8_t minimum,
+                uint8_t maximum,
+                DifficultyMeasure measure = DifficultyMeasure::HEURISTIC,
+                uint32_t max_attempts = 100000
+            );
+            uint8_t measure_difficulty(const std::vector<uint8_t> &board, DifficultyMeasure measure);
+
+            static uint64_t get_permutation_count(uint8_t board_size);
+            static void unrank(uint64_t rank, uint8_t board_size, uint8_t *tiles);
+            static uint64_t rank(const uint8_t *tiles, uint8_t board_size);
+
+            static void generate_batch(
+                uint8_t board_size,
+                uint64_t seed,
+                size_t count,
+                uint8_t *tiles,
+                uint32_t thread_count = 1
+            );
+
+        protected:
+            uint8_t board_size;
+            const BoardTables *tables;
+            std::mt19937_64 rng;
+
+            //The unused half of the last draw from rng
+            uint32_t spare_bits = 0;
+            bool has_spare_bits = false;
+
+            //Used to judge difficulty, created on first use
+            std::shared_ptr<PatternDatabase> pattern_database;
+            std::shared_ptr<IDASolver> solver;
+
+            uint32_t next_random(uint32_t range);
+    };
+}
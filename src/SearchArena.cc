@@ -0,0 +1,148 @@
+#include <algorithm>
+
+#include "SearchArena.hh"
+
+using namespace TaquinSolve;
+
+/**
+ * Get the arena of the calling thread.
+ *
+ * @return The arena, created on first use.
+ */
+SearchArena &SearchArena::get_thread_arena()
+{
+    static thread_local SearchArena arena;
+    return arena;
+}
+
+/**
+ * Allocate memory, from the free list of its size class if anything has been released there.
+ *
+ * @param size The number of bytes needed.
+ *
+ * @return Memory aligned on ALIGNMENT bytes.
+ */
+void *SearchArena::allocate(size_t size)
+{
+    size_t size_class = std::max((size_t) 1, (size + ALIGNMENT - 1) / ALIGNMENT);
+
+    if (size > MAX_POOLED_SIZE) {
+        this->bytes_in_use += size;
+        this->high_water_mark = std::max(this->high_water_mark, this->bytes_in_use);
+        return ::operator new(size);
+    }
+
+    this->bytes_in_use += size_class * ALIGNMENT;
+    this->high_water_mark = std::max(this->high_water_mark, this->bytes_in_use);
+
+    FreeNode *node = this->free_lists[size_class];
+    if (node != NULL) {
+        this->free_lists[size_class] = node->next;
+        return node;
+    }
+
+    return this->carve(size_class * ALIGNMENT);
+}
+
+/**
+ * Release memory to the free list of its size class.
+ *
+ * @param pointer   The memory, as returned by allocate().
+ * @param size      The size it was allocated with.
+ */
+void SearchArena::deallocate(void *pointer, size_t size)
+{
+    if (size > MAX_POOLED_SIZE) {
+        this->bytes_in_use -= size;
+        ::operator delete(pointer);
+        return;
+    }
+
+    size_t size_class = std::max((size_t) 1, (size + ALIGNMENT - 1) / ALIGNMENT);
+    this->bytes_in_use -= size_class * ALIGNMENT;
+
+    FreeNode *node = (FreeNode *) pointer;
+    node->next = this->free_lists[size_class];
+    this->free_lists[size_class] = node;
+}
+
+/**
+ * Take fresh memory from the current block, moving on to the next block when it is full.
+ */
+void *SearchArena::carve(size_t size)
+{
+    if (this->block_offset + size > BLOCK_SIZE) {
+        if (this->next_block == this->blocks.size()) {
+            this->blocks.push_back(std::unique_ptr<uint8_t[]>(new uint8_t[BLOCK_SIZE]));
+        }
+        this->block = this->blocks[this->next_block++].get();
+        this->block_offset = 0;
+    }
+
+    void *pointer = this->block + this->block_offset;
+    this->block_offset += size;
+    return pointer;
+}
+
+/**
+ * Release everything at once.
+ * Only safe once nothing allocated from the arena is in use.
+ */
+void SearchArena::reset()
+{
+    std::fill(std::begin(this->free_lists), std::end(this->free_lists), (FreeNode *) NULL);
+
+    if (this->blocks.size() > RETAINED_BLOCKS) {
+        this->blocks.resize(RETAINED_BLOCKS);
+    }
+
+    this->next_block = 0;
+    this->block = NULL;
+    this->block_offset = BLOCK_SIZE;
+    this->bytes_in_use = 0;
+    this->high_water_mark = 0;
+}
+
+/**
+ * Start a search, resetting the high-water mark if it is the outermost one.
+ */
+void SearchArena::enter_scope()
+{
+    if (this->scope_depth++ == 0) {
+        this->high_water_mark = this->bytes_in_use;
+    }
+}
+
+/**
+ * End a search, resetting the arena if it was the outermost one and nothing is still in use.
+ */
+void SearchArena::leave_scope()
+{
+    if (--this->scope_depth == 0 && this->bytes_in_use == 0) {
+        this->reset();
+    }
+}
+
+/**
+ * @return The number of bytes currently allocated.
+ */
+size_t SearchArena::get_bytes_in_use()
+{
+    return this->bytes_in_use;
+}
+
+/**
+ * @return The most bytes allocated at once since the outermost scope started.
+ */
+size_t SearchArena::get_high_water_mark()
+{
+    return this->high_water_mark;
+}
+
+/**
+ * @return The bytes held in blocks, used or not.
+ */
+size_t SearchArena::get_reserved_bytes()
+{
+    return this->blocks.size() * BLOCK_SIZE;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace TaquinSolve
+{
+    /**
+     * Scratch memory for searches, one per thread.
+     *
+     * Small allocations are carved out of large blocks and recycled through a free list per size class,
+     * so a depth-first search reuses the same few nodes instead of going through the heap. reset()
+     * releases everything at once and keeps the blocks for the next search on the thread.
+     * Not thread safe, memory must be released on the thread that allocated it.
+     */
+    class SearchArena
+    {
+        public:
+            //Allocations are rounded up to and aligned on this many bytes
+            static const size_t ALIGNMENT = 16;
+
+            //Allocations larger than this go to the heap
+            static const size_t MAX_POOLED_SIZE = 512;
+
+            static const size_t BLOCK_SIZE = 1 << 20;
+
+            //Blocks kept by reset(), any beyond these are freed
+            static const size_t RETAINED_BLOCKS = 64;
+
+            SearchArena() = default;
+            SearchArena(const SearchArena&) = delete;
+            SearchArena& operator=(const SearchArena&) = delete;
+
+            void *allocate(size_t size);
+            void deallocate(void *pointer, size_t size);
+            void reset();
+
+            void enter_scope();
+            void leave_scope();
+
+            size_t get_bytes_in_use();
+            size_t get_high_water_mark();
+            size_t get_reserved_bytes();
+
+            static SearchArena &get_thread_arena();
+
+        protected:
+            struct FreeNode
+            {
+                FreeNode *next;
+            };
+
+            std::vector<std::unique_ptr<uint8_t[]>> blocks;
+
+            //The block being carved, how much of it is used and the index of the block after it
+            uint8_t *block = NULL;
+            size_t block_offset = BLOCK_SIZE;
+            size_t next_block = 0;
+
+            FreeNode *free_lists[MAX_POOLED_SIZE / ALIGNMENT + 1] = {NULL};
+
+            size_t bytes_in_use = 0;
+            size_t high_water_mark = 0;
+
+            //Nesting depth of ArenaScopes
+            uint32_t scope_depth = 0;
+
+            void *carve(size_t size);
+    };
+
+    /**
+     * Marks the lifetime of a search.
+     * The thread's arena is reset when the outermost scope ends, if everything allocated in it has been released.
+     */
+    class ArenaScope
+    {
+        public:
+            ArenaScope(SearchArena &arena = SearchArena::get_thread_arena()) : arena(arena)
+            {
+                this->arena.enter_scope();
+            }
+
+            ~ArenaScope()
+            {
+                this->arena.leave_scope();
+            }
+
+            ArenaScope(const ArenaScope&) = delete;
+            ArenaScope& operator=(const ArenaScope&) = delete;
+
+        protected:
+            SearchArena &arena;
+    };
+
+    /**
+     * A standard allocator drawing from the calling thread's SearchArena.
+     * Stateless, so containers using it can be moved and swapped freely between solves on the same thread.
+     */
+    template<typename T>
+    class ArenaAllocator
+    {
+        public:
+            typedef T value_type;
+
+            ArenaAllocator() = default;
+
+            template<typename U>
+            ArenaAllocator(const ArenaAllocator<U> &) {}
+
+            T *allocate(size_t count)
+            {
+                if (alignof(T) > SearchArena::ALIGNMENT) {
+                    return (T *) ::operator new(count * sizeof(T));
+                }
+                return (T *) SearchArena::get_thread_arena().allocate(count * sizeof(T));
+            }
+
+            void deallocate(T *pointer, size_t count)
+            {
+                if (alignof(T) > SearchArena::ALIGNMENT) {
+                    ::operator delete(pointer);
+                    return;
+                }
+                SearchArena::get_thread_arena().deallocate(pointer, count * sizeof(T));
+            }
+
+            //Lets classes with protected constructors befriend the allocator for allocate_shared
+            template<typename U, typename... Args>
+            void construct(U *pointer, Args&&... args)
+            {
+                ::new((void *) pointer) U(std::forward<Args>(args)...);
+            }
+
+            template<typename U>
+            bool operator==(const ArenaAllocator<U> &) const { return true; }
+
+            template<typename U>
+            bool operator!=(const ArenaAllocator<U> &) const { return false; }
+    };
+}
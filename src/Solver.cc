@@ -1,65 +1,406 @@
-#include <fstream>
 #include <iostream>
+#include <mutex>
+#include <future>
+#include <map>
+#include <chrono>
+#include <experimental/filesystem>
 
 #include "Solver.hh"
+#include "EmbeddedDatabases.hh"
 
 using namespace TaquinSolve;
 
+/**
+ * The pattern databases of this process, shared by every solver using them.
+ * Indexed by board size and whether the tables use huge pages.
+ */
+struct PatternDatabaseCache
+{
+    std::mutex mutex;
+
+    //Loaded by a solver, released once no solver holds them
+    std::weak_ptr<PatternDatabase> loaded[MAX_BOARD_SIZE + 1][2];
+
+    //Loading or loaded in the background, holding the result once done
+    std::shared_future<std::shared_ptr<PatternDatabase>> loading[MAX_BOARD_SIZE + 1][2];
+};
+
+/**
+ * A function local static, so it is ready even if the library is warmed up from a static initialiser.
+ */
+static PatternDatabaseCache &get_pattern_database_cache()
+{
+    static PatternDatabaseCache cache;
+    return cache;
+}
+
+/**
+ * The goal perimeters of this process, built once per board size and radius and kept for its life.
+ * Each is built by the first solver asking for it, others wait on the result.
+ */
+struct PerimeterDatabaseCache
+{
+    std::mutex mutex;
+    std::map<std::pair<uint8_t, uint8_t>, std::shared_future<std::shared_ptr<PerimeterDatabase>>> built;
+};
+
+static PerimeterDatabaseCache &get_perimeter_database_cache()
+{
+    static PerimeterDatabaseCache cache;
+    return cache;
+}
+
 /**
  * Constructor.
- * Checks that the pattern databases exist and loads them.
+ *
+ * @param options Tunable parameters for the solver.
+ */
+Solver::Solver(SolverOptions options) : options(options)
+{
+}
+
+/**
+ * Solve the given board state.
+ *
+ * @param board         The board state.
+ * @param board_size    The width/height of the board.
+ * @param stats         If given, filled with a description of the work done.
+ *
+ * @return  A queue structure representing moves taken to reach the solution.
+ */
+std::queue<Moves> Solver::solve(std::vector<uint8_t> board, uint8_t board_size, SolveStats *stats)
+{
+    MoveSequence solution;
+    this->solve_into(board, board_size, solution, stats);
+    return solution.to_queue();
+}
+
+/**
+ * Fetch the statistics of the most recent solve.
+ *
+ * @return The solve statistics.
+ */
+SolveStats Solver::get_stats()
+{
+    return this->stats;
+}
+
+/**
+ * The standard databases for a board size.
+ *
+ * @param board_size    The width/height of the board.
+ * @param count         Set to the number of databases.
+ *
+ * @return The databases, NULL if the board size has none.
+ */
+static const StandardDatabase *get_standard_databases(uint8_t board_size, size_t &count)
+{
+    switch (board_size) {
+        case 4:
+            count = sizeof(STANDARD_DATABASES) / sizeof(StandardDatabase);
+            return STANDARD_DATABASES;
+        case 5:
+            count = sizeof(STANDARD_DATABASES_5X5) / sizeof(StandardDatabase);
+            return STANDARD_DATABASES_5X5;
+        default:
+            count = 0;
+            return NULL;
+    }
+}
+
+/**
+ * Read the standard pattern databases for a board size.
+ * Installed files take precedence over the copies linked into the library, if it was built with them.
+ *
+ * @param board_size        The width/height of the board, 4 or 5.
+ * @param use_huge_pages    Whether to back the tables with huge pages.
+ *
+ * @return The loaded databases.
+ */
+static std::shared_ptr<PatternDatabase> read_standard_pattern_databases(uint8_t board_size, bool use_huge_pages)
+{
+    std::shared_ptr<PatternDatabase> pattern_database = std::shared_ptr<PatternDatabase>(new PatternDatabase(board_size, use_huge_pages));
+
+    //Tile groups {2,3,4}, {1,5,6,9,10,13} and {7,8,11,12,14,15} on 4x4, four groups of six on 5x5.
+    size_t count;
+    const StandardDatabase *databases = get_standard_databases(board_size, count);
+    for (size_t i = 0; i < count; i++) {
+        pattern_database->add_group(databases[i].group_mask);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        std::string path = std::string(STANDARD_DATABASE_DIRECTORY) + "/" + databases[i].file_name;
+
+        const uint8_t *data;
+        size_t size;
+        if (!std::experimental::filesystem::exists(path) && EmbeddedDatabases::find(databases[i].file_name, data, size)) {
+            pattern_database->attach(data, size);
+        } else {
+            pattern_database->load(path);
+        }
+    }
+
+    return pattern_database;
+}
+
+/**
+ * Check whether the standard pattern databases for a board size can be loaded.
+ * The 4x4 databases are required, so they are always expected and a missing file is reported when loading.
+ * The 5x5 databases are optional, 5x5 boards are searched without them unless every file is installed.
+ *
+ * @param board_size The width/height of the board.
+ *
+ * @return True if the databases are used for the board size.
+ */
+bool Solver::check_pattern_databases_available(uint8_t board_size)
+{
+    if (board_size == 4) {
+        return true;
+    }
+
+    size_t count;
+    const StandardDatabase *databases = get_standard_databases(board_size, count);
+    for (size_t i = 0; i < count; i++) {
+        if (!std::experimental::filesystem::exists(std::string(STANDARD_DATABASE_DIRECTORY) + "/" + databases[i].file_name)) {
+            return false;
+        }
+    }
+
+    return count > 0;
+}
+
+/**
+ * Start reading the pattern databases on another thread, unless they are loaded or already loading.
+ * Databases loaded this way stay resident for the life of the process.
+ *
+ * @param use_huge_pages    Whether to back the tables with huge pages.
+ * @param board_size        The board size to load the databases of, 4 or 5.
+ */
+void Solver::start_pattern_database_load(bool use_huge_pages, uint8_t board_size)
+{
+    if (!Solver::check_pattern_databases_available(board_size)) {
+        return;
+    }
+
+    PatternDatabaseCache &cache = get_pattern_database_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+
+    if (cache.loaded[board_size][use_huge_pages].lock() != NULL || cache.loading[board_size][use_huge_pages].valid()) {
+        return;
+    }
+
+    cache.loading[board_size][use_huge_pages] = std::async(std::launch::async, read_standard_pattern_databases, board_size, use_huge_pages).share();
+}
+
+/**
+ * Wait for a load started by start_pattern_database_load() to finish.
+ *
+ * @param use_huge_pages    Which load to wait for.
+ * @param board_size        The board size the load is for.
+ */
+void Solver::wait_for_pattern_database_load(bool use_huge_pages, uint8_t board_size)
+{
+    if (board_size > MAX_BOARD_SIZE) {
+        return;
+    }
+
+    std::shared_future<std::shared_ptr<PatternDatabase>> loading;
+    {
+        PatternDatabaseCache &cache = get_pattern_database_cache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        loading = cache.loading[board_size][use_huge_pages];
+    }
+
+    if (loading.valid()) {
+        loading.wait();
+    }
+}
+
+/**
+ * Get the pattern databases if they are already loaded, without loading them or waiting on a load.
+ *
+ * @param use_huge_pages    Which copy to get.
+ * @param board_size        The board size the databases are for.
+ *
+ * @return The databases, NULL if they aren't loaded.
  */
-Solver::Solver()
+std::shared_ptr<PatternDatabase> Solver::get_loaded_pattern_database(bool use_huge_pages, uint8_t board_size)
 {
+    if (board_size > MAX_BOARD_SIZE) {
+        return NULL;
+    }
+
+    PatternDatabaseCache &cache = get_pattern_database_cache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+
+    std::shared_ptr<PatternDatabase> pattern_database = cache.loaded[board_size][use_huge_pages].lock();
+    if (pattern_database != NULL) {
+        return pattern_database;
+    }
+
+    std::shared_future<std::shared_ptr<PatternDatabase>> &loading = cache.loading[board_size][use_huge_pages];
+    if (loading.valid() && loading.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        try {
+            return loading.get();
+        } catch (...) {
+            return NULL;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @param board_size The width/height of the board being solved.
+ *
+ * @return True if the solve should load and search with the pattern databases.
+ */
+bool Solver::uses_pattern_databases(uint8_t board_size)
+{
+    return this->options.use_pattern_databases && (board_size == 4 || board_size == 5) && Solver::check_pattern_databases_available(board_size);
 }
 
 /**
- * Load a pattern database file into memory.
+ * Load the pattern databases for the given board size.
+ *
+ * While they are loading in the background this returns straight away, leaving pattern_database NULL.
+ * The search then runs on the other heuristics and calls this again between iterations to pick them up.
+ * Otherwise the first solver to ask reads them while later ones wait on its result.
  *
- * @param path The path to find the database file.
+ * @param board_size The width/height of the board being solved, 4 or 5.
  */
-void Solver::load_database(std::string path)
+void Solver::load_pattern_database(uint8_t board_size)
 {
-    off_t length;
+    if (this->pattern_database != NULL && this->pattern_database->get_board_size() == board_size) {
+        return;
+    }
+    this->pattern_database = NULL;
 
-    //Buffer storage
-    uint64_t hash;
-    uint8_t cost;
+    PatternDatabaseCache &cache = get_pattern_database_cache();
+    bool use_huge_pages = this->options.use_huge_pages;
 
-    //File handle
-    std::ifstream db(path, std::ios::binary);
+    std::promise<std::shared_ptr<PatternDatabase>> promise;
+    std::shared_future<std::shared_ptr<PatternDatabase>> loading;
+    bool read = false;
+    {
+        //Reuse the databases if another solver already has them loaded
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        this->pattern_database = cache.loaded[board_size][use_huge_pages].lock();
+        if (this->pattern_database != NULL) {
+            return;
+        }
 
-    if (!db.is_open()) {
-        throw std::string("Error: database file doesn't exist.\nMake sure you generate the pattern databases first.");
+        //Published before reading, so other solvers wait on this load rather than starting their own
+        std::shared_future<std::shared_ptr<PatternDatabase>> &published = cache.loading[board_size][use_huge_pages];
+        if (!published.valid()) {
+            if (this->options.background_database_load) {
+                published = std::async(std::launch::async, read_standard_pattern_databases, board_size, use_huge_pages).share();
+            } else {
+                published = promise.get_future().share();
+                read = true;
+            }
+        }
+        loading = published;
     }
 
-    //Get file length
-    db.seekg(0, std::ios::end);
-    length = db.tellg();
-    db.seekg(0, std::ios::beg);
+    //Read without the lock, so solves of other sizes carry on meanwhile
+    if (read) {
+        try {
+            promise.set_value(read_standard_pattern_databases(board_size, use_huge_pages));
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    } else if (this->options.background_database_load && loading.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
 
-    //Loop over the whole file and import each entry.
-    off_t position = 0;
-    while (position < length) {
-        db.read((char *) &hash, 8);
-        db.read((char *) &cost, 1);
+    try {
+        this->pattern_database = loading.get();
+    } catch (...) {
+        //A failed load is forgotten so the next solve can try again
+        //Only if it is still the failed one, another solver may have started a fresh load since
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        std::shared_future<std::shared_ptr<PatternDatabase>> &published = cache.loading[board_size][use_huge_pages];
+        if (published.valid() && published.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            try {
+                published.get();
+            } catch (...) {
+                published = std::shared_future<std::shared_ptr<PatternDatabase>>();
+            }
+        }
+        throw;
+    }
 
-        this->pattern_database->insert(std::pair<uint64_t, uint8_t>(hash, cost));
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.loaded[board_size][use_huge_pages] = this->pattern_database;
 
-        position += 9;
+    //Unlike background loads, databases read for a solve are released once no solver holds them
+    if (read) {
+        cache.loading[board_size][use_huge_pages] = std::shared_future<std::shared_ptr<PatternDatabase>>();
     }
 }
 
 /**
- * Load the pattern databases.
+ * Get the goal perimeter database of a board size and radius, building it on first use.
+ * Perimeters are shared by every solver in the process, so only the first solve with a radius pays for the search.
+ *
+ * @param board_size    The width/height of the board.
+ * @param radius        The number of moves from the goal to store.
+ *
+ * @return The perimeter database.
  */
-void Solver::load_pattern_database()
+std::shared_ptr<PerimeterDatabase> Solver::get_perimeter_database(uint8_t board_size, uint8_t radius)
 {
-    if (this->pattern_database == NULL) {
-        this->pattern_database = std::shared_ptr< std::map<uint64_t, uint8_t> >(new std::map<uint64_t, uint8_t>());
+    PerimeterDatabaseCache &cache = get_perimeter_database_cache();
+    std::pair<uint8_t, uint8_t> key(board_size, radius);
+
+    std::promise<std::shared_ptr<PerimeterDatabase>> promise;
+    std::shared_future<std::shared_ptr<PerimeterDatabase>> built;
+    bool build = false;
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto it = cache.built.find(key);
+        if (it == cache.built.end()) {
+            built = promise.get_future().share();
+            cache.built[key] = built;
+            build = true;
+        } else {
+            built = it->second;
+        }
+    }
+
+    //Built without the lock, so solves using other perimeters or the pattern databases carry on meanwhile
+    if (build) {
+        try {
+            std::shared_ptr<PerimeterDatabase> perimeter_database = std::shared_ptr<PerimeterDatabase>(new PerimeterDatabase(board_size, radius));
+            perimeter_database->generate();
+            promise.set_value(perimeter_database);
+        } catch (...) {
+            //A failed build is forgotten so the next solve can try again
+            {
+                std::lock_guard<std::mutex> lock(cache.mutex);
+                cache.built.erase(key);
+            }
+            promise.set_exception(std::current_exception());
+        }
+    }
+
+    return built.get();
+}
+
+/**
+ * Fetch the goal perimeter database for the given board size.
+ * Does nothing if the perimeter is disabled or already held.
+ *
+ * @param board_size The width/height of the board.
+ */
+void Solver::load_perimeter_database(uint8_t board_size)
+{
+    if (this->options.perimeter_radius == 0) {
+        return;
+    }
 
-        this->load_database("/usr/local/share/libtaquinsolve/234.db.bin");
-        this->load_database("/usr/local/share/libtaquinsolve/15691013.db.bin");
-        this->load_database("/usr/local/share/libtaquinsolve/7811121415.db.bin");
+    if (this->perimeter_database == NULL || this->perimeter_database->get_board_size() != board_size) {
+        this->perimeter_database = Solver::get_perimeter_database(board_size, this->options.perimeter_radius);
     }
 }
@@ -7,23 +7,37 @@
 #include <cstdint>
 
 #include "Board.hh"
+#include "PerimeterDatabase.hh"
 
 namespace TaquinSolve
 {
     class Solver
     {
         public:
-            Solver();
+            Solver(SolverOptions options = SolverOptions());
 
-            virtual std::queue<Moves> solve(std::vector<uint8_t> board, uint8_t board_size) = 0;
-            virtual std::vector< std::shared_ptr<Board> > perform_moves(Board *board, std::vector<Moves> moves) = 0;
+            std::queue<Moves> solve(std::vector<uint8_t> board, uint8_t board_size, SolveStats *stats = NULL);
+            virtual void solve_into(std::vector<uint8_t> board, uint8_t board_size, MoveSequence &solution, SolveStats *stats = NULL) = 0;
+
+            SolveStats get_stats();
+
+            static void start_pattern_database_load(bool use_huge_pages, uint8_t board_size = 4);
+            static void wait_for_pattern_database_load(bool use_huge_pages, uint8_t board_size = 4);
+            static std::shared_ptr<PatternDatabase> get_loaded_pattern_database(bool use_huge_pages, uint8_t board_size = 4);
+            static bool check_pattern_databases_available(uint8_t board_size);
+            static std::shared_ptr<PerimeterDatabase> get_perimeter_database(uint8_t board_size, uint8_t radius);
 
         protected:
-            std::shared_ptr< std::map<uint64_t, uint8_t> > pattern_database = NULL;
+            SolverOptions options;
+
+            //Statistics of the current or most recent solve
+            SolveStats stats;
 
-            void load_pattern_database();
+            std::shared_ptr<PatternDatabase> pattern_database = NULL;
+            std::shared_ptr<PerimeterDatabase> perimeter_database = NULL;
 
-        private:
-            void load_database(std::string path);
+            bool uses_pattern_databases(uint8_t board_size);
+            void load_pattern_database(uint8_t board_size = 4);
+            void load_perimeter_database(uint8_t board_size);
     };
 }
@@ -0,0 +1,221 @@
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "SolverClient.hh"
+#include "SolverDaemon.hh"
+#include "MoveSequence.hh"
+
+using namespace TaquinSolve;
+
+//Requests sent ahead of their responses, small enough that neither side's socket buffer fills.
+static const size_t PIPELINE_WINDOW = 256;
+
+/**
+ * Constructor.
+ * The connection is made on the first solve.
+ *
+ * @param socket_path   The daemon's socket, empty for the default path.
+ * @param options       Tunable parameters for in-process solves.
+ */
+SolverClient::SolverClient(std::string socket_path, SolverOptions options)
+    : socket_path(socket_path.empty() ? DaemonProtocol::get_default_socket_path() : socket_path), options(options)
+{
+}
+
+SolverClient::~SolverClient()
+{
+    this->disconnect();
+}
+
+/**
+ * Connect to the daemon if not already connected.
+ *
+ * @return False if no daemon is listening on the socket.
+ */
+bool SolverClient::connect()
+{
+    if (this->fd >= 0) {
+        return true;
+    }
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (this->socket_path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    strcpy(address.sun_path, this->socket_path.c_str());
+
+    this->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (this->fd < 0) {
+        return false;
+    }
+
+    char handshake[sizeof(DaemonProtocol::HANDSHAKE)];
+    if (::connect(this->fd, (sockaddr *) &address, sizeof(address)) != 0
+        || !DaemonProtocol::write_all(this->fd, DaemonProtocol::HANDSHAKE, sizeof(DaemonProtocol::HANDSHAKE))
+        || !DaemonProtocol::read_all(this->fd, handshake, sizeof(handshake))
+        || memcmp(handshake, DaemonProtocol::HANDSHAKE, sizeof(handshake)) != 0) {
+        this->disconnect();
+        return false;
+    }
+
+    return true;
+}
+
+bool SolverClient::is_connected()
+{
+    return this->fd >= 0;
+}
+
+void SolverClient::disconnect()
+{
+    if (this->fd >= 0) {
+        close(this->fd);
+        this->fd = -1;
+    }
+}
+
+/**
+ * Solve a board, like taquin_solve.
+ *
+ * @param board         The board to solve.
+ * @param board_size    The width/height of the board.
+ *
+ * @return The moves of an optimal solution.
+ */
+std::queue<Moves> SolverClient::solve(std::vector<uint8_t> board, uint8_t board_size)
+{
+    MoveSequence solution;
+    this->solve_into(board, board_size, solution);
+    return solution.to_queue();
+}
+
+/**
+ * Solve a board into a caller owned sequence.
+ *
+ * @param board         The board to solve.
+ * @param board_size    The width/height of the board.
+ * @param solution      Filled with the moves of an optimal solution.
+ */
+void SolverClient::solve_into(std::vector<uint8_t> board, uint8_t board_size, MoveSequence &solution)
+{
+    std::vector<MoveSequence> solutions;
+    std::vector<std::string> errors;
+    this->solve_batch(board, board_size, solutions, errors);
+
+    if (!errors[0].empty()) {
+        throw errors[0];
+    }
+    solution = solutions[0];
+}
+
+/**
+ * Solve many boards, pipelining them to the daemon.
+ * Boards the daemon can't answer, because it isn't running or the connection drops, are solved in-process.
+ *
+ * @param tiles         The boards, one after another.
+ * @param board_size    The width/height of every board.
+ * @param solutions     Filled with a solution per board.
+ * @param errors        Filled with an error per board, empty where the board was solved.
+ */
+void SolverClient::solve_batch(
+    const std::vector<uint8_t> &tiles,
+    uint8_t board_size,
+    std::vector<MoveSequence> &solutions,
+    std::vector<std::string> &errors
+) {
+    size_t cell_count = (size_t) board_size * board_size;
+    if (cell_count == 0 || tiles.size() % cell_count != 0 || tiles.empty()) {
+        throw std::string("Tile count is not a multiple of the board area.");
+    }
+
+    size_t count = tiles.size() / cell_count;
+    solutions.assign(count, MoveSequence());
+    errors.assign(count, std::string());
+    std::vector<bool> answered(count, false);
+
+    //The daemon always solves for the standard goal
+    if (this->options.goal_board.empty() && this->connect()) {
+        uint32_t first_id = this->next_id;
+        this->next_id += count;
+
+        std::vector<uint8_t> frames;
+        size_t sent = 0;
+        size_t received = 0;
+        bool connected = true;
+
+        while (connected && received < count) {
+            //Top the window up once half of it has been answered
+            if (sent < count && sent - received <= PIPELINE_WINDOW / 2) {
+                frames.clear();
+                for (; sent < count && sent - received < PIPELINE_WINDOW; sent++) {
+                    uint32_t id = first_id + sent;
+                    frames.insert(frames.end(), (uint8_t *) &id, (uint8_t *) &id + 4);
+                    frames.push_back(board_size);
+                    frames.insert(frames.end(), &tiles[sent * cell_count], &tiles[sent * cell_count] + cell_count);
+                }
+                connected = DaemonProtocol::write_all(this->fd, frames.data(), frames.size());
+                continue;
+            }
+
+            uint8_t header[DaemonProtocol::RESPONSE_HEADER_SIZE];
+            uint8_t payload[255];
+            connected = DaemonProtocol::read_all(this->fd, header, sizeof(header));
+            if (!connected) {
+                break;
+            }
+
+            uint32_t id;
+            memcpy(&id, header, 4);
+            size_t index = (uint32_t) (id - first_id);
+            uint8_t status = header[4];
+            uint8_t length = header[5];
+            size_t payload_size = status == DaemonProtocol::STATUS_SOLVED ? (length + 3) / 4 : length;
+
+            connected = index < count && !answered[index]
+                && (status != DaemonProtocol::STATUS_SOLVED || length <= MoveSequence::CAPACITY)
+                && DaemonProtocol::read_all(this->fd, payload, payload_size);
+            if (!connected) {
+                break;
+            }
+
+            if (status == DaemonProtocol::STATUS_SOLVED) {
+                solutions[index] = MoveSequence(payload, length);
+            } else {
+                errors[index] = std::string((const char *) payload, length);
+            }
+            answered[index] = true;
+            received++;
+        }
+
+        //Whatever is still in flight can't be matched up any more
+        if (!connected) {
+            this->disconnect();
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (!answered[i]) {
+            this->solve_locally(&tiles[i * cell_count], board_size, solutions[i], errors[i]);
+        }
+    }
+}
+
+/**
+ * Solve a board in this process, loading the databases on first use.
+ */
+void SolverClient::solve_locally(const uint8_t *board, uint8_t board_size, MoveSequence &solution, std::string &error)
+{
+    if (this->local_solver == NULL) {
+        this->local_solver = std::make_shared<IDASolver>(this->options);
+    }
+
+    try {
+        this->local_solver->solve_into(std::vector<uint8_t>(board, board + board_size * board_size), board_size, solution);
+    } catch (std::string e) {
+        error = e;
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <memory>
+#include <cstdint>
+
+#include "taquinsolve.hh"
+#include "IDASolver.hh"
+
+namespace TaquinSolve
+{
+    /**
+     * Solves boards through a running SolverDaemon, falling back to solving in-process when there isn't one.
+     * A drop-in replacement for taquin_solve in short-lived processes. Not safe to share between threads.
+     */
+    class SolverClient
+    {
+        public:
+            SolverClient(std::string socket_path = "", SolverOptions options = SolverOptions());
+            ~SolverClient();
+
+            bool connect();
+            bool is_connected();
+
+            std::queue<Moves> solve(std::vector<uint8_t> board, uint8_t board_size);
+            void solve_into(std::vector<uint8_t> board, uint8_t board_size, MoveSequence &solution);
+            void solve_batch(
+                const std::vector<uint8_t> &tiles,
+                uint8_t board_size,
+                std::vector<MoveSequence> &solutions,
+                std::vector<std::string> &errors
+            );
+
+        protected:
+            std::string socket_path;
+
+            //Used for in-process solves, the daemon uses its own
+            SolverOptions options;
+
+            int fd = -1;
+            uint32_t next_id = 0;
+
+            //Only created if a solve has to fall back
+            std::shared_ptr<IDASolver> local_solver;
+
+            void disconnect();
+            void solve_locally(const uint8_t *board, uint8_t board_size, MoveSequence &solution, std::string &error);
+    };
+}
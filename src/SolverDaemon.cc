@@ -0,0 +1,402 @@
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <algorithm>
+#include <chrono>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#include "SolverDaemon.hh"
+#include "IDASolver.hh"
+#include "BoardTables.hh"
+#include "MoveSequence.hh"
+
+using namespace TaquinSolve;
+
+//Requests queued per solver thread before the connection readers wait.
+static const size_t QUEUE_DEPTH_PER_THREAD = 256;
+
+//How long accepting waits before trying again after running out of descriptors or memory.
+static const std::chrono::milliseconds ACCEPT_RETRY_DELAY(100);
+
+//How long a response may wait on a client that isn't reading before the connection is dropped.
+static const time_t SEND_TIMEOUT_SECONDS = 5;
+
+/**
+ * Get the socket path used when none is given.
+ * Taken from the TAQUINSOLVE_SOCKET environment variable if set.
+ *
+ * @return The socket path.
+ */
+std::string DaemonProtocol::get_default_socket_path()
+{
+    const char *path = getenv("TAQUINSOLVE_SOCKET");
+    if (path != NULL && path[0] != '\0') {
+        return path;
+    }
+    return "/tmp/taquinsolve.sock";
+}
+
+/**
+ * Write the whole buffer to a socket.
+ *
+ * @return False if the connection was lost, or its send timeout passed.
+ */
+bool DaemonProtocol::write_all(int fd, const void *data, size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *) data;
+    while (size > 0) {
+        //MSG_NOSIGNAL turns a closed peer into an error rather than a SIGPIPE
+        ssize_t written = send(fd, bytes, size, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+    return true;
+}
+
+/**
+ * Fill the whole buffer from a socket.
+ *
+ * @return False if the connection was closed first.
+ */
+bool DaemonProtocol::read_all(int fd, void *data, size_t size)
+{
+    uint8_t *bytes = (uint8_t *) data;
+    while (size > 0) {
+        ssize_t count = recv(fd, bytes, size, 0);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        bytes += count;
+        size -= count;
+    }
+    return true;
+}
+
+/**
+ * A client connection, closed once its reader and all its queued requests are done with it.
+ */
+struct SolverDaemon::Connection
+{
+    int fd;
+
+    //Responses from different solver threads must not interleave
+    std::mutex write_mutex;
+
+    //Set once a write failed or timed out, later responses are dropped rather than waiting again
+    bool broken = false;
+
+    Connection(int fd) : fd(fd) {}
+    ~Connection() { close(this->fd); }
+};
+
+/**
+ * A board waiting for a solver thread.
+ */
+struct SolverDaemon::Request
+{
+    std::shared_ptr<Connection> connection;
+    uint32_t id = 0;
+    uint8_t board_size = 0;
+    std::vector<uint8_t> board;
+};
+
+/**
+ * Constructor.
+ *
+ * @param socket_path   Where to listen, empty for the default path.
+ * @param thread_count  The number of solver threads.
+ * @param options       Tunable parameters for the solvers, used for every request.
+ */
+SolverDaemon::SolverDaemon(std::string socket_path, uint32_t thread_count, SolverOptions options)
+    : socket_path(socket_path.empty() ? DaemonProtocol::get_default_socket_path() : socket_path),
+      thread_count(std::max(1u, thread_count)), options(options), stopping(false), solve_count(0)
+{
+}
+
+SolverDaemon::~SolverDaemon()
+{
+    if (this->listen_fd >= 0) {
+        close(this->listen_fd);
+    }
+}
+
+/**
+ * Create the listening socket.
+ * A socket file left behind by a daemon that is no longer running is replaced.
+ */
+void SolverDaemon::bind_socket()
+{
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (this->socket_path.size() >= sizeof(address.sun_path)) {
+        throw std::string("Socket path is too long: ") + this->socket_path;
+    }
+    strcpy(address.sun_path, this->socket_path.c_str());
+
+    this->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (this->listen_fd < 0) {
+        throw std::string("Unable to create socket.");
+    }
+
+    if (connect(this->listen_fd, (sockaddr *) &address, sizeof(address)) == 0) {
+        close(this->listen_fd);
+        this->listen_fd = -1;
+        throw std::string("A daemon is already listening on ") + this->socket_path;
+    }
+
+    //A failed connect leaves the socket unusable, start again
+    close(this->listen_fd);
+    this->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(this->socket_path.c_str());
+
+    if (bind(this->listen_fd, (sockaddr *) &address, sizeof(address)) != 0 || listen(this->listen_fd, SOMAXCONN) != 0) {
+        close(this->listen_fd);
+        this->listen_fd = -1;
+        throw std::string("Unable to listen on ") + this->socket_path;
+    }
+}
+
+/**
+ * Serve requests until stop() is called.
+ * The socket is opened first and the pattern databases are loaded in the background,
+ * requests sent meanwhile wait in the queue rather than paying for the load one by one.
+ */
+void SolverDaemon::run()
+{
+    try {
+        this->bind_socket();
+    } catch (std::string e) {
+        std::lock_guard<std::mutex> lock(this->state_mutex);
+        this->listen_failed = true;
+        this->state_changed.notify_all();
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->state_mutex);
+        this->listening = true;
+        this->state_changed.notify_all();
+    }
+
+    //Without the databases 4x4 requests report the error themselves, smaller boards still work.
+    //Every other size with databases installed is loaded too, so its first request doesn't pay for them.
+    for (uint8_t board_size = 2; board_size <= MAX_BOARD_SIZE; board_size++) {
+        if (Solver::check_pattern_databases_available(board_size)) {
+            taquin_warm_up(this->options.use_huge_pages, false, board_size);
+        }
+    }
+
+    this->requests = std::make_shared<WorkQueue<Request>>(QUEUE_DEPTH_PER_THREAD * this->thread_count);
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < this->thread_count; t++) {
+        workers.push_back(std::thread(&SolverDaemon::solve_requests, this));
+    }
+
+    while (!this->stopping) {
+        int fd = accept(this->listen_fd, NULL, NULL);
+        if (fd < 0) {
+            //Descriptors and memory come back as connections close, so back off rather than stop serving
+            if (errno != EINTR && errno != ECONNABORTED) {
+                std::this_thread::sleep_for(ACCEPT_RETRY_DELAY);
+            }
+            continue;
+        }
+
+        //A client that stops reading can't hold a solver thread for longer than this
+        timeval send_timeout = {SEND_TIMEOUT_SECONDS, 0};
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+
+        std::shared_ptr<Connection> connection = std::make_shared<Connection>(fd);
+        {
+            std::lock_guard<std::mutex> lock(this->connections_mutex);
+            this->connections.erase(
+                std::remove_if(this->connections.begin(), this->connections.end(), [](std::weak_ptr<Connection> &c) { return c.expired(); }),
+                this->connections.end()
+            );
+            this->connections.push_back(connection);
+            this->active_readers++;
+        }
+
+        //Readers come and go with their clients, so they are counted rather than joined
+        std::thread([this, connection]() {
+            this->read_requests(connection);
+            std::lock_guard<std::mutex> lock(this->connections_mutex);
+            this->active_readers--;
+            this->readers_done.notify_all();
+        }).detach();
+    }
+
+    //Wake the readers, let the queued requests drain, then stop the workers
+    {
+        std::unique_lock<std::mutex> lock(this->connections_mutex);
+        for (std::weak_ptr<Connection> &weak_connection : this->connections) {
+            std::shared_ptr<Connection> connection = weak_connection.lock();
+            if (connection != NULL) {
+                shutdown(connection->fd, SHUT_RD);
+            }
+        }
+        this->readers_done.wait(lock, [this]() { return this->active_readers == 0; });
+        this->connections.clear();
+    }
+    this->requests->close();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    close(this->listen_fd);
+    this->listen_fd = -1;
+    unlink(this->socket_path.c_str());
+}
+
+/**
+ * Make run() return.
+ * Only touches the listening socket, so it is safe to call from a signal handler.
+ */
+void SolverDaemon::stop()
+{
+    this->stopping = true;
+    if (this->listen_fd >= 0) {
+        shutdown(this->listen_fd, SHUT_RDWR);
+    }
+}
+
+/**
+ * Wait for run() to open the socket, so clients started afterwards can connect straight away.
+ *
+ * @return False if run() failed to open the socket.
+ */
+bool SolverDaemon::wait_until_listening()
+{
+    std::unique_lock<std::mutex> lock(this->state_mutex);
+    this->state_changed.wait(lock, [this]() { return this->listening || this->listen_failed; });
+    return this->listening;
+}
+
+/**
+ * @return The number of requests answered so far.
+ */
+uint64_t SolverDaemon::get_solve_count()
+{
+    return this->solve_count;
+}
+
+/**
+ * Read pipelined requests from a connection and queue them for the solver threads.
+ * Frames are parsed out of large reads, so a batch of requests costs a handful of system calls.
+ *
+ * @param connection The connection to read from.
+ */
+void SolverDaemon::read_requests(std::shared_ptr<Connection> connection)
+{
+    char handshake[sizeof(DaemonProtocol::HANDSHAKE)];
+    if (!DaemonProtocol::read_all(connection->fd, handshake, sizeof(handshake))
+        || memcmp(handshake, DaemonProtocol::HANDSHAKE, sizeof(handshake)) != 0
+        || !DaemonProtocol::write_all(connection->fd, DaemonProtocol::HANDSHAKE, sizeof(DaemonProtocol::HANDSHAKE))) {
+        return;
+    }
+
+    std::vector<uint8_t> buffer(1 << 16);
+    size_t start = 0;
+    size_t end = 0;
+
+    while (true) {
+        //Queue every complete frame in the buffer
+        while (end - start >= DaemonProtocol::REQUEST_HEADER_SIZE) {
+            uint8_t board_size = buffer[start + 4];
+            size_t cell_count = (size_t) board_size * board_size;
+
+            //The frame length depends on the board size, a bad one means the stream can't be followed
+            if (board_size < 2 || cell_count > MAX_CELLS) {
+                return;
+            }
+            if (end - start < DaemonProtocol::REQUEST_HEADER_SIZE + cell_count) {
+                break;
+            }
+
+            Request request;
+            request.connection = connection;
+            memcpy(&request.id, &buffer[start], 4);
+            request.board_size = board_size;
+            request.board.assign(&buffer[start + DaemonProtocol::REQUEST_HEADER_SIZE], &buffer[start + DaemonProtocol::REQUEST_HEADER_SIZE + cell_count]);
+            this->requests->push(std::move(request));
+
+            start += DaemonProtocol::REQUEST_HEADER_SIZE + cell_count;
+        }
+
+        //Move the partial frame to the front and read more behind it
+        memmove(buffer.data(), &buffer[start], end - start);
+        end -= start;
+        start = 0;
+
+        ssize_t count = recv(connection->fd, &buffer[end], buffer.size() - end, 0);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return;
+        }
+        end += count;
+    }
+}
+
+/**
+ * Solve queued requests until the daemon stops, answering each on its own connection.
+ * Nothing is solved until the databases started by run() are loaded.
+ */
+void SolverDaemon::solve_requests()
+{
+    for (uint8_t board_size = 2; board_size <= MAX_BOARD_SIZE; board_size++) {
+        Solver::wait_for_pattern_database_load(this->options.use_huge_pages, board_size);
+    }
+
+    IDASolver solver(this->options);
+    MoveSequence solution;
+    Request request;
+
+    while (this->requests->pop(request)) {
+        uint8_t response[DaemonProtocol::RESPONSE_HEADER_SIZE + 255];
+        size_t response_size = DaemonProtocol::RESPONSE_HEADER_SIZE;
+        memcpy(response, &request.id, 4);
+
+        try {
+            solver.solve_into(request.board, request.board_size, solution);
+            response[4] = DaemonProtocol::STATUS_SOLVED;
+            response[5] = solution.size();
+            memcpy(&response[response_size], solution.get_data(), solution.get_data_size());
+            response_size += solution.get_data_size();
+        } catch (std::string e) {
+            uint8_t length = std::min<size_t>(e.size(), 255);
+            response[4] = DaemonProtocol::STATUS_FAILED;
+            response[5] = length;
+            memcpy(&response[response_size], e.data(), length);
+            response_size += length;
+        }
+
+        {
+            //A failed write leaves a partial frame, so the connection is closed for its reader to notice
+            std::lock_guard<std::mutex> lock(request.connection->write_mutex);
+            if (!request.connection->broken && !DaemonProtocol::write_all(request.connection->fd, response, response_size)) {
+                request.connection->broken = true;
+                shutdown(request.connection->fd, SHUT_RDWR);
+            }
+        }
+        this->solve_count++;
+
+        //Release the connection now rather than when the next request replaces it
+        request.connection = NULL;
+    }
+}
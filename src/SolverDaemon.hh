@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+#include "taquinsolve.hh"
+#include "WorkQueue.hh"
+
+namespace TaquinSolve
+{
+    /**
+     * The wire format shared by the daemon and its clients.
+     *
+     * Both sides open a connection by sending HANDSHAKE. After that the client sends request frames and the
+     * daemon answers each with a response frame, in the order the solves finish rather than the order sent.
+     * Multi-byte fields are in host byte order, the socket never leaves the machine.
+     *
+     * Request:  id (4), board size (1), then one byte per cell.
+     * Response: id (4), status (1), length (1), then the packed moves if solved or the error message if not.
+     */
+    namespace DaemonProtocol
+    {
+        const char HANDSHAKE[8] = {'T', 'Q', 'D', 'A', 'E', 'M', 'N', '1'};
+
+        const uint8_t STATUS_SOLVED = 0;
+        const uint8_t STATUS_FAILED = 1;
+
+        const size_t REQUEST_HEADER_SIZE = 5;
+        const size_t RESPONSE_HEADER_SIZE = 6;
+
+        std::string get_default_socket_path();
+
+        bool write_all(int fd, const void *data, size_t size);
+        bool read_all(int fd, void *data, size_t size);
+    }
+
+    /**
+     * Keeps the pattern databases resident and solves boards sent over a Unix domain socket.
+     * Requests from every connection are queued onto one pool of solver threads.
+     */
+    class SolverDaemon
+    {
+        public:
+            SolverDaemon(std::string socket_path, uint32_t thread_count, SolverOptions options = SolverOptions());
+            ~SolverDaemon();
+
+            void run();
+            void stop();
+            bool wait_until_listening();
+
+            uint64_t get_solve_count();
+
+        protected:
+            struct Connection;
+            struct Request;
+
+            std::string socket_path;
+            uint32_t thread_count;
+            SolverOptions options;
+
+            int listen_fd = -1;
+            std::atomic<bool> stopping;
+            std::atomic<uint64_t> solve_count;
+
+            //Set once run() has opened the socket, or failed to
+            bool listening = false;
+            bool listen_failed = false;
+            std::mutex state_mutex;
+            std::condition_variable state_changed;
+
+            //Requests from all connections waiting for a solver thread
+            std::shared_ptr<WorkQueue<Request>> requests;
+
+            //Open connections, so stop() can wake their readers
+            std::vector<std::weak_ptr<Connection>> connections;
+            uint32_t active_readers = 0;
+            std::mutex connections_mutex;
+            std::condition_variable readers_done;
+
+            void bind_socket();
+            void read_requests(std::shared_ptr<Connection> connection);
+            void solve_requests();
+    };
+}
@@ -0,0 +1,103 @@
+#include <cstring>
+
+#include "Trace.hh"
+
+using namespace TaquinSolve;
+
+//Identifies a trace file and its format version.
+static const char TRACE_MAGIC[8] = {'T', 'Q', 'T', 'R', 'A', 'C', 'E', '1'};
+
+/**
+ * Constructor.
+ * Opens the trace file for appending, writing the header if it is new.
+ *
+ * @param path The path of the trace file.
+ */
+TraceWriter::TraceWriter(std::string path)
+{
+    this->file.open(path, std::ios::out | std::ios::binary | std::ios::app);
+
+    if (!this->file.is_open()) {
+        throw std::string("Unable to open trace file: ") + path;
+    }
+
+    if (this->file.tellp() == 0) {
+        this->file.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        this->file.flush();
+    }
+}
+
+/**
+ * Append a record.
+ *
+ * Layout: timestamp (8), board size (1), cell count (1), outcome (1), solution length (1),
+ * solve time (4), nodes generated (8), then one byte per cell.
+ *
+ * @param record The record to write.
+ */
+void TraceWriter::write(const TraceRecord &record)
+{
+    uint8_t cell_count = record.board.size();
+    uint8_t outcome = record.outcome;
+
+    std::lock_guard<std::mutex> lock(this->file_mutex);
+
+    this->file.write((const char *) &record.timestamp, 8);
+    this->file.write((const char *) &record.board_size, 1);
+    this->file.write((const char *) &cell_count, 1);
+    this->file.write((const char *) &outcome, 1);
+    this->file.write((const char *) &record.solution_length, 1);
+    this->file.write((const char *) &record.solve_time, 4);
+    this->file.write((const char *) &record.nodes_generated, 8);
+    this->file.write((const char *) record.board.data(), cell_count);
+    this->file.flush();
+}
+
+/**
+ * Constructor.
+ * Opens the trace file and checks its header.
+ *
+ * @param path The path of the trace file.
+ */
+TraceReader::TraceReader(std::string path)
+{
+    this->file.open(path, std::ios::in | std::ios::binary);
+
+    if (!this->file.is_open()) {
+        throw std::string("Unable to open trace file: ") + path;
+    }
+
+    char magic[sizeof(TRACE_MAGIC)];
+    this->file.read(magic, sizeof(magic));
+
+    if (!this->file || memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0) {
+        throw std::string("Not a trace file: ") + path;
+    }
+}
+
+/**
+ * Read the next record.
+ *
+ * @param record Filled with the record.
+ *
+ * @return False once the end of the file is reached.
+ */
+bool TraceReader::read(TraceRecord &record)
+{
+    uint8_t cell_count;
+    uint8_t outcome;
+
+    this->file.read((char *) &record.timestamp, 8);
+    this->file.read((char *) &record.board_size, 1);
+    this->file.read((char *) &cell_count, 1);
+    this->file.read((char *) &outcome, 1);
+    this->file.read((char *) &record.solution_length, 1);
+    this->file.read((char *) &record.solve_time, 4);
+    this->file.read((char *) &record.nodes_generated, 8);
+
+    record.outcome = (TraceOutcome) outcome;
+    record.board.resize(cell_count);
+    this->file.read((char *) record.board.data(), cell_count);
+
+    return (bool) this->file;
+}
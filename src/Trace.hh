@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+
+namespace TaquinSolve
+{
+    /**
+     * The outcome of a traced solve.
+     */
+    enum TraceOutcome
+    {
+        SOLVED,
+        FAILED
+    };
+
+    /**
+     * One solve captured from the workload.
+     */
+    struct TraceRecord
+    {
+        //Microseconds since the epoch when the solve started
+        uint64_t timestamp = 0;
+
+        //The input as given to taquin_solve
+        uint8_t board_size = 0;
+        std::vector<uint8_t> board;
+
+        //What happened
+        TraceOutcome outcome = TraceOutcome::SOLVED;
+        uint8_t solution_length = 0;
+        uint32_t solve_time = 0;
+        uint64_t nodes_generated = 0;
+    };
+
+    /**
+     * Appends solve records to a binary trace file.
+     * Safe to use from several threads at once.
+     */
+    class TraceWriter
+    {
+        public:
+            TraceWriter(std::string path);
+
+            void write(const TraceRecord &record);
+
+        protected:
+            std::ofstream file;
+            std::mutex file_mutex;
+    };
+
+    /**
+     * Reads the records of a binary trace file in order.
+     */
+    class TraceReader
+    {
+        public:
+            TraceReader(std::string path);
+
+            bool read(TraceRecord &record);
+
+        protected:
+            std::ifstream file;
+    };
+}
@@ -0,0 +1,215 @@
+#include <string>
+#include <queue>
+
+#include "WalkingDistance.hh"
+
+using namespace TaquinSolve;
+
+/**
+ * Get the shared table for a board size, generating it on first use.
+ *
+ * @param board_size The width/height of the board.
+ *
+ * @return The table, NULL if the size is unsupported.
+ */
+WalkingDistanceTable *WalkingDistanceTable::get(uint8_t board_size)
+{
+    switch (board_size) {
+        case 2: {
+            static WalkingDistanceTable table(2);
+            return &table;
+        }
+        case 3: {
+            static WalkingDistanceTable table(3);
+            return &table;
+        }
+        case 4: {
+            static WalkingDistanceTable table(4);
+            return &table;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Constructor.
+ * Generates the table, taking a few milliseconds for a 4x4 board.
+ *
+ * @param board_size The width/height of the board.
+ */
+WalkingDistanceTable::WalkingDistanceTable(uint8_t board_size) : board_size(board_size)
+{
+    if (board_size < 2 || board_size > 4) {
+        throw std::string("Walking distance tables only support board sizes 2-4.");
+    }
+
+    this->generate();
+}
+
+/**
+ * Pack tile counts into a table key, three bits per count.
+ */
+static uint64_t pack_counts(const uint8_t counts[4][4], uint8_t board_size)
+{
+    uint64_t key = 0;
+    for (uint8_t line = 0; line < board_size; line++) {
+        for (uint8_t goal_line = 0; goal_line < board_size; goal_line++) {
+            key = (key << 3) | counts[line][goal_line];
+        }
+    }
+    return key;
+}
+
+/**
+ * Unpack tile counts from a table key.
+ */
+static void unpack_counts(uint64_t key, uint8_t counts[4][4], uint8_t board_size)
+{
+    for (int8_t line = board_size - 1; line >= 0; line--) {
+        for (int8_t goal_line = board_size - 1; goal_line >= 0; goal_line--) {
+            counts[line][goal_line] = key & 0x7;
+            key >>= 3;
+        }
+    }
+}
+
+/**
+ * Breadth first search from the goal over every reachable state.
+ */
+void WalkingDistanceTable::generate()
+{
+    uint8_t size = this->board_size;
+    uint8_t counts[4][4] = {{0}};
+
+    //At the goal every line holds its own tiles, the last one is missing the empty tile
+    for (uint8_t line = 0; line < size; line++) {
+        counts[line][line] = line == size - 1 ? size - 1 : size;
+    }
+
+    std::vector<uint64_t> keys;
+    std::queue<uint16_t> frontier;
+
+    keys.push_back(pack_counts(counts, size));
+    this->indices[keys[0]] = 0;
+    this->distances.push_back(0);
+    frontier.push(0);
+
+    while (!frontier.empty()) {
+        uint16_t state = frontier.front();
+        frontier.pop();
+
+        unpack_counts(keys[state], counts, size);
+        this->transitions.resize(keys.size() * 2 * size, NO_STATE);
+
+        //The empty tile is in the line one tile short
+        uint8_t empty_line = 0;
+        for (uint8_t line = 0; line < size; line++) {
+            uint8_t tiles = 0;
+            for (uint8_t goal_line = 0; goal_line < size; goal_line++) {
+                tiles += counts[line][goal_line];
+            }
+            if (tiles < size) {
+                empty_line = line;
+            }
+        }
+
+        for (uint8_t direction = 0; direction < 2; direction++) {
+            if ((direction == 0 && empty_line == 0) || (direction == 1 && empty_line == size - 1)) {
+                continue;
+            }
+            uint8_t next_line = direction == 0 ? empty_line - 1 : empty_line + 1;
+
+            //Swap the empty tile with a tile of each goal line in the next line
+            for (uint8_t goal_line = 0; goal_line < size; goal_line++) {
+                if (counts[next_line][goal_line] == 0) {
+                    continue;
+                }
+
+                counts[next_line][goal_line]--;
+                counts[empty_line][goal_line]++;
+                uint64_t key = pack_counts(counts, size);
+                counts[next_line][goal_line]++;
+                counts[empty_line][goal_line]--;
+
+                auto it = this->indices.find(key);
+                uint16_t next_state;
+                if (it == this->indices.end()) {
+                    next_state = keys.size();
+                    keys.push_back(key);
+                    this->indices[key] = next_state;
+                    this->distances.push_back(this->distances[state] + 1);
+                    frontier.push(next_state);
+                } else {
+                    next_state = it->second;
+                }
+
+                this->transitions[(state * 2 + direction) * size + goal_line] = next_state;
+            }
+        }
+    }
+
+    this->transitions.resize(keys.size() * 2 * size, NO_STATE);
+}
+
+/**
+ * Find the state of a board's rows or columns.
+ *
+ * @param cells     The tiles in row major order.
+ * @param tables    The geometry of the board.
+ * @param columns   True for the columns, false for the rows.
+ *
+ * @return The state.
+ */
+uint16_t WalkingDistanceTable::get_state(const uint8_t *cells, const BoardTables *tables, bool columns)
+{
+    uint8_t counts[4][4] = {{0}};
+    for (uint8_t cell = 0; cell < tables->cell_count; cell++) {
+        uint8_t tile = cells[cell];
+        if (tile == 0) {
+            continue;
+        }
+        if (columns) {
+            counts[tables->x[cell]][tables->goal_x[tile]]++;
+        } else {
+            counts[tables->y[cell]][tables->goal_y[tile]]++;
+        }
+    }
+
+    return this->indices.at(pack_counts(counts, this->board_size));
+}
+
+/**
+ * Follow a move of the empty tile.
+ *
+ * @param state         The state before the move.
+ * @param direction     0 if the empty tile moves to the previous line (up or left), 1 for the next.
+ * @param goal_line     The goal line of the tile swapped with the empty tile.
+ *
+ * @return The state after the move.
+ */
+uint16_t WalkingDistanceTable::move(uint16_t state, uint8_t direction, uint8_t goal_line)
+{
+    return this->transitions[(state * 2 + direction) * this->board_size + goal_line];
+}
+
+/**
+ * @return The fewest moves between lines to reach the goal from the state.
+ */
+uint8_t WalkingDistanceTable::get_distance(uint16_t state)
+{
+    return this->distances[state];
+}
+
+uint8_t WalkingDistanceTable::get_board_size()
+{
+    return this->board_size;
+}
+
+/**
+ * @return The number of states.
+ */
+size_t WalkingDistanceTable::size()
+{
+    return this->distances.size();
+}
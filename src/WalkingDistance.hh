@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+#include "BoardTables.hh"
+
+namespace TaquinSolve
+{
+    /**
+     * Walking distance tables for one board size.
+     *
+     * A state counts, for each row, how many of its tiles belong in each goal row. Moving the empty
+     * tile up or down swaps one tile between neighbouring rows, and the table holds the fewest such
+     * swaps from every state to the goal. Columns use the same table, transposed, and the row and
+     * column distances add up to a bound at least as strong as Manhattan distance.
+     *
+     * Each state also has its successor for every move, so a board's states follow from its parent's.
+     */
+    class WalkingDistanceTable
+    {
+        public:
+            //Marks a move that isn't possible from a state
+            static constexpr uint16_t NO_STATE = UINT16_MAX;
+
+            WalkingDistanceTable(uint8_t board_size);
+
+            uint16_t get_state(const uint8_t *cells, const BoardTables *tables, bool columns);
+            uint16_t move(uint16_t state, uint8_t direction, uint8_t goal_line);
+            uint8_t get_distance(uint16_t state);
+
+            uint8_t get_board_size();
+            size_t size();
+
+            static WalkingDistanceTable *get(uint8_t board_size);
+
+        protected:
+            uint8_t board_size;
+
+            //The index of each state, keyed by its counts packed three bits each
+            std::unordered_map<uint64_t, uint16_t> indices;
+
+            //Moves from the goal of each state
+            std::vector<uint8_t> distances;
+
+            //The state after each move, indexed [state][direction][goal line]
+            std::vector<uint16_t> transitions;
+
+            void generate();
+    };
+}
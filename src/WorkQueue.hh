@@ -0,0 +1,84 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+
+namespace TaquinSolve
+{
+    /**
+     * A bounded queue passing items between threads, closed once the producers are done.
+     */
+    template<typename T>
+    class WorkQueue
+    {
+        public:
+            WorkQueue(size_t capacity) : capacity(capacity) {}
+
+            void push(T item)
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->not_full.wait(lock, [this]() { return this->items.size() < this->capacity; });
+                this->items.push_back(std::move(item));
+                this->not_empty.notify_one();
+            }
+
+            /**
+             * @return False once the queue is closed and empty.
+             */
+            bool pop(T &item)
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->not_empty.wait(lock, [this]() { return !this->items.empty() || this->closed; });
+                if (this->items.empty()) {
+                    return false;
+                }
+                item = std::move(this->items.front());
+                this->items.pop_front();
+                this->not_full.notify_one();
+                return true;
+            }
+
+            /**
+             * Like pop() but gives up after the given time, so the caller can do other work.
+             *
+             * @return False if nothing arrived in time or the queue is closed and empty.
+             */
+            bool pop_for(T &item, std::chrono::milliseconds timeout)
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                if (!this->not_empty.wait_for(lock, timeout, [this]() { return !this->items.empty() || this->closed; })) {
+                    return false;
+                }
+                if (this->items.empty()) {
+                    return false;
+                }
+                item = std::move(this->items.front());
+                this->items.pop_front();
+                this->not_full.notify_one();
+                return true;
+            }
+
+            void close()
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->closed = true;
+                this->not_empty.notify_all();
+            }
+
+            bool is_finished()
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                return this->closed && this->items.empty();
+            }
+
+        protected:
+            size_t capacity;
+            bool closed = false;
+            std::deque<T> items;
+            std::mutex mutex;
+            std::condition_variable not_empty;
+            std::condition_variable not_full;
+    };
+}
@@ -0,0 +1,230 @@
+#include <cmath>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#include "taquinsolve.h"
+#include "taquinsolve.hh"
+#include "IDASolver.hh"
+#include "GoalMapping.hh"
+#include "BoardParser.hh"
+#include "BoardTables.hh"
+#include "MoveSequence.hh"
+
+using namespace TaquinSolve;
+
+/**
+ * A solver and the scratch memory reused by each solve through it.
+ */
+struct taquin_solver
+{
+    IDASolver solver;
+
+    //Set when solving for another goal, boards are mapped into board and validated as the solver will see them
+    std::shared_ptr<GoalMapping> goal_mapping;
+    uint8_t goal_board_size = 0;
+
+    std::vector<uint8_t> board;
+    MoveSequence solution;
+    SolveStats stats;
+
+    char last_error[256] = {0};
+
+    taquin_solver(SolverOptions options) : solver(options) {}
+};
+
+/**
+ * Record the reason a solve failed.
+ *
+ * @return The negated status, for returning to the caller.
+ */
+static int fail(taquin_solver *solver, int status, const std::string &message)
+{
+    strncpy(solver->last_error, message.c_str(), sizeof(solver->last_error) - 1);
+    return -status;
+}
+
+/**
+ * Fill a config with the defaults.
+ *
+ * @param config The config to fill.
+ */
+void taquin_solver_config_init(taquin_solver_config *config)
+{
+    memset(config, 0, sizeof(*config));
+}
+
+/**
+ * Create a solver handle.
+ *
+ * @param config The options of the solver, copied. NULL for the defaults.
+ *
+ * @return The handle, or NULL if the config is invalid or memory runs out.
+ */
+taquin_solver *taquin_solver_create(const taquin_solver_config *config)
+{
+    taquin_solver_config defaults;
+    taquin_solver_config_init(&defaults);
+    if (config == NULL) {
+        config = &defaults;
+    }
+
+    SolverOptions options;
+    options.perimeter_radius = config->perimeter_radius;
+    options.use_huge_pages = config->use_huge_pages != 0;
+
+    try {
+        std::shared_ptr<GoalMapping> goal_mapping;
+        uint8_t goal_board_size = 0;
+
+        if (config->goal_board != NULL) {
+            goal_board_size = std::lround(std::sqrt(config->goal_board_length));
+            std::vector<uint8_t> goal_board(config->goal_board, config->goal_board + config->goal_board_length);
+            goal_mapping = std::make_shared<GoalMapping>(goal_board, goal_board_size);
+        }
+
+        taquin_solver *solver = new taquin_solver(options);
+        solver->goal_mapping = goal_mapping;
+        solver->goal_board_size = goal_board_size;
+        return solver;
+    } catch (...) {
+        return NULL;
+    }
+}
+
+/**
+ * Solve a board.
+ *
+ * @param solver        The handle to solve with.
+ * @param board         The tiles, board_size * board_size of them with 0 as the empty tile.
+ * @param board_size    The width/height of the board.
+ * @param moves         Filled with the moves of an optimal solution, one TAQUIN_MOVE_* per byte.
+ * @param capacity      The number of moves that fit in moves.
+ * @param stats         If not NULL, filled with a description of the work done. Also filled when the
+ *                      moves don't fit, its solution_length being the capacity needed.
+ *
+ * @return The solution length, or a negated TAQUIN_ERROR_* status.
+ */
+int taquin_solve_into(
+    taquin_solver *solver,
+    const uint8_t *board,
+    uint8_t board_size,
+    uint8_t *moves,
+    size_t capacity,
+    taquin_solve_stats *stats
+) {
+    if (solver == NULL) {
+        return -TAQUIN_ERROR_INVALID_ARGUMENT;
+    }
+    solver->last_error[0] = '\0';
+
+    if (board == NULL || (moves == NULL && capacity > 0)) {
+        return fail(solver, TAQUIN_ERROR_INVALID_ARGUMENT, "Board or move buffer missing.");
+    }
+    if (board_size < 2 || board_size * board_size > MAX_CELLS) {
+        return fail(solver, TAQUIN_ERROR_INVALID_ARGUMENT, "Board size invalid.");
+    }
+    if (solver->goal_mapping != NULL && board_size != solver->goal_board_size) {
+        return fail(solver, TAQUIN_ERROR_INVALID_ARGUMENT, "Board size doesn't match the goal board.");
+    }
+
+    try {
+        //Validate up front so the reason can be told apart from other failures.
+        //The board is copied or mapped into the handle's buffer, reusing the capacity from the previous solve.
+        std::chrono::steady_clock::time_point validation_start = std::chrono::steady_clock::now();
+        ParseError error = BoardParser::validate(board, board_size, solver->goal_mapping == NULL);
+        if (error == ParseError::NONE) {
+            if (solver->goal_mapping == NULL) {
+                solver->board.assign(board, board + board_size * board_size);
+            } else {
+                solver->board.resize(board_size * board_size);
+                solver->goal_mapping->map_board_into(board, solver->board.data());
+                error = BoardParser::validate(solver->board.data(), board_size);
+            }
+        }
+        uint64_t validation_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - validation_start).count();
+        if (error != ParseError::NONE) {
+            return fail(
+                solver,
+                error == ParseError::UNSOLVABLE ? TAQUIN_ERROR_UNSOLVABLE : TAQUIN_ERROR_INVALID_BOARD,
+                BoardParser::describe(error)
+            );
+        }
+
+        //Already validated, so the solver reads the buffer in place without checking it again
+        solver->solver.solve_validated(solver->board, board_size, solver->solution, &solver->stats);
+        solver->stats.validation_time = validation_time;
+        if (solver->goal_mapping != NULL) {
+            solver->goal_mapping->unmap_moves(solver->solution);
+        }
+    } catch (std::string e) {
+        return fail(solver, TAQUIN_ERROR_SOLVER, e);
+    } catch (std::bad_alloc &e) {
+        return fail(solver, TAQUIN_ERROR_OUT_OF_MEMORY, "Out of memory.");
+    } catch (...) {
+        return fail(solver, TAQUIN_ERROR_SOLVER, "Unexpected error.");
+    }
+
+    if (stats != NULL) {
+        stats->nodes_expanded = solver->stats.nodes_expanded;
+        stats->nodes_generated = solver->stats.nodes_generated;
+        stats->transposition_hits = solver->stats.transposition_hits;
+        stats->pdb_lookups = solver->stats.pdb_lookups;
+        stats->database_load_time = solver->stats.database_load_time;
+        stats->validation_time = solver->stats.validation_time;
+        stats->search_time = solver->stats.search_time;
+        stats->iterations = solver->stats.iterations.size();
+        stats->initial_heuristic = solver->stats.initial_heuristic;
+        stats->solution_length = solver->solution.size();
+    }
+
+    if (solver->solution.size() > capacity) {
+        return fail(solver, TAQUIN_ERROR_BUFFER_TOO_SMALL, "Solution doesn't fit in the move buffer.");
+    }
+
+    for (uint8_t i = 0; i < solver->solution.size(); i++) {
+        moves[i] = solver->solution[i];
+    }
+
+    return solver->solution.size();
+}
+
+/**
+ * @return A description of the last failure of the handle, empty if the last solve succeeded.
+ */
+const char *taquin_solver_last_error(const taquin_solver *solver)
+{
+    return solver == NULL ? "" : solver->last_error;
+}
+
+/**
+ * @param status A status code, negated or not.
+ *
+ * @return A description of the status.
+ */
+const char *taquin_status_string(int status)
+{
+    switch (status < 0 ? -status : status) {
+        case TAQUIN_OK:                     return "OK";
+        case TAQUIN_ERROR_INVALID_ARGUMENT: return "Invalid argument";
+        case TAQUIN_ERROR_INVALID_BOARD:    return "Invalid board";
+        case TAQUIN_ERROR_UNSOLVABLE:       return "Board is unsolvable";
+        case TAQUIN_ERROR_BUFFER_TOO_SMALL: return "Move buffer is too small";
+        case TAQUIN_ERROR_SOLVER:           return "Solver error";
+        case TAQUIN_ERROR_OUT_OF_MEMORY:    return "Out of memory";
+    }
+    return "Unknown status";
+}
+
+void taquin_solver_destroy(taquin_solver *solver)
+{
+    delete solver;
+}
+
+/**
+ * I found this stub neccessary to satisfy an AC_CHECK_LIB macro in autotools.
+ */
+int taquin_solve_c_stub(void)
+{
+    return 0;
+}
@@ -0,0 +1,526 @@
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <signal.h>
+
+#include "taquinsolve.hh"
+#include "IDASolver.hh"
+#include "BoardParser.hh"
+#include "MoveSequence.hh"
+#include "WorkQueue.hh"
+#include "SolverDaemon.hh"
+
+using namespace TaquinSolve;
+
+//Identifies a binary solution stream and its format version.
+static const char SOLUTION_MAGIC[8] = {'T', 'Q', 'S', 'O', 'L', 'N', 'S', '1'};
+
+//Jobs and results held in flight per worker, bounding memory while streaming.
+static const size_t QUEUE_DEPTH_PER_THREAD = 256;
+
+//Largest goal perimeter accepted on the command line, larger ones take more memory than is sensible.
+static const unsigned long MAX_PERIMETER_RADIUS = 20;
+
+/**
+ * A board read from the input.
+ */
+struct Job
+{
+    //Position in the input, counting from 0
+    uint64_t index = 0;
+
+    uint8_t board_size = 0;
+    std::vector<uint8_t> board;
+
+    //Set if the line could not be parsed
+    ParseError error = ParseError::NONE;
+};
+
+/**
+ * The outcome of a job.
+ */
+struct Result
+{
+    uint64_t index = 0;
+    bool solved = false;
+    MoveSequence solution;
+    std::string error;
+    uint64_t nodes_generated = 0;
+};
+
+/**
+ * How far workers may get ahead of the output when writing in input order.
+ * Results finishing early wait in memory for their turn, so this bounds how many are held.
+ */
+struct OrderWindow
+{
+    std::mutex mutex;
+    std::condition_variable advanced;
+
+    //The next result to be written
+    uint64_t next_index = 0;
+
+    //Jobs from next_index onwards that workers may start
+    uint64_t size = 0;
+};
+
+/**
+ * Options of the solve command.
+ */
+struct SolveCommand
+{
+    std::vector<std::string> inputs;
+    std::string output_path;
+    uint8_t board_size = 0;
+    uint32_t thread_count = std::max(1u, std::thread::hardware_concurrency());
+    bool ordered = true;
+    bool binary = false;
+    bool progress = true;
+    SolverOptions options;
+};
+
+static void usage()
+{
+    std::cerr << "Usage: taquinsolve [solve] [options] [FILE...]" << std::endl
+              << "       taquinsolve daemon [-S PATH] [-j N] [-p N]" << std::endl
+              << "       taquinsolve generate-databases [-s 4|5] [-d DIR]" << std::endl
+              << std::endl
+              << "Solves one board per line, read from the given files or stdin." << std::endl
+              << "Text output is one line per board: INDEX LENGTH MOVES, or INDEX error MESSAGE." << std::endl
+              << std::endl
+              << "  -s, --size N        Board width/height, guessed from the first board if not given" << std::endl
+              << "  -j, --threads N     Number of solver threads (default: one per core)" << std::endl
+              << "  -o, --output FILE   Write solutions to FILE instead of stdout" << std::endl
+              << "  -u, --unordered     Write solutions as they finish rather than in input order" << std::endl
+              << "  -b, --binary        Write packed binary solutions rather than text" << std::endl
+              << "  -p, --perimeter N   Radius of the goal perimeter database (default 0)" << std::endl
+              << "  -q, --quiet         Don't report progress on stderr" << std::endl
+              << std::endl
+              << "The daemon keeps the databases loaded and solves boards sent by SolverClient." << std::endl
+              << "  -S, --socket PATH   Listen on PATH (default: $TAQUINSOLVE_SOCKET or /tmp/taquinsolve.sock)" << std::endl
+              << std::endl
+              << "generate-databases writes the standard databases for 4x4 (default) or 5x5 boards." << std::endl
+              << "  -d, --directory DIR Write to DIR (default: " << STANDARD_DATABASE_DIRECTORY << ")" << std::endl;
+}
+
+/**
+ * Find the board size from the number of tiles on a line.
+ *
+ * @return The board size, or 0 if the count isn't a supported board.
+ */
+static uint8_t guess_board_size(const std::string &line)
+{
+    size_t tiles = taquin_tokenise_board_string(line).size();
+    for (uint8_t board_size = 2; board_size <= MAX_BOARD_SIZE; board_size++) {
+        if (tiles == (size_t) board_size * board_size) {
+            return board_size;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Read the inputs line by line, queueing a job per board.
+ */
+static void read_inputs(SolveCommand &command, WorkQueue<Job> &jobs)
+{
+    std::vector<std::string> inputs = command.inputs;
+    if (inputs.empty()) {
+        inputs.push_back("-");
+    }
+
+    std::shared_ptr<BoardParser> parser;
+    BoardBatch batch;
+    uint64_t index = 0;
+
+    for (std::string input : inputs) {
+        std::ifstream file;
+        if (input != "-") {
+            file.open(input);
+            if (!file.is_open()) {
+                std::cerr << "Error: unable to open " << input << std::endl;
+                continue;
+            }
+        }
+        std::istream &stream = input == "-" ? std::cin : file;
+
+        std::string line;
+        while (std::getline(stream, line)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+
+            if (parser == NULL) {
+                if (command.board_size == 0) {
+                    command.board_size = guess_board_size(line);
+                    if (command.board_size == 0) {
+                        std::cerr << "Error: unable to guess the board size, use --size." << std::endl;
+                        jobs.close();
+                        return;
+                    }
+                }
+                parser = std::make_shared<BoardParser>(command.board_size);
+            }
+
+            batch.tiles.clear();
+            batch.errors.clear();
+            batch.lines.clear();
+            parser->parse(line, batch);
+
+            Job job;
+            job.index = index++;
+            job.board_size = command.board_size;
+            job.board = batch.tiles;
+            job.error = batch.errors[0];
+            jobs.push(std::move(job));
+        }
+    }
+
+    jobs.close();
+}
+
+/**
+ * Solve jobs until there are none left.
+ * Each worker keeps its own solver, the pattern databases are loaded once and shared.
+ * When writing in order, a job too far ahead of the output waits until the output catches up.
+ */
+static void solve_jobs(SolveCommand &command, WorkQueue<Job> &jobs, WorkQueue<Result> &results, OrderWindow &window)
+{
+    IDASolver solver(command.options);
+    Job job;
+
+    while (jobs.pop(job)) {
+        if (command.ordered) {
+            //Jobs are taken in input order, so the one being waited on is always held by a worker
+            std::unique_lock<std::mutex> lock(window.mutex);
+            window.advanced.wait(lock, [&]() { return job.index < window.next_index + window.size; });
+        }
+
+        Result result;
+        result.index = job.index;
+
+        if (job.error != ParseError::NONE) {
+            result.error = BoardParser::describe(job.error);
+        } else {
+            try {
+                SolveStats stats;
+                solver.solve_into(job.board, job.board_size, result.solution, &stats);
+                result.solved = true;
+                result.nodes_generated = stats.nodes_generated;
+            } catch (std::string e) {
+                result.error = e;
+            }
+        }
+
+        results.push(std::move(result));
+    }
+}
+
+static void write_result(std::ostream &output, const Result &result, bool binary)
+{
+    if (binary) {
+        //Index (8), status (1), solution length (1), then the packed moves
+        uint8_t status = result.solved ? 0 : 1;
+        uint8_t length = result.solution.size();
+        output.write((const char *) &result.index, 8);
+        output.write((const char *) &status, 1);
+        output.write((const char *) &length, 1);
+        output.write((const char *) result.solution.get_data(), result.solution.get_data_size());
+        return;
+    }
+
+    if (result.solved) {
+        output << result.index << ' ' << (int) result.solution.size() << ' ' << result.solution.to_string() << '\n';
+    } else {
+        //Keep each error on a single line
+        std::string error = result.error;
+        std::replace(error.begin(), error.end(), '\n', ' ');
+        output << result.index << " error " << error << '\n';
+    }
+}
+
+static int run_solve(SolveCommand command)
+{
+    std::ofstream file;
+    if (!command.output_path.empty()) {
+        file.open(command.output_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Error: unable to open " << command.output_path << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream &output = command.output_path.empty() ? std::cout : file;
+
+    if (command.binary) {
+        output.write(SOLUTION_MAGIC, sizeof(SOLUTION_MAGIC));
+    }
+
+    size_t queue_depth = QUEUE_DEPTH_PER_THREAD * command.thread_count;
+    WorkQueue<Job> jobs(queue_depth);
+    WorkQueue<Result> results(queue_depth);
+    OrderWindow window;
+    window.size = queue_depth;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::thread reader(read_inputs, std::ref(command), std::ref(jobs));
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < command.thread_count; t++) {
+        workers.push_back(std::thread(solve_jobs, std::ref(command), std::ref(jobs), std::ref(results), std::ref(window)));
+    }
+
+    //Close the results once every worker has finished
+    std::thread closer([&]() {
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+        results.close();
+    });
+
+    //Results that finished ahead of their turn, when writing in order
+    std::map<uint64_t, Result> pending;
+    uint64_t next_index = 0;
+
+    uint64_t solved = 0;
+    uint64_t failed = 0;
+    uint64_t nodes_generated = 0;
+    std::chrono::steady_clock::time_point last_report = start;
+
+    auto seconds_since_start = [&]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    while (!results.is_finished()) {
+        Result result;
+        if (results.pop_for(result, std::chrono::milliseconds(200))) {
+            solved += result.solved;
+            failed += !result.solved;
+            nodes_generated += result.nodes_generated;
+
+            if (!command.ordered) {
+                write_result(output, result, command.binary);
+            } else {
+                pending.emplace(result.index, std::move(result));
+                std::map<uint64_t, Result>::iterator it;
+                while ((it = pending.find(next_index)) != pending.end()) {
+                    write_result(output, it->second, command.binary);
+                    pending.erase(it);
+                    next_index++;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(window.mutex);
+                    window.next_index = next_index;
+                }
+                window.advanced.notify_all();
+            }
+        }
+
+        if (command.progress && std::chrono::steady_clock::now() - last_report > std::chrono::seconds(1)) {
+            last_report = std::chrono::steady_clock::now();
+            double elapsed = seconds_since_start();
+            std::cerr << "\rSolved " << solved << ", failed " << failed
+                      << ", " << std::fixed << std::setprecision(1) << (solved + failed) / elapsed << " boards/s" << std::flush;
+        }
+    }
+
+    reader.join();
+    closer.join();
+    output.flush();
+
+    if (command.progress) {
+        double elapsed = seconds_since_start();
+        std::cerr << "\rSolved " << solved << ", failed " << failed
+                  << " in " << std::fixed << std::setprecision(1) << elapsed << "s, "
+                  << (solved + failed) / elapsed << " boards/s, "
+                  << nodes_generated / elapsed << " nodes/s" << std::endl;
+    }
+
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Read a goal perimeter radius option, checking the whole value before narrowing it.
+ *
+ * @param value     The option's value.
+ * @param radius    Set to the radius if it is accepted.
+ *
+ * @return False, after reporting it, if the value isn't an accepted radius.
+ */
+static bool parse_perimeter_radius(const char *value, uint8_t &radius)
+{
+    char *end;
+    unsigned long parsed = strtoul(value, &end, 10);
+    if (end == value || *end != '\0' || parsed > MAX_PERIMETER_RADIUS) {
+        std::cerr << "Error: the perimeter radius must be 0-" << MAX_PERIMETER_RADIUS << "." << std::endl;
+        return false;
+    }
+
+    radius = parsed;
+    return true;
+}
+
+/**
+ * Read a board size option, checking the whole value before narrowing it.
+ *
+ * @param value         The option's value.
+ * @param board_size    Set to the board size if it is supported.
+ *
+ * @return False, after reporting it, if the value isn't a supported board size.
+ */
+static bool parse_board_size(const char *value, uint8_t &board_size)
+{
+    char *end;
+    unsigned long size = strtoul(value, &end, 10);
+    if (end == value || *end != '\0' || size < 2 || size > MAX_BOARD_SIZE) {
+        std::cerr << "Error: this library only supports board sizes 2-5." << std::endl;
+        return false;
+    }
+
+    board_size = size;
+    return true;
+}
+
+//The daemon being run, stopped by SIGINT and SIGTERM
+static SolverDaemon *running_daemon = NULL;
+
+static void stop_daemon(int)
+{
+    if (running_daemon != NULL) {
+        running_daemon->stop();
+    }
+}
+
+static int run_daemon(int argc, char **argv)
+{
+    std::string socket_path;
+    uint32_t thread_count = std::max(1u, std::thread::hardware_concurrency());
+    SolverOptions options;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if ((arg == "-S" || arg == "--socket") && has_value) {
+            socket_path = argv[++i];
+        } else if ((arg == "-j" || arg == "--threads") && has_value) {
+            thread_count = std::max(1ul, strtoul(argv[++i], NULL, 10));
+        } else if ((arg == "-p" || arg == "--perimeter") && has_value) {
+            if (!parse_perimeter_radius(argv[++i], options.perimeter_radius)) {
+                return EXIT_FAILURE;
+            }
+        } else {
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    SolverDaemon daemon(socket_path, thread_count, options);
+    running_daemon = &daemon;
+    signal(SIGINT, stop_daemon);
+    signal(SIGTERM, stop_daemon);
+
+    try {
+        daemon.run();
+    } catch (std::string e) {
+        std::cerr << "Error: " << e << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    running_daemon = NULL;
+    return EXIT_SUCCESS;
+}
+
+static int run_generate_databases(int argc, char **argv)
+{
+    uint8_t board_size = 4;
+    std::string directory = STANDARD_DATABASE_DIRECTORY;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if ((arg == "-s" || arg == "--size") && i + 1 < argc) {
+            if (!parse_board_size(argv[++i], board_size)) {
+                return EXIT_FAILURE;
+            }
+            if (board_size != 4 && board_size != 5) {
+                std::cerr << "Error: standard pattern databases are only defined for board sizes 4 and 5." << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if ((arg == "-d" || arg == "--directory") && i + 1 < argc) {
+            directory = argv[++i];
+        } else {
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    try {
+        generate_standard_pattern_databases([](std::string database, uint64_t visited, uint8_t depth) {
+            std::cerr << "\r" << database << ": " << visited << " states visited, depth " << (int) depth << std::flush;
+        }, directory, board_size);
+        std::cerr << std::endl;
+    } catch (std::string e) {
+        std::cerr << std::endl << "Error: " << e << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int main (int argc, char **argv)
+{
+    int first = 1;
+    if (argc > 1 && std::string(argv[1]) == "generate-databases") {
+        return run_generate_databases(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "daemon") {
+        return run_daemon(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "solve") {
+        first = 2;
+    }
+
+    SolveCommand command;
+    for (int i = first; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if ((arg == "-s" || arg == "--size") && has_value) {
+            if (!parse_board_size(argv[++i], command.board_size)) {
+                return EXIT_FAILURE;
+            }
+        } else if ((arg == "-j" || arg == "--threads") && has_value) {
+            command.thread_count = std::max(1ul, strtoul(argv[++i], NULL, 10));
+        } else if ((arg == "-o" || arg == "--output") && has_value) {
+            command.output_path = argv[++i];
+        } else if ((arg == "-p" || arg == "--perimeter") && has_value) {
+            if (!parse_perimeter_radius(argv[++i], command.options.perimeter_radius)) {
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "-u" || arg == "--unordered") {
+            command.ordered = false;
+        } else if (arg == "-b" || arg == "--binary") {
+            command.binary = true;
+        } else if (arg == "-q" || arg == "--quiet") {
+            command.progress = false;
+        } else if (arg == "-h" || arg == "--help") {
+            usage();
+            return EXIT_SUCCESS;
+        } else if (arg == "-" || arg[0] != '-') {
+            command.inputs.push_back(arg);
+        } else {
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    return run_solve(command);
+}
@@ -0,0 +1,53 @@
+#include <stdlib.h>
+#include <string>
+#include <iostream>
+#include <experimental/filesystem>
+
+#include "taquinsolve.hh"
+#include "PatternDatabase.hh"
+
+using namespace TaquinSolve;
+
+/**
+ * Build step of --enable-embedded-databases.
+ * Writes the standard databases as dense files for EmbeddedDatabases.cc to link into the library,
+ * converting any found in the source directory and generating the rest.
+ */
+int main (int argc, char **argv)
+{
+    if (argc < 2) {
+        std::cerr << "Usage: generate-embedded-databases OUTPUT_DIRECTORY [SOURCE_DIRECTORY]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::string output_directory = argv[1];
+
+    try {
+        std::experimental::filesystem::create_directories(output_directory);
+
+        for (const StandardDatabase &database : STANDARD_DATABASES) {
+            std::string destination = output_directory + "/" + database.file_name;
+            if (argc < 3 || std::experimental::filesystem::exists(destination)) {
+                continue;
+            }
+
+            std::string source = std::string(argv[2]) + "/" + database.file_name;
+            if (!std::experimental::filesystem::exists(source)) {
+                continue;
+            }
+
+            std::cout << "Converting " << source << ".." << std::endl;
+            PatternDatabase pattern_database(4);
+            pattern_database.add_group(database.group_mask);
+            pattern_database.load(source);
+            pattern_database.save(0, destination);
+        }
+
+        generate_standard_pattern_databases(NULL, output_directory);
+    } catch (std::string e) {
+        std::cerr << "Error: " << e << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -1,13 +1,37 @@
 #include <string>
 #include <algorithm>
 #include <sstream>
+#include <cctype>
 #include <iostream>
 #include <experimental/filesystem>
 #include <math.h>
+#include <mutex>
+#include <chrono>
+#include <random>
+#include <map>
+#include <cstring>
 
 #include "taquinsolve.hh"
 #include "BFSDatabaseGenerator.hh"
 #include "IDASolver.hh"
+#include "ParallelIDASolver.hh"
+#include "AStarSolver.hh"
+#include "ExactTableSolver.hh"
+#include "AutoSolver.hh"
+#include "Trace.hh"
+#include "BoardParser.hh"
+#include "PuzzleGenerator.hh"
+
+//Where solves are captured to, if anywhere.
+static std::mutex trace_mutex;
+static std::shared_ptr<TaquinSolve::TraceWriter> trace_writer = NULL;
+static bool trace_configured = false;
+static std::string trace_error;
+
+//Each thread generates boards from its own generators, one per board size.
+static thread_local std::map<uint8_t, TaquinSolve::PuzzleGenerator> generators;
+static thread_local uint64_t generator_seed = 0;
+static thread_local bool generator_seeded = false;
 
 /**
  * Generate a solvable puzzle with the given board size.
@@ -31,6 +55,7 @@ std::string taquin_generate_string(uint8_t board_size)
 }
 /**
  * Generate a solvable puzzle with the given board size.
+ * Boards are drawn uniformly from all solvable boards, see TaquinSolve::PuzzleGenerator.
  *
  * @param board_size The desired board size.
  *
@@ -38,24 +63,30 @@ std::string taquin_generate_string(uint8_t board_size)
  */
 std::vector<uint8_t> taquin_generate_vector(uint8_t board_size)
 {
-    //Create a uniform board of the required size
-    uint8_t len = board_size * board_size;
-    std::vector<uint8_t> board;
-
-    for (uint8_t i=0; i<len; i++) {
-        board.push_back(i);
+    std::map<uint8_t, TaquinSolve::PuzzleGenerator>::iterator it = generators.find(board_size);
+    if (it == generators.end()) {
+        uint64_t seed = generator_seed + board_size;
+        if (!generator_seeded) {
+            std::random_device seed_source;
+            seed = ((uint64_t) seed_source() << 32) | seed_source();
+        }
+        it = generators.emplace(board_size, TaquinSolve::PuzzleGenerator(board_size, seed)).first;
     }
 
-    //Shuffle the board
-    std::random_shuffle(board.begin(), board.end());
-
-    //Check for solvability
-    if (!taquin_check_solvable(board, board_size)) {
-        //Modify if it's not solvable
-        std::iter_swap(board.end()-3, board.end()-1);
-    }
+    return it->second.generate();
+}
 
-    return board;
+/**
+ * Seed the generator used by taquin_generate_vector and taquin_generate_string on the calling thread.
+ * Without a seed each thread's generator is seeded from the system.
+ *
+ * @param seed The seed, the same seed gives the same sequence of boards.
+ */
+void taquin_set_generator_seed(uint64_t seed)
+{
+    generators.clear();
+    generator_seed = seed;
+    generator_seeded = true;
 }
 
 
@@ -79,33 +110,19 @@ bool taquin_check_solvable(std::string board_string, uint8_t board_size)
  *
  * @return True if the board is solvable.
  */
-bool taquin_check_solvable(std::vector<uint8_t> board, uint8_t board_size)
+bool taquin_check_solvable(const std::vector<uint8_t> &board, uint8_t board_size)
 {
-    //Check if we have the right number of tokens.
-    if (board.size() != pow(board_size, 2)) {
+    //Check if the board size is valid (2-5).
+    if (board_size < 2 || board_size > TaquinSolve::MAX_BOARD_SIZE) {
         return false;
     }
 
-    //Check if the board size is valid (2-4).
-    if (board_size < 2 || board_size > 4) {
+    //Check if we have the right number of tokens.
+    if (board.size() != (size_t) board_size * board_size) {
         return false;
     }
 
-    uint8_t len = board_size * board_size;
-    uint8_t inversion_count = taquin_get_inversion_count(board, board_size);
-    uint8_t zero_position = 0;
-    for (uint8_t i=0; i<len; i++) {
-        if (board.at(i) == 0) {
-            zero_position = i;
-            break;
-        }
-    }
-
-    if (board_size % 2 == 0 && (zero_position/board_size) % 2 == 0) {
-        return inversion_count % 2 == 1;
-    }
-
-    return inversion_count % 2 == 0;
+    return TaquinSolve::BoardParser::validate(board.data(), board_size) == TaquinSolve::ParseError::NONE;
 }
 
 /**
@@ -117,14 +134,14 @@ bool taquin_check_solvable(std::vector<uint8_t> board, uint8_t board_size)
  *
  * @return the number of inversions
  */
-uint8_t taquin_get_inversion_count(std::vector<uint8_t> board, uint8_t board_size)
+uint8_t taquin_get_inversion_count(const std::vector<uint8_t> &board, uint8_t board_size)
 {
     uint8_t len = board.size();
     uint8_t inversion_count = 0;
     for (uint8_t i=0; i<len; i++) {
         for (uint8_t j=i+1; j<len; j++) {
-            if (board.at(j) !=0) {
-                inversion_count += (board.at(i) > board.at(j));
+            if (board[j] !=0) {
+                inversion_count += (board[i] > board[j]);
             }
         }
     }
@@ -142,14 +159,28 @@ uint8_t taquin_get_inversion_count(std::vector<uint8_t> board, uint8_t board_siz
 std::vector<uint8_t> taquin_tokenise_board_string(std::string str, char sep)
 {
     std::vector<uint8_t> ret;
+    ret.reserve(16);
+
+    //A trailing separator doesn't start another token, an empty token reads as 0.
+    size_t start = 0;
+    while (start < str.size()) {
+        size_t end = str.find(sep, start);
+        if (end == std::string::npos) {
+            end = str.size();
+        }
+
+        size_t i = start;
+        while (i < end && isspace(str[i])) {
+            i++;
+        }
 
-    std::istringstream stm(str);
-    std::string token;
-    while( std::getline( stm, token, sep ) ) {
-        std::stringstream sstream(token);
-        unsigned int result;
-        sstream >> result;
+        unsigned int result = 0;
+        while (i < end && str[i] >= '0' && str[i] <= '9') {
+            result = result * 10 + (str[i++] - '0');
+        }
         ret.push_back((uint8_t)result);
+
+        start = end + 1;
     }
 
     return ret;
@@ -161,15 +192,19 @@ std::vector<uint8_t> taquin_tokenise_board_string(std::string str, char sep)
  * @param board_string                      A board represented as a string e.g. "3 1 0 2"
  * @param board_size                        The size of the given board e.g. 2 for the above example.
  * @param TaquinSolve::Algorithm algorithm  The algorithm to use to solve the puzzle.
+ * @param TaquinSolve::SolverOptions options Tunable parameters for the solver.
+ * @param TaquinSolve::SolveStats stats     If given, filled with a description of the work done.
  *
  * @return A queue of moves taken to reach the solution.
  */
 std::queue<TaquinSolve::Moves> taquin_solve(
     std::string board_string,
     uint8_t board_size,
-    TaquinSolve::Algorithm algorithm
+    TaquinSolve::Algorithm algorithm,
+    TaquinSolve::SolverOptions options,
+    TaquinSolve::SolveStats *stats
 ) {
-    return taquin_solve(taquin_tokenise_board_string(board_string), board_size, algorithm);
+    return taquin_solve(taquin_tokenise_board_string(board_string), board_size, algorithm, options, stats);
 }
 
 /**
@@ -178,24 +213,177 @@ std::queue<TaquinSolve::Moves> taquin_solve(
  * @param board                             A board represented as a vector.
  * @param board_size                        The size of the given board
  * @param TaquinSolve::Algorithm algorithm  The algorithm to use to solve the puzzle.
+ * @param TaquinSolve::SolverOptions options Tunable parameters for the solver.
+ * @param TaquinSolve::SolveStats stats     If given, filled with a description of the work done.
  *
  * @return A queue of moves taken to reach the solution.
  */
 std::queue<TaquinSolve::Moves> taquin_solve(
     std::vector<uint8_t> board,
     uint8_t board_size,
-    TaquinSolve::Algorithm algorithm
+    TaquinSolve::Algorithm algorithm,
+    TaquinSolve::SolverOptions options,
+    TaquinSolve::SolveStats *stats
+) {
+    TaquinSolve::MoveSequence solution;
+    taquin_solve_into(board, board_size, solution, algorithm, options, stats);
+    return solution.to_queue();
+}
+
+/**
+ * Solve the given puzzle vector into a caller provided move sequence.
+ * Nothing is allocated to return the solution.
+ *
+ * @param board                             A board represented as a vector.
+ * @param board_size                        The size of the given board
+ * @param TaquinSolve::MoveSequence solution Filled with the moves taken to reach the solution.
+ * @param TaquinSolve::Algorithm algorithm  The algorithm to use to solve the puzzle.
+ * @param TaquinSolve::SolverOptions options Tunable parameters for the solver.
+ * @param TaquinSolve::SolveStats stats     If given, filled with a description of the work done.
+ */
+void taquin_solve_into(
+    std::vector<uint8_t> board,
+    uint8_t board_size,
+    TaquinSolve::MoveSequence &solution,
+    TaquinSolve::Algorithm algorithm,
+    TaquinSolve::SolverOptions options,
+    TaquinSolve::SolveStats *stats
 ) {
     std::unique_ptr<TaquinSolve::Solver> solver;
 
     switch (algorithm) {
+        case TaquinSolve::Algorithm::AUTO:
+            solver = std::make_unique<TaquinSolve::AutoSolver>(options);
+            break;
+        case TaquinSolve::Algorithm::EXACT_TABLE:
+            solver = std::make_unique<TaquinSolve::ExactTableSolver>(options);
+            break;
+        case TaquinSolve::Algorithm::ASTAR:
+            solver = std::make_unique<TaquinSolve::AStarSolver>(options);
+            break;
+        case TaquinSolve::Algorithm::PARALLEL_IDA:
+            solver = std::make_unique<TaquinSolve::ParallelIDASolver>(options);
+            break;
         case TaquinSolve::Algorithm::IDA:
         default:
-            solver = std::make_unique<TaquinSolve::IDASolver>();
+            solver = std::make_unique<TaquinSolve::IDASolver>(options);
             break;
     }
 
-    return solver->solve(board, board_size);
+    std::shared_ptr<TaquinSolve::TraceWriter> writer = taquin_get_trace_writer();
+    if (writer == NULL) {
+        solver->solve_into(board, board_size, solution, stats);
+        return;
+    }
+
+    //Capture the solve, recording failures before passing them on.
+    TaquinSolve::SolveStats local_stats;
+    if (stats == NULL) {
+        stats = &local_stats;
+    }
+
+    TaquinSolve::TraceRecord record;
+    record.board_size = board_size;
+    record.board = board;
+    record.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    try {
+        solver->solve_into(board, board_size, solution, stats);
+    } catch (...) {
+        record.outcome = TaquinSolve::TraceOutcome::FAILED;
+        record.solve_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        writer->write(record);
+        throw;
+    }
+
+    record.solve_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    record.solution_length = solution.size();
+    record.nodes_generated = stats->nodes_generated;
+    writer->write(record);
+}
+
+/**
+ * Start loading the pattern databases of a board size in the background, so the first solve doesn't wait for them.
+ * Solves made while they load use the other heuristics and switch over once they are ready.
+ * Loading the 4x4 databases also starts when the library is loaded if the TAQUINSOLVE_WARM_UP environment variable is set to 1.
+ *
+ * @param use_huge_pages    Whether to back the tables with huge pages, matching SolverOptions::use_huge_pages.
+ * @param wait              Return only once the databases are loaded.
+ * @param board_size        The board size to load the databases of, 4 or 5. Nothing is loaded for 5x5 unless its databases are installed.
+ */
+void taquin_warm_up(bool use_huge_pages, bool wait, uint8_t board_size)
+{
+    TaquinSolve::Solver::start_pattern_database_load(use_huge_pages, board_size);
+    if (wait) {
+        TaquinSolve::Solver::wait_for_pattern_database_load(use_huge_pages, board_size);
+    }
+}
+
+//Warm up as soon as the library is loaded if asked to
+static bool warmed_up_at_load = []() {
+    const char *warm_up = getenv("TAQUINSOLVE_WARM_UP");
+    if (warm_up != NULL && std::string(warm_up) == "1") {
+        taquin_warm_up();
+        return true;
+    }
+    return false;
+}();
+
+/**
+ * Capture every following solve to the given trace file, or stop capturing.
+ * Capturing can also be enabled by setting the TAQUINSOLVE_TRACE environment variable to a path.
+ *
+ * @param path The trace file to append to, or an empty string to disable capturing.
+ */
+void taquin_set_trace_file(std::string path)
+{
+    std::lock_guard<std::mutex> lock(trace_mutex);
+
+    trace_configured = true;
+    trace_writer = NULL;
+    trace_error.clear();
+    if (!path.empty()) {
+        trace_writer = std::make_shared<TaquinSolve::TraceWriter>(path);
+    }
+}
+
+/**
+ * Fetch the writer solves are captured with.
+ * The first call reads the TAQUINSOLVE_TRACE environment variable if no file was set.
+ * A trace file that can't be opened leaves capturing disabled rather than failing the solve,
+ * the reason is reported once on stderr and kept for taquin_get_trace_error().
+ *
+ * @return The trace writer, or NULL if capturing is disabled.
+ */
+std::shared_ptr<TaquinSolve::TraceWriter> taquin_get_trace_writer()
+{
+    std::lock_guard<std::mutex> lock(trace_mutex);
+
+    if (!trace_configured) {
+        trace_configured = true;
+
+        const char *path = getenv("TAQUINSOLVE_TRACE");
+        if (path != NULL && path[0] != '\0') {
+            try {
+                trace_writer = std::make_shared<TaquinSolve::TraceWriter>(path);
+            } catch (std::string e) {
+                trace_error = e;
+                std::cerr << "taquinsolve: " << e << ", solves are not traced." << std::endl;
+            }
+        }
+    }
+
+    return trace_writer;
+}
+
+/**
+ * @return Why the TAQUINSOLVE_TRACE file couldn't be opened, empty if it was or none was set.
+ */
+std::string taquin_get_trace_error()
+{
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    return trace_error;
 }
 
 /**
@@ -213,33 +401,65 @@ void generate_pattern_database(std::vector<uint8_t> goal_board, std::set<uint8_t
 }
 
 /**
- * Generate a set of pattern databases using 6-6-3 partitioning.
- * Generated files are placed in /usr/local/share/libtaquinsolve
+ * Generate a set of pattern databases using 6-6-3 partitioning for 4x4 boards, or 6-6-6-6 partitioning for 5x5 boards.
+ * Each 5x5 database takes about 3GB of memory and a few hours of a single core to generate.
  *
- * @param goal_board    A goal board represented as a vector.
- * @param board_size    The size of the given goal board.
+ * @param progress      If given, called every so often with the database being generated,
+ *                      the number of states visited and the depth reached.
+ * @param directory     The directory to write the databases to, STANDARD_DATABASE_DIRECTORY by default,
+ *                      where solvers look for them.
+ * @param board_size    The board size to generate the databases of, 4 or 5.
  */
-void generate_standard_pattern_databases()
+void generate_standard_pattern_databases(std::function<void(std::string database, uint64_t visited, uint8_t depth)> progress, std::string directory, uint8_t board_size)
 {
-    std::experimental::filesystem::create_directory("/usr/local/share/libtaquinsolve");
+    if (board_size != 4 && board_size != 5) {
+        throw std::string("Standard pattern databases are only defined for board sizes 4 and 5.");
+    }
+
+    std::experimental::filesystem::create_directory(directory);
 
     TaquinSolve::BFSDatabaseGenerator generator;
-    std::vector<uint8_t> goal_board = taquin_tokenise_board_string("1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 0");
+    std::vector<uint8_t> goal_board;
+    for (uint8_t i = 1; i < board_size * board_size; i++) {
+        goal_board.push_back(i);
+    }
+    goal_board.push_back(0);
+
+    std::string database;
+    if (progress) {
+        generator.set_progress_callback([&](uint64_t visited, uint8_t depth) {
+            progress(database, visited, depth);
+        });
+    }
+
+    if (board_size == 5) {
+        for (const TaquinSolve::StandardDatabase &standard : TaquinSolve::STANDARD_DATABASES_5X5) {
+            std::set<uint8_t> group_tiles;
+            for (uint8_t tile = 1; tile < 25; tile++) {
+                if (standard.group_mask & (1u << tile)) {
+                    group_tiles.insert(tile);
+                }
+            }
+
+            database = std::string(standard.file_name).substr(0, strlen(standard.file_name) - strlen(".db.bin"));
+            std::cout << "Generating " << database << ".." << std::endl;
+            generator.generate(goal_board, group_tiles, 5, directory + "/" + standard.file_name);
+        }
+        return;
+    }
 
     std::cout << "Generating 234.." << std::endl;
+    database = "234";
     std::set<uint8_t> group_tiles = {2,3,4};
-    generator.generate(goal_board, group_tiles, 4, "/usr/local/share/libtaquinsolve/234.db.bin");
+    generator.generate(goal_board, group_tiles, 4, directory + "/234.db.bin");
 
     std::cout << "Generating 15671013.." << std::endl;
+    database = "15691013";
     group_tiles = {1,5,6,9,10,13};
-    generator.generate(goal_board, group_tiles, 4, "/usr/local/share/libtaquinsolve/15691013.db.bin");
+    generator.generate(goal_board, group_tiles, 4, directory + "/15691013.db.bin");
 
     std::cout << "Generating 7811121415.." << std::endl;
+    database = "7811121415";
     group_tiles = {7,8,11,12,14,15};
-    generator.generate(goal_board, group_tiles, 4, "/usr/local/share/libtaquinsolve/7811121415.db.bin");
+    generator.generate(goal_board, group_tiles, 4, directory + "/7811121415.db.bin");
 }
-
-/**
- * I found this stub neccessary to satisfy an AC_CHECK_LIB macro in autotools.
- */
-extern "C" int taquin_solve_c_stub() {}
@@ -0,0 +1,91 @@
+#ifndef TAQUINSOLVE_H
+#define TAQUINSOLVE_H
+
+/**
+ * The C interface, for callers going through FFI.
+ *
+ * A solver handle owns its scratch memory and is reused across solves. Handles share the pattern databases,
+ * which are loaded by the first 4x4 solve. A handle must only be used by one thread at a time.
+ * No C++ exception crosses this interface, failures are returned as negated status codes.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//Moves of the empty tile, one byte each in a solution buffer
+#define TAQUIN_MOVE_UP      0
+#define TAQUIN_MOVE_DOWN    1
+#define TAQUIN_MOVE_LEFT    2
+#define TAQUIN_MOVE_RIGHT   3
+
+//Status codes
+#define TAQUIN_OK                       0
+#define TAQUIN_ERROR_INVALID_ARGUMENT   1
+#define TAQUIN_ERROR_INVALID_BOARD      2
+#define TAQUIN_ERROR_UNSOLVABLE         3
+#define TAQUIN_ERROR_BUFFER_TOO_SMALL   4
+#define TAQUIN_ERROR_SOLVER             5
+#define TAQUIN_ERROR_OUT_OF_MEMORY      6
+
+typedef struct taquin_solver taquin_solver;
+
+typedef struct taquin_solver_config
+{
+    //The radius of the goal perimeter database, 0 disables it
+    uint8_t perimeter_radius;
+
+    //Non-zero to back the pattern database tables with huge pages where supported
+    uint8_t use_huge_pages;
+
+    //The board counted as solved, NULL for the standard goal (1..N-1 followed by 0)
+    const uint8_t *goal_board;
+    size_t goal_board_length;
+} taquin_solver_config;
+
+typedef struct taquin_solve_stats
+{
+    uint64_t nodes_expanded;
+    uint64_t nodes_generated;
+    uint64_t transposition_hits;
+    uint64_t pdb_lookups;
+
+    //Wall time of each phase, in microseconds
+    uint64_t database_load_time;
+    uint64_t validation_time;
+    uint64_t search_time;
+
+    uint32_t iterations;
+    uint8_t initial_heuristic;
+    uint8_t solution_length;
+} taquin_solve_stats;
+
+void taquin_solver_config_init(taquin_solver_config *config);
+
+taquin_solver *taquin_solver_create(const taquin_solver_config *config);
+
+int taquin_solve_into(
+    taquin_solver *solver,
+    const uint8_t *board,
+    uint8_t board_size,
+    uint8_t *moves,
+    size_t capacity,
+    taquin_solve_stats *stats
+);
+
+const char *taquin_solver_last_error(const taquin_solver *solver);
+const char *taquin_status_string(int status);
+
+void taquin_solver_destroy(taquin_solver *solver);
+
+//Kept for configure scripts checking for the library with AC_CHECK_LIB
+int taquin_solve_c_stub(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,6 +4,9 @@
 #include <set>
 #include <vector>
 #include <queue>
+#include <memory>
+#include <functional>
+#include <cstdint>
 
 namespace TaquinSolve
 {
@@ -19,33 +22,178 @@ namespace TaquinSolve
 
     enum Algorithm
     {
-        IDA
+        IDA,
+
+        //Picks one of the others per board, see AlgorithmPolicy
+        AUTO,
+
+        //Reads the path out of a table of every board's distance, 2x2 and 3x3 only
+        EXACT_TABLE,
+
+        //A* with a limit on the boards held, falling back on IDA* past it
+        ASTAR,
+
+        //IDA* with the subtrees below a shallow frontier shared between threads
+        PARALLEL_IDA
+    };
+
+    /**
+     * The thresholds Algorithm::AUTO picks an engine by, tunable with bench-solve --algorithm.
+     * Estimates are the initial heuristic of the board, with the pattern databases if they are loaded.
+     */
+    struct AlgorithmPolicy
+    {
+        //Boards up to this size are read from an exact distance table
+        uint8_t exact_table_max_size = 3;
+
+        //Boards estimated at most this many moves away are solved with A*
+        uint8_t astar_max_heuristic = 36;
+
+        //Boards estimated at least this many moves away are solved with parallel IDA*, given more than one thread
+        uint8_t parallel_min_heuristic = 44;
+
+        //While the pattern databases aren't loaded, boards estimated below this are solved without them
+        uint8_t pattern_database_min_heuristic = 36;
     };
+
+    /**
+     * Tunable parameters given to a solver.
+     */
+    struct SolverOptions
+    {
+        //The radius of the goal perimeter database, 0 disables it.
+        uint8_t perimeter_radius = 0;
+
+        //Back the pattern database tables with huge pages where supported.
+        bool use_huge_pages = false;
+
+        //If the pattern databases aren't loaded yet, load them in the background rather than waiting.
+        //The search starts on the other heuristics and switches over between iterations once they are ready.
+        //Solves also never wait while a load started by taquin_warm_up is running.
+        bool background_database_load = false;
+
+        //The board state counted as solved, empty for the standard goal (1..N-1 followed by 0).
+        std::vector<uint8_t> goal_board;
+
+        //Load the pattern databases for 4x4 boards, and 5x5 boards if their databases are installed,
+        //otherwise search with the heuristics needing none.
+        bool use_pattern_databases = true;
+
+        //The most boards IDA* remembers the cost of to prune transpositions, 0 for no limit.
+        //Deep 5x5 searches would otherwise fill memory, past the limit boards are searched without the check.
+        uint32_t visited_cache_limit = 1 << 22;
+
+        //The most boards Algorithm::ASTAR holds before falling back on IDA*.
+        uint32_t astar_node_limit = 1 << 20;
+
+        //Threads used by Algorithm::PARALLEL_IDA, 0 for one per hardware thread.
+        uint32_t search_threads = 0;
+
+        //How Algorithm::AUTO picks an engine.
+        AlgorithmPolicy algorithm_policy;
+    };
+
+    /**
+     * Counters for one iteration of an IDA* search.
+     */
+    struct IterationStats
+    {
+        //The cost bound searched to
+        uint32_t bound = 0;
+
+        //Boards whose neighbours were generated
+        uint64_t nodes_expanded = 0;
+
+        //Boards created by applying a move
+        uint64_t nodes_generated = 0;
+    };
+
+    /**
+     * A description of the work done by one solve.
+     */
+    struct SolveStats
+    {
+        //One entry per search iteration, in order
+        std::vector<IterationStats> iterations;
+
+        //Totals over all iterations
+        uint64_t nodes_expanded = 0;
+        uint64_t nodes_generated = 0;
+
+        //Generated boards already found in the visited cache
+        uint64_t transposition_hits = 0;
+
+        //Pattern database table probes, one per group per evaluated board
+        uint64_t pdb_lookups = 0;
+
+        //Wall time of each phase, in microseconds
+        uint64_t database_load_time = 0;
+        uint64_t validation_time = 0;
+        uint64_t search_time = 0;
+
+        //The most search memory held at once, in bytes
+        uint64_t arena_high_water = 0;
+
+        //The iteration that switched to the pattern databases after they finished loading, 0 if it didn't
+        uint32_t database_upgrade_iteration = 0;
+
+        //The engine that found the solution, differs from the one asked for with AUTO or after an A* fallback
+        Algorithm algorithm = Algorithm::IDA;
+
+        //The heuristic of the initial board compared to the length of the solution found
+        uint8_t initial_heuristic = 0;
+        uint8_t solution_length = 0;
+    };
+
+    //Where the standard pattern databases are installed, and generated by default.
+    const char STANDARD_DATABASE_DIRECTORY[] = "/usr/local/share/libtaquinsolve";
+
+    class TraceWriter;
+    class MoveSequence;
 }
 
 std::vector<uint8_t> taquin_tokenise_board_string(std::string str, char sep = ' ');
 
 std::string taquin_generate_string(uint8_t board_size);
 std::vector<uint8_t> taquin_generate_vector(uint8_t board_size);
+void taquin_set_generator_seed(uint64_t seed);
 
-uint8_t taquin_get_inversion_count(std::vector<uint8_t> board, uint8_t board_size);
+uint8_t taquin_get_inversion_count(const std::vector<uint8_t> &board, uint8_t board_size);
 
-bool taquin_check_solvable(std::vector<uint8_t> board, uint8_t board_size);
+bool taquin_check_solvable(const std::vector<uint8_t> &board, uint8_t board_size);
 bool taquin_check_solvable(std::string board, uint8_t board_size);
 
 std::queue<TaquinSolve::Moves> taquin_solve(
     std::string board_string,
     uint8_t board_size,
-    TaquinSolve::Algorithm algorithm = TaquinSolve::Algorithm::IDA
+    TaquinSolve::Algorithm algorithm = TaquinSolve::Algorithm::IDA,
+    TaquinSolve::SolverOptions options = TaquinSolve::SolverOptions(),
+    TaquinSolve::SolveStats *stats = NULL
 );
 
 std::queue<TaquinSolve::Moves> taquin_solve(
     std::vector<uint8_t> board,
     uint8_t board_size,
-    TaquinSolve::Algorithm algorithm = TaquinSolve::Algorithm::IDA
+    TaquinSolve::Algorithm algorithm = TaquinSolve::Algorithm::IDA,
+    TaquinSolve::SolverOptions options = TaquinSolve::SolverOptions(),
+    TaquinSolve::SolveStats *stats = NULL
 );
 
+void taquin_solve_into(
+    std::vector<uint8_t> board,
+    uint8_t board_size,
+    TaquinSolve::MoveSequence &solution,
+    TaquinSolve::Algorithm algorithm = TaquinSolve::Algorithm::IDA,
+    TaquinSolve::SolverOptions options = TaquinSolve::SolverOptions(),
+    TaquinSolve::SolveStats *stats = NULL
+);
+
+void taquin_warm_up(bool use_huge_pages = false, bool wait = false, uint8_t board_size = 4);
+
+void taquin_set_trace_file(std::string path);
+std::shared_ptr<TaquinSolve::TraceWriter> taquin_get_trace_writer();
+std::string taquin_get_trace_error();
+
 void generate_pattern_database(std::vector<uint8_t> goal_board, std::set<uint8_t> group_tiles, uint8_t board_size, std::string output_file);
-void generate_standard_pattern_databases();
+void generate_standard_pattern_databases(std::function<void(std::string database, uint64_t visited, uint8_t depth)> progress = NULL, std::string directory = TaquinSolve::STANDARD_DATABASE_DIRECTORY, uint8_t board_size = 4);
 
-extern "C" int taquin_solve_c_stub();
@@ -0,0 +1,177 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string>
+#include <queue>
+#include <cstdio>
+
+#include <taquinsolve.hh>
+#include <Board.hh>
+#include <PatternDatabase.hh>
+#include <BFSDatabaseGenerator.hh>
+#include <PuzzleGenerator.hh>
+#include <ExactTableSolver.hh>
+#include <ParallelIDASolver.hh>
+#include <AStarSolver.hh>
+
+using namespace TaquinSolve;
+
+static const std::string goal_5x5 = "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 0";
+
+/**
+ * Apply the moves and check they reach the standard goal.
+ */
+static bool reaches_goal(std::vector<uint8_t> board, uint8_t board_size, std::queue<Moves> moves)
+{
+    Board *current = new Board(board, board_size);
+    while (!moves.empty()) {
+        Board *next = current->perform_move(moves.front());
+        delete current;
+        current = next;
+        moves.pop();
+    }
+
+    bool solved = current->check_solved();
+    delete current;
+    return solved;
+}
+
+/**
+ * Sum the distances of the given tiles from their goal cells.
+ */
+static uint8_t group_manhattan(const std::vector<uint8_t> &board, uint8_t board_size, std::set<uint8_t> group_tiles)
+{
+    uint8_t distance = 0;
+    for (uint8_t cell = 0; cell < board.size(); cell++) {
+        if (group_tiles.count(board[cell])) {
+            uint8_t goal = board[cell] - 1;
+            distance += abs(cell / board_size - goal / board_size) + abs(cell % board_size - goal % board_size);
+        }
+    }
+    return distance;
+}
+
+static void test_24_puzzle_boards()
+{
+    std::vector<uint8_t> goal = taquin_tokenise_board_string(goal_5x5);
+
+    Board solved(goal, 5);
+    solved.validate_state();
+    assert(solved.check_solved());
+    assert(taquin_check_solvable(goal_5x5, 5));
+    assert(!taquin_check_solvable("2 1 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 0", 5));
+    assert(!taquin_check_solvable(goal_5x5, 6));
+
+    //Five bits per cell, so the last cells land past the low 64 bits
+    std::vector<uint8_t> swapped = goal;
+    std::swap(swapped[22], swapped[23]);
+    assert(Board(swapped, 5).get_state_hash() != solved.get_state_hash());
+    assert((uint64_t) Board(swapped, 5).get_state_hash() == (uint64_t) solved.get_state_hash());
+
+    uint8_t cells[MAX_CELLS];
+    Board::unpack_state_hash(Board(swapped, 5).get_state_hash(), 25, cells);
+    assert(std::vector<uint8_t>(cells, cells + 25) == swapped);
+
+    //Smaller boards keep their four bit hashes
+    assert(Board(taquin_tokenise_board_string("1 2 3 4 5 6 7 8 0"), 3).get_state_hash() == 0x87654321);
+
+    //Uniform boards cover every tile
+    PuzzleGenerator generator(5, 7);
+    for (uint32_t i = 0; i < 100; i++) {
+        std::vector<uint8_t> board = generator.generate();
+        assert(taquin_check_solvable(board, 5));
+    }
+}
+
+static void test_24_puzzle_solve()
+{
+    PuzzleGenerator generator(5, 11);
+    std::vector<uint8_t> board = generator.generate_walk(30);
+
+    SolverOptions options;
+    options.use_pattern_databases = false;
+    options.search_threads = 2;
+
+    SolveStats stats;
+    std::queue<Moves> moves = IDASolver(options).solve(board, 5, &stats);
+    assert(reaches_goal(board, 5, moves));
+    assert(moves.size() <= 30 && moves.size() >= stats.initial_heuristic);
+
+    assert(ParallelIDASolver(options).solve(board, 5).size() == moves.size());
+    assert(AStarSolver(options).solve(board, 5).size() == moves.size());
+    assert(taquin_solve(board, 5, Algorithm::AUTO, options).size() == moves.size());
+}
+
+static void test_dense_generation()
+{
+    BFSDatabaseGenerator generator;
+
+    //With every tile in the group the costs are the exact distances
+    std::remove("./dense-123.db.bin");
+    generator.generate_dense(taquin_tokenise_board_string("1 2 3 0"), {1, 2, 3}, 2, "./dense-123.db.bin", 2);
+    std::shared_ptr<PatternDatabase> exact(new PatternDatabase(2));
+    exact->add_group(0x000E);
+    exact->load("./dense-123.db.bin");
+
+    ExactTableSolver exact_solver;
+    uint8_t tiles[4];
+    for (uint64_t rank = 0; rank < PuzzleGenerator::get_permutation_count(2); rank++) {
+        PuzzleGenerator::unrank(rank, 2, tiles);
+        std::vector<uint8_t> board(tiles, tiles + 4);
+        if (taquin_check_solvable(board, 2)) {
+            assert(Board(board, 2, exact).get_pattern_db_heuristic() == exact_solver.solve(board, 2).size());
+        }
+    }
+
+    //Never above the sparse generator, never below the group's Manhattan distance
+    std::remove("./dense-1234.db.bin");
+    std::remove("./sparse-1234.db.bin");
+    std::vector<uint8_t> goal_3x3 = taquin_tokenise_board_string("1 2 3 4 5 6 7 8 0");
+    generator.generate_dense(goal_3x3, {1, 2, 3, 4}, 3, "./dense-1234.db.bin");
+    generator.generate(goal_3x3, {1, 2, 3, 4}, 3, "./sparse-1234.db.bin");
+
+    std::shared_ptr<PatternDatabase> dense(new PatternDatabase(3));
+    dense->add_group(0x001E);
+    dense->load("./dense-1234.db.bin");
+    std::shared_ptr<PatternDatabase> sparse(new PatternDatabase(3));
+    sparse->add_group(0x001E);
+    sparse->load("./sparse-1234.db.bin");
+
+    PuzzleGenerator puzzles(3, 3);
+    for (uint32_t i = 0; i < 1000; i++) {
+        std::vector<uint8_t> board = puzzles.generate();
+        uint8_t cost = Board(board, 3, dense).get_pattern_db_heuristic();
+        assert(cost <= Board(board, 3, sparse).get_pattern_db_heuristic());
+        assert(cost >= group_manhattan(board, 3, {1, 2, 3, 4}));
+    }
+}
+
+static void test_24_puzzle_database()
+{
+    BFSDatabaseGenerator generator;
+    std::remove("./dense-5x5-123.db.bin");
+    generator.generate_dense(taquin_tokenise_board_string(goal_5x5), {1, 2, 3}, 5, "./dense-5x5-123.db.bin");
+
+    std::shared_ptr<PatternDatabase> pattern_database(new PatternDatabase(5));
+    pattern_database->add_group(0x000E);
+    pattern_database->load("./dense-5x5-123.db.bin");
+
+    SolverOptions options;
+    options.use_pattern_databases = false;
+    PuzzleGenerator puzzles(5, 5);
+    for (uint32_t i = 0; i < 5; i++) {
+        std::vector<uint8_t> board = puzzles.generate_walk(24);
+        uint8_t cost = Board(board, 5, pattern_database).get_pattern_db_heuristic();
+        assert(cost >= group_manhattan(board, 5, {1, 2, 3}));
+        assert(cost <= IDASolver(options).solve(board, 5).size());
+    }
+}
+
+int main (void)
+{
+    test_24_puzzle_boards();
+    test_24_puzzle_solve();
+    test_dense_generation();
+    test_24_puzzle_database();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,179 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string>
+#include <queue>
+#include <algorithm>
+
+#include <taquinsolve.hh>
+#include <ExactTableSolver.hh>
+#include <AStarSolver.hh>
+#include <ParallelIDASolver.hh>
+#include <AutoSolver.hh>
+
+using namespace TaquinSolve;
+
+static const std::string puzzle_3x3 = "4 5 7 2 8 0 6 1 3";
+static const std::string puzzle_4x4 = "6 8 15 4 1 2 3 0 9 5 10 7 14 13 11 12";
+static const std::string near_4x4 = "1 2 3 4 5 6 7 8 9 10 11 12 13 14 0 15";
+static const std::string unsolvable_3x3 = "1 2 3 4 5 6 8 7 0";
+
+/**
+ * Apply the moves and check they reach the standard goal.
+ */
+static bool reaches_goal(std::string board, uint8_t board_size, std::queue<Moves> moves)
+{
+    Board *current = new Board(taquin_tokenise_board_string(board), board_size);
+    while (!moves.empty()) {
+        Board *next = current->perform_move(moves.front());
+        delete current;
+        current = next;
+        moves.pop();
+    }
+
+    bool solved = current->check_solved();
+    delete current;
+    return solved;
+}
+
+static bool throws_unsolvable(Solver &solver)
+{
+    try {
+        solver.solve(taquin_tokenise_board_string(unsolvable_3x3), 3);
+    } catch (std::string e) {
+        return true;
+    }
+    return false;
+}
+
+static void test_exact_table()
+{
+    ExactTableSolver solver;
+    SolveStats stats;
+
+    std::queue<Moves> moves = solver.solve(taquin_tokenise_board_string(puzzle_3x3), 3, &stats);
+    assert(moves.size() == 27);
+    assert(reaches_goal(puzzle_3x3, 3, moves));
+    assert(stats.algorithm == Algorithm::EXACT_TABLE);
+    assert(stats.initial_heuristic == 27);
+
+    //Half the permutations are unsolvable and left out of the table
+    const std::vector<uint8_t> &table = ExactTableSolver::get_table(3);
+    assert(table.size() == 362880);
+    assert(std::count(table.begin(), table.end(), UINT8_MAX) == 181440);
+
+    //The two hardest boards are 31 moves away
+    assert(std::count(table.begin(), table.end(), 31) == 2);
+    assert(std::count_if(table.begin(), table.end(), [](uint8_t distance) { return distance > 31 && distance != UINT8_MAX; }) == 0);
+
+    assert(solver.solve(taquin_tokenise_board_string("0 3 2 1"), 2).size() == 6);
+    assert(throws_unsolvable(solver));
+
+    //Larger boards have no table
+    bool thrown = false;
+    try {
+        solver.solve(taquin_tokenise_board_string(puzzle_4x4), 4);
+    } catch (std::string e) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+static void test_astar()
+{
+    SolverOptions options;
+    options.use_pattern_databases = false;
+    AStarSolver solver(options);
+    SolveStats stats;
+
+    std::queue<Moves> moves = solver.solve(taquin_tokenise_board_string(puzzle_4x4), 4, &stats);
+    assert(moves.size() == 34);
+    assert(reaches_goal(puzzle_4x4, 4, moves));
+    assert(stats.algorithm == Algorithm::ASTAR);
+    assert(stats.nodes_expanded > 0 && stats.pdb_lookups == 0);
+
+    assert(solver.solve(taquin_tokenise_board_string(puzzle_3x3), 3).size() == 27);
+    assert(throws_unsolvable(solver));
+
+    //Past the node limit IDA* takes over
+    options.astar_node_limit = 100;
+    AStarSolver limited_solver(options);
+    assert(limited_solver.solve(taquin_tokenise_board_string(puzzle_4x4), 4, &stats).size() == 34);
+    assert(stats.algorithm == Algorithm::IDA);
+}
+
+static void test_parallel_ida()
+{
+    SolverOptions options;
+    options.search_threads = 4;
+    options.use_pattern_databases = false;
+    ParallelIDASolver solver(options);
+    SolveStats stats;
+
+    assert(solver.get_thread_count() == 4);
+
+    std::queue<Moves> moves = solver.solve(taquin_tokenise_board_string(puzzle_4x4), 4, &stats);
+    assert(moves.size() == 34);
+    assert(reaches_goal(puzzle_4x4, 4, moves));
+    assert(stats.algorithm == Algorithm::PARALLEL_IDA);
+    assert(stats.iterations.back().bound == 34);
+
+    //Solutions shallower than the frontier are found while building it
+    assert(solver.solve(taquin_tokenise_board_string(near_4x4), 4, &stats).size() == 1);
+    assert(solver.solve(taquin_tokenise_board_string(puzzle_3x3), 3).size() == 27);
+    assert(throws_unsolvable(solver));
+}
+
+static void test_auto()
+{
+    AutoSolver solver;
+    SolverOptions engine_options;
+
+    assert(solver.choose(taquin_tokenise_board_string(puzzle_3x3), 3, engine_options) == Algorithm::EXACT_TABLE);
+    assert(solver.choose(taquin_tokenise_board_string(near_4x4), 4, engine_options) == Algorithm::ASTAR);
+
+    //Invalid boards go to IDA* to be reported
+    assert(solver.choose(taquin_tokenise_board_string("1 2 3"), 4, engine_options) == Algorithm::IDA);
+
+    //The thresholds route the same board elsewhere
+    SolverOptions options;
+    options.search_threads = 2;
+    options.algorithm_policy.astar_max_heuristic = 0;
+    assert(AutoSolver(options).choose(taquin_tokenise_board_string(puzzle_4x4), 4, engine_options) == Algorithm::IDA);
+    options.algorithm_policy.parallel_min_heuristic = 0;
+    assert(AutoSolver(options).choose(taquin_tokenise_board_string(puzzle_4x4), 4, engine_options) == Algorithm::PARALLEL_IDA);
+    options.algorithm_policy.exact_table_max_size = 0;
+    assert(AutoSolver(options).choose(taquin_tokenise_board_string(puzzle_3x3), 3, engine_options) == Algorithm::PARALLEL_IDA);
+
+    //Whatever is picked, the solution is optimal and the engine is reported
+    SolveStats stats;
+    assert(taquin_solve(puzzle_3x3, 3, Algorithm::AUTO, SolverOptions(), &stats).size() == 27);
+    assert(stats.algorithm == Algorithm::EXACT_TABLE);
+    assert(taquin_solve(near_4x4, 4, Algorithm::AUTO, SolverOptions(), &stats).size() == 1);
+    assert(stats.algorithm == Algorithm::ASTAR);
+    assert(taquin_solve(puzzle_4x4, 4, Algorithm::AUTO, SolverOptions(), &stats).size() == 34);
+
+    //A board A* can't finish is searched by IDA* with the databases, even though A* went without them
+    SolverOptions limited_options;
+    limited_options.astar_node_limit = 100;
+    assert(taquin_solve(puzzle_4x4, 4, Algorithm::AUTO, limited_options, &stats).size() == 34);
+    assert(stats.algorithm == Algorithm::IDA);
+    assert(stats.pdb_lookups > 0);
+
+    //Other goals are mapped by every engine
+    SolverOptions goal_options;
+    goal_options.goal_board = taquin_tokenise_board_string("0 1 2 3 4 5 6 7 8");
+    size_t length = taquin_solve(puzzle_3x3, 3, Algorithm::IDA, goal_options).size();
+    assert(taquin_solve(puzzle_3x3, 3, Algorithm::EXACT_TABLE, goal_options).size() == length);
+    assert(taquin_solve(puzzle_3x3, 3, Algorithm::ASTAR, goal_options).size() == length);
+    assert(taquin_solve(puzzle_3x3, 3, Algorithm::PARALLEL_IDA, goal_options).size() == length);
+}
+
+int main (void)
+{
+    test_exact_table();
+    test_astar();
+    test_parallel_ida();
+    test_auto();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include <taquinsolve.hh>
+#include <Board.hh>
+#include <BoardKernels.hh>
+
+using namespace TaquinSolve;
+
+/**
+ * The partial hash exactly as it was originally computed, with a set lookup per cell.
+ */
+static uint64_t reference_partial_state_hash(std::vector<uint8_t> state, std::set<uint8_t> group_tiles)
+{
+    uint8_t unused_tile = 0;
+    while (group_tiles.find(unused_tile) != group_tiles.end()) {
+        unused_tile++;
+    }
+
+    uint64_t state_representation = 0;
+    for (uint8_t i = 0; i < state.size(); i++) {
+        uint8_t tile = group_tiles.find(state[i]) == group_tiles.end() ? unused_tile : state[i];
+        state_representation += ((uint64_t)tile) << (i*4);
+    }
+    return state_representation;
+}
+
+/**
+ * The Manhattan distance exactly as it was originally computed, with a division per cell.
+ */
+static uint8_t reference_manhattan_distance(std::vector<uint8_t> state, uint8_t board_size)
+{
+    uint8_t manhattan_sum = 0;
+    for (uint8_t i = 0; i < state.size(); i++) {
+        uint8_t j = state[i];
+        if (j == 0) {
+            continue;
+        }
+        manhattan_sum += abs((i / board_size) - ((j-1) / board_size)) + abs((i % board_size) - ((j-1) % board_size));
+    }
+    return manhattan_sum;
+}
+
+static void test_kernels_match_reference(uint8_t board_size)
+{
+    const BoardTables *tables = get_board_tables(board_size);
+    uint8_t len = board_size * board_size;
+
+    for (uint32_t i = 0; i < 1000; i++) {
+        std::vector<uint8_t> state = taquin_generate_vector(board_size);
+
+        //Pick a random group of tiles
+        std::set<uint8_t> group_tiles;
+        for (uint8_t tile = 0; tile < len; tile++) {
+            if (rand() % 2) {
+                group_tiles.insert(tile);
+            }
+        }
+        uint16_t group_mask = BoardKernels::get_group_mask(group_tiles);
+
+        uint64_t expected_hash = reference_partial_state_hash(state, group_tiles);
+        uint8_t expected_distance = reference_manhattan_distance(state, board_size);
+
+        //The scalar kernels should always be available
+        assert(BoardKernels::partial_state_hash_scalar(state.data(), len, group_mask) == expected_hash);
+        assert(BoardKernels::manhattan_distance_scalar(state.data(), tables) == expected_distance);
+
+        //The SIMD kernels are only checked on CPUs that support them
+        if (BoardKernels::check_supported(InstructionSet::SSE41)) {
+            assert(BoardKernels::partial_state_hash_sse41(state.data(), len, group_mask) == expected_hash);
+            assert(BoardKernels::manhattan_distance_sse41(state.data(), tables) == expected_distance);
+        }
+
+        //The board should give the same answers through the dispatching kernels
+        Board board(state, board_size);
+        assert(board.get_partial_state_hash(std::shared_ptr< std::set<uint8_t> >(new std::set<uint8_t>(group_tiles))) == expected_hash);
+        assert(board.get_partial_state_hash(group_mask) == expected_hash);
+    }
+}
+
+static void test_kernels_full_group()
+{
+    std::vector<uint8_t> state = taquin_tokenise_board_string("12 1 10 2 7 11 4 14 5 0 9 15 8 13 6 3");
+
+    //With every tile in the group the partial hash is the full state hash
+    assert(BoardKernels::partial_state_hash(state.data(), 16, 0xFFFF) == 0x36d8f905e4b72a1c);
+}
+
+int main (void)
+{
+    srand(1);
+
+    test_kernels_match_reference(2);
+    test_kernels_match_reference(3);
+    test_kernels_match_reference(4);
+    test_kernels_full_group();
+
+    return EXIT_SUCCESS;
+}
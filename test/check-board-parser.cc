@@ -0,0 +1,142 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include <taquinsolve.hh>
+#include <BoardParser.hh>
+
+using namespace TaquinSolve;
+
+static std::vector<uint8_t> get_row(BoardBatch &batch, size_t row)
+{
+    uint8_t cell_count = batch.board_size * batch.board_size;
+    return std::vector<uint8_t>(batch.tiles.begin() + row * cell_count, batch.tiles.begin() + (row + 1) * cell_count);
+}
+
+static void test_parse_rows()
+{
+    std::string text =
+        "4 5 7 2 8 0 6 1 3\n"
+        "\n"
+        "1 2 3 4 5 6 7 8 0 \r\n"
+        "1 2 3 4 5 6 7 8\n"
+        "1 2 3 4 5 6 7 8 0 1\n"
+        "1 2 3 4 5 6 7 8 9\n"
+        "1 1 3 4 5 6 7 8 0\n"
+        "2 1 3 4 5 6 7 8 0\n"
+        "1 2 x 4 5 6 7 8 0\n"
+        "  1  2 3 4 5 6 7 0 8";
+
+    BoardParser parser(3);
+    BoardBatch batch;
+
+    //The empty line shouldn't make a row
+    assert(parser.parse(text, batch) == 9);
+    assert(batch.errors.size() == 9);
+    assert(batch.tiles.size() == 9 * 9);
+
+    assert(batch.errors[0] == ParseError::NONE);
+    assert(get_row(batch, 0) == taquin_tokenise_board_string("4 5 7 2 8 0 6 1 3"));
+
+    //Trailing separators and CRLF line endings are accepted
+    assert(batch.errors[1] == ParseError::NONE);
+    assert(batch.lines[1] == 3);
+
+    assert(batch.errors[2] == ParseError::WRONG_TILE_COUNT);
+    assert(batch.errors[3] == ParseError::WRONG_TILE_COUNT);
+    assert(batch.errors[4] == ParseError::TILE_OUT_OF_RANGE);
+    assert(batch.errors[5] == ParseError::DUPLICATE_TILE);
+    assert(batch.errors[6] == ParseError::UNSOLVABLE);
+    assert(batch.errors[7] == ParseError::INVALID_TOKEN);
+
+    //Rejected rows are zero filled
+    assert(get_row(batch, 6) == std::vector<uint8_t>(9, 0));
+
+    //Repeated spaces are tolerated
+    assert(batch.errors[8] == ParseError::NONE);
+    assert(batch.lines[8] == 10);
+}
+
+static void test_separator()
+{
+    BoardParser parser(2, ',', false);
+    BoardBatch batch;
+
+    assert(parser.parse("3,1,0,2\n1,,2,0\n1,0,2,3,\n", batch) == 3);
+    assert(batch.errors[0] == ParseError::NONE);
+    assert(batch.errors[1] == ParseError::INVALID_TOKEN);
+
+    //Solvability not checked
+    assert(batch.errors[2] == ParseError::NONE);
+}
+
+static void test_validate_matches_solvable()
+{
+    //The fused check should agree with taquin_check_solvable on random boards
+    for (uint32_t i = 0; i < 1000; i++) {
+        std::vector<uint8_t> board = taquin_generate_vector(4);
+        assert(BoardParser::validate(board.data(), 4) == ParseError::NONE);
+        assert(taquin_check_solvable(board, 4));
+
+        std::swap(board[0], board[1]);
+        bool solvable = taquin_check_solvable(board, 4);
+        assert((BoardParser::validate(board.data(), 4) == ParseError::NONE) == solvable);
+        assert(BoardParser::validate(board.data(), 4, false) == ParseError::NONE);
+    }
+}
+
+static void test_parse_file()
+{
+    char path[] = "/tmp/check-board-parser-XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+
+    std::ofstream file(path);
+    for (uint32_t i = 0; i < 1000; i++) {
+        file << taquin_generate_string(4) << "\n";
+    }
+    file << "1 2 3\n";
+    file.close();
+
+    BoardParser parser(4);
+    BoardBatch batch;
+    assert(parser.parse_file(path, batch) == 1001);
+
+    for (uint32_t i = 0; i < 1000; i++) {
+        assert(batch.errors[i] == ParseError::NONE);
+    }
+    assert(batch.errors[1000] == ParseError::WRONG_TILE_COUNT);
+    assert(batch.lines[1000] == 1001);
+
+    remove(path);
+
+    try {
+        parser.parse_file(path, batch);
+        assert(false);
+    } catch (std::string e) {
+    }
+}
+
+static void test_tokenise()
+{
+    assert(taquin_tokenise_board_string("12 1 10 2 ") == std::vector<uint8_t>({12, 1, 10, 2}));
+    assert(taquin_tokenise_board_string("3,1,0,2", ',') == std::vector<uint8_t>({3, 1, 0, 2}));
+
+    //Empty tokens read as 0
+    assert(taquin_tokenise_board_string("1  2") == std::vector<uint8_t>({1, 0, 2}));
+    assert(taquin_tokenise_board_string("").empty());
+}
+
+int main (void)
+{
+    test_parse_rows();
+    test_separator();
+    test_validate_matches_solvable();
+    test_parse_file();
+    test_tokenise();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,123 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <taquinsolve.h>
+
+/**
+ * Apply the moves to the board and check that it ends up at the goal.
+ */
+static int check_solution(const uint8_t *board, uint8_t board_size, const uint8_t *goal, const uint8_t *moves, int length)
+{
+    uint8_t state[16];
+    int blank = 0;
+    memcpy(state, board, board_size * board_size);
+    while (state[blank] != 0) {
+        blank++;
+    }
+
+    for (int i = 0; i < length; i++) {
+        int target = blank;
+        switch (moves[i]) {
+            case TAQUIN_MOVE_UP:    target -= board_size; break;
+            case TAQUIN_MOVE_DOWN:  target += board_size; break;
+            case TAQUIN_MOVE_LEFT:  target -= 1; break;
+            case TAQUIN_MOVE_RIGHT: target += 1; break;
+        }
+        state[blank] = state[target];
+        state[target] = 0;
+        blank = target;
+    }
+
+    return memcmp(state, goal, board_size * board_size) == 0;
+}
+
+static void test_solve()
+{
+    const uint8_t board[9] = {4, 5, 7, 2, 8, 0, 6, 1, 3};
+    const uint8_t goal[9] = {1, 2, 3, 4, 5, 6, 7, 8, 0};
+    uint8_t moves[64];
+    taquin_solve_stats stats;
+
+    taquin_solver *solver = taquin_solver_create(NULL);
+    assert(solver != NULL);
+
+    //The handle is reused
+    for (int i = 0; i < 3; i++) {
+        int length = taquin_solve_into(solver, board, 3, moves, sizeof(moves), &stats);
+        assert(length == 27);
+        assert(stats.solution_length == 27);
+        assert(stats.iterations > 0 && stats.nodes_generated > 0);
+        assert(check_solution(board, 3, goal, moves, length));
+        assert(taquin_solver_last_error(solver)[0] == '\0');
+    }
+
+    //The solved board needs no buffer at all
+    assert(taquin_solve_into(solver, goal, 3, NULL, 0, NULL) == 0);
+
+    taquin_solver_destroy(solver);
+}
+
+static void test_errors()
+{
+    const uint8_t board[9] = {4, 5, 7, 2, 8, 0, 6, 1, 3};
+    const uint8_t unsolvable[9] = {1, 2, 3, 4, 5, 6, 8, 7, 0};
+    const uint8_t duplicate[9] = {1, 1, 3, 4, 5, 6, 7, 8, 0};
+    uint8_t moves[64];
+    taquin_solve_stats stats;
+
+    taquin_solver *solver = taquin_solver_create(NULL);
+
+    assert(taquin_solve_into(solver, unsolvable, 3, moves, sizeof(moves), NULL) == -TAQUIN_ERROR_UNSOLVABLE);
+    assert(taquin_solver_last_error(solver)[0] != '\0');
+    assert(taquin_solve_into(solver, duplicate, 3, moves, sizeof(moves), NULL) == -TAQUIN_ERROR_INVALID_BOARD);
+    assert(taquin_solve_into(solver, board, 7, moves, sizeof(moves), NULL) == -TAQUIN_ERROR_INVALID_ARGUMENT);
+    assert(taquin_solve_into(solver, NULL, 3, moves, sizeof(moves), NULL) == -TAQUIN_ERROR_INVALID_ARGUMENT);
+    assert(taquin_solve_into(NULL, board, 3, moves, sizeof(moves), NULL) == -TAQUIN_ERROR_INVALID_ARGUMENT);
+
+    //Too small a buffer still reports the length needed
+    assert(taquin_solve_into(solver, board, 3, moves, 10, &stats) == -TAQUIN_ERROR_BUFFER_TOO_SMALL);
+    assert(stats.solution_length == 27);
+
+    assert(strcmp(taquin_status_string(-TAQUIN_ERROR_UNSOLVABLE), taquin_status_string(TAQUIN_ERROR_UNSOLVABLE)) == 0);
+    assert(taquin_solve_c_stub() == 0);
+
+    taquin_solver_destroy(solver);
+}
+
+static void test_goal_board()
+{
+    const uint8_t goal[9] = {2, 1, 3, 4, 5, 6, 7, 8, 0};
+    const uint8_t board[9] = {1, 4, 3, 7, 0, 2, 6, 5, 8};
+    const uint8_t bad_goal[9] = {1, 2, 3, 4, 0, 5, 6, 7, 8};
+    uint8_t moves[64];
+
+    taquin_solver_config config;
+    taquin_solver_config_init(&config);
+    config.goal_board = goal;
+    config.goal_board_length = 9;
+
+    taquin_solver *solver = taquin_solver_create(&config);
+    assert(solver != NULL);
+
+    int length = taquin_solve_into(solver, board, 3, moves, sizeof(moves), NULL);
+    assert(length > 0);
+    assert(check_solution(board, 3, goal, moves, length));
+
+    //The goal decides the board size
+    assert(taquin_solve_into(solver, goal, 2, moves, sizeof(moves), NULL) == -TAQUIN_ERROR_INVALID_ARGUMENT);
+    taquin_solver_destroy(solver);
+
+    //The empty tile must be in a corner of the goal
+    config.goal_board = bad_goal;
+    assert(taquin_solver_create(&config) == NULL);
+}
+
+int main (void)
+{
+    test_solve();
+    test_errors();
+    test_goal_board();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,143 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+#include <taquinsolve.hh>
+#include <MoveSequence.hh>
+
+using namespace TaquinSolve;
+
+/**
+ * Run the command line solver over the given input and capture its output.
+ */
+static std::string run_cli(std::string arguments, std::string input)
+{
+    std::string input_path = "check-cli-input.txt";
+    std::ofstream input_file(input_path);
+    input_file << input;
+    input_file.close();
+
+    std::string command = std::string(TAQUINSOLVE_CLI) + " " + arguments + " < " + input_path;
+    FILE *pipe = popen(command.c_str(), "r");
+    assert(pipe != NULL);
+
+    std::string output;
+    char buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+        output.append(buffer, count);
+    }
+    pclose(pipe);
+    remove(input_path.c_str());
+
+    return output;
+}
+
+static std::vector<std::string> split_lines(std::string text)
+{
+    std::vector<std::string> lines;
+    std::istringstream stream(text);
+    std::string line;
+    while (std::getline(stream, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static void test_solve_in_order()
+{
+    std::string input =
+        "4 5 7 2 8 0 6 1 3\n"
+        "1 2 3 4 5 6 7 0 8\n"
+        "\n"
+        "1 2 3 4 5 6 8 7 0\n"
+        "1 2 3 4 5 6 7 8 0\n";
+
+    std::vector<std::string> lines = split_lines(run_cli("-q -j 3", input));
+    assert(lines.size() == 4);
+
+    //Should be in input order, with the length and the moves
+    assert(lines[0].compare(0, 5, "0 27 ") == 0);
+    assert(lines[0].size() == 5 + 27);
+    assert(lines[1] == "1 1 " + MoveSequence(taquin_solve("1 2 3 4 5 6 7 0 8", 3)).to_string());
+    assert(lines[2].compare(0, 8, "2 error ") == 0);
+    assert(lines[3] == "3 0 ");
+}
+
+static void test_unordered()
+{
+    std::string input;
+    for (uint32_t i = 0; i < 50; i++) {
+        input += taquin_generate_string(3) + "\n";
+    }
+
+    std::vector<std::string> lines = split_lines(run_cli("-q -u -j 4 --size 3", input));
+    assert(lines.size() == 50);
+
+    //Every board should be answered once, in whatever order
+    std::vector<bool> seen(50, false);
+    for (std::string line : lines) {
+        uint64_t index = strtoull(line.c_str(), NULL, 10);
+        assert(index < 50 && !seen[index]);
+        seen[index] = true;
+        assert(line.find("error") == std::string::npos);
+    }
+}
+
+static void test_binary()
+{
+    std::string output = run_cli("-q -b", "4 5 7 2 8 0 6 1 3\n");
+
+    //Magic, then index (8), status (1), length (1) and 27 moves in 7 bytes
+    assert(output.size() == 8 + 8 + 1 + 1 + 7);
+    assert(output.compare(0, 8, "TQSOLNS1") == 0);
+    assert(output[16] == 0);
+    assert(output[17] == 27);
+
+    MoveSequence solution((const uint8_t *) output.data() + 18, 27);
+    std::vector<std::string> lines = split_lines(run_cli("-q", "4 5 7 2 8 0 6 1 3\n"));
+    assert(lines[0] == "0 27 " + solution.to_string());
+}
+
+static void test_invalid_size()
+{
+    //Sizes are checked before narrowing, 258 would otherwise wrap to 2
+    assert(run_cli("-q -s 258", "1 2 3 0\n").empty());
+    assert(run_cli("-q -s 5x", "1 2 3 0\n").empty());
+    assert(run_cli("-q -s 2", "1 2 3 0\n") == "0 0 \n");
+
+    //As are perimeter radii, 300 would otherwise wrap to 44
+    assert(run_cli("-q -p 300", "1 2 3 0\n").empty());
+    assert(run_cli("-q -p 2x", "1 2 3 0\n").empty());
+    assert(run_cli("-q -p 2", "1 2 3 0\n") == "0 0 \n");
+}
+
+static void test_ordered_window()
+{
+    //More boards than the workers may get ahead of the output, still written in order
+    std::string input;
+    for (uint32_t i = 0; i < 600; i++) {
+        input += taquin_generate_string(3) + "\n";
+    }
+
+    std::vector<std::string> lines = split_lines(run_cli("-q -j 2 --size 3", input));
+    assert(lines.size() == 600);
+    for (uint64_t i = 0; i < lines.size(); i++) {
+        assert(strtoull(lines[i].c_str(), NULL, 10) == i);
+    }
+}
+
+int main (void)
+{
+    test_solve_in_order();
+    test_unordered();
+    test_binary();
+    test_invalid_size();
+    test_ordered_window();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <string>
+#include <vector>
+#include <thread>
+
+#include <taquinsolve.hh>
+#include <SolverDaemon.hh>
+#include <SolverClient.hh>
+#include <MoveSequence.hh>
+
+using namespace TaquinSolve;
+
+static const std::string SOCKET_PATH = "check-daemon.sock";
+
+static void test_fallback_without_daemon()
+{
+    SolverClient client("check-daemon-missing.sock");
+
+    assert(!client.connect());
+    assert(client.solve(taquin_tokenise_board_string("4 5 7 2 8 0 6 1 3"), 3).size() == 27);
+    assert(!client.is_connected());
+
+    //Errors are thrown like taquin_solve's
+    bool thrown = false;
+    try {
+        client.solve(taquin_tokenise_board_string("1 2 3 4 5 6 8 7 0"), 3);
+    } catch (std::string e) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+static void test_daemon()
+{
+    SolverDaemon daemon(SOCKET_PATH, 2);
+    std::thread server([&]() { daemon.run(); });
+
+    //The socket opens before the databases load, so a busy machine can't time the client out
+    assert(daemon.wait_until_listening());
+    SolverClient client(SOCKET_PATH);
+    assert(client.connect());
+
+    //A second daemon can't take over the socket
+    bool thrown = false;
+    try {
+        SolverDaemon(SOCKET_PATH, 1).run();
+    } catch (std::string e) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    MoveSequence solution;
+    client.solve_into(taquin_tokenise_board_string("4 5 7 2 8 0 6 1 3"), 3, solution);
+    assert(solution.size() == 27);
+    assert(client.is_connected());
+
+    //A pipelined batch, larger than the window, with a bad board in the middle
+    taquin_set_generator_seed(40);
+    std::vector<uint8_t> tiles;
+    for (uint32_t i = 0; i < 600; i++) {
+        std::vector<uint8_t> board = i == 300 ? taquin_tokenise_board_string("1 2 3 4 5 6 8 7 0") : taquin_generate_vector(3);
+        tiles.insert(tiles.end(), board.begin(), board.end());
+    }
+
+    std::vector<MoveSequence> solutions;
+    std::vector<std::string> errors;
+    client.solve_batch(tiles, 3, solutions, errors);
+    assert(solutions.size() == 600 && errors.size() == 600);
+
+    for (uint32_t i = 0; i < 600; i++) {
+        std::vector<uint8_t> board(tiles.begin() + i * 9, tiles.begin() + i * 9 + 9);
+        if (i == 300) {
+            assert(!errors[i].empty());
+            continue;
+        }
+        assert(errors[i].empty());
+        if (i % 50 == 0) {
+            assert(solutions[i].size() == taquin_solve(board, 3).size());
+        }
+    }
+    assert(daemon.get_solve_count() == 601);
+    assert(client.is_connected());
+
+    daemon.stop();
+    server.join();
+    assert(access(SOCKET_PATH.c_str(), F_OK) != 0);
+
+    //The connection is gone, so the client falls back
+    assert(client.solve(taquin_tokenise_board_string("1 2 3 4 5 6 7 0 8"), 3).size() == 1);
+    assert(!client.is_connected());
+}
+
+/**
+ * A client that sends without reading its responses is dropped, and doesn't stall the others.
+ */
+static void test_stalled_client()
+{
+    SolverDaemon daemon(SOCKET_PATH, 1);
+    std::thread server([&]() { daemon.run(); });
+    assert(daemon.wait_until_listening());
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    SOCKET_PATH.copy(address.sun_path, sizeof(address.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    assert(connect(fd, (sockaddr *) &address, sizeof(address)) == 0);
+    assert(DaemonProtocol::write_all(fd, DaemonProtocol::HANDSHAKE, sizeof(DaemonProtocol::HANDSHAKE)));
+
+    //Far more responses than the socket buffers hold, sent until the daemon gives up on the connection
+    std::thread stalled([fd]() {
+        uint8_t request[DaemonProtocol::REQUEST_HEADER_SIZE + 4] = {0, 0, 0, 0, 2, 1, 2, 0, 3};
+        for (uint32_t i = 0; i < 1000000; i++) {
+            if (!DaemonProtocol::write_all(fd, request, sizeof(request))) {
+                break;
+            }
+        }
+    });
+
+    SolverClient client(SOCKET_PATH);
+    assert(client.connect());
+    assert(client.solve(taquin_tokenise_board_string("1 2 3 4 5 6 7 0 8"), 3).size() == 1);
+    assert(client.is_connected());
+
+    stalled.join();
+    close(fd);
+    daemon.stop();
+    server.join();
+}
+
+int main (void)
+{
+    test_fallback_without_daemon();
+    test_daemon();
+    test_stalled_client();
+
+    return EXIT_SUCCESS;
+}
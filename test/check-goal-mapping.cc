@@ -0,0 +1,162 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <queue>
+#include <memory>
+#include <unordered_map>
+
+#include <taquinsolve.hh>
+#include <Board.hh>
+#include <GoalMapping.hh>
+#include <HintSession.hh>
+
+using namespace TaquinSolve;
+
+/**
+ * Apply the given moves to the given board and return the resulting state.
+ */
+static std::vector<uint8_t> apply_moves(std::vector<uint8_t> state, uint8_t board_size, std::queue<Moves> moves)
+{
+    std::shared_ptr<Board> board(new Board(state, board_size));
+    while (!moves.empty()) {
+        board = std::shared_ptr<Board>(board->perform_move(moves.front()));
+        moves.pop();
+    }
+    return board->get_state();
+}
+
+/**
+ * Find the optimal distance between two 3x3 boards by breadth first search.
+ */
+static uint8_t breadth_first_distance(std::vector<uint8_t> start, std::vector<uint8_t> goal)
+{
+    std::unordered_map<uint64_t, uint8_t> distances;
+    std::queue<std::shared_ptr<Board> > open;
+
+    uint64_t goal_hash = Board(goal, 3).get_state_hash();
+    std::shared_ptr<Board> root(new Board(start, 3));
+    distances[root->get_state_hash()] = 0;
+    open.push(root);
+
+    while (!open.empty()) {
+        std::shared_ptr<Board> board = open.front();
+        open.pop();
+
+        uint8_t distance = distances[board->get_state_hash()];
+        if (board->get_state_hash() == goal_hash) {
+            return distance;
+        }
+
+        for (Moves move : board->get_available_moves()) {
+            std::shared_ptr<Board> child(board->perform_move(move));
+            if (distances.insert(std::make_pair(child->get_state_hash(), distance + 1)).second) {
+                open.push(child);
+            }
+        }
+    }
+
+    assert(false);
+    return 0;
+}
+
+static void check_goal_solve(std::string puzzle, std::string goal)
+{
+    std::vector<uint8_t> board = taquin_tokenise_board_string(puzzle);
+    SolverOptions options;
+    options.goal_board = taquin_tokenise_board_string(goal);
+
+    std::queue<Moves> moves = taquin_solve(board, 3, Algorithm::IDA, options);
+
+    //Should reach the given goal optimally
+    assert(apply_moves(board, 3, moves) == options.goal_board);
+    assert(moves.size() == breadth_first_distance(board, options.goal_board));
+}
+
+static void test_standard_goal()
+{
+    SolverOptions options;
+    options.goal_board = taquin_tokenise_board_string("1 2 3 4 5 6 7 8 0");
+
+    assert(GoalMapping(options.goal_board, 3).is_identity());
+    assert(taquin_solve("4 5 7 2 8 0 6 1 3", 3, Algorithm::IDA, options).size() == 27);
+}
+
+static void test_corner_goals()
+{
+    //Empty tile in each corner
+    check_goal_solve("4 5 7 2 8 0 6 1 3", "0 1 2 3 4 5 6 7 8");
+    check_goal_solve("4 5 7 2 8 0 6 1 3", "1 2 0 3 4 5 6 7 8");
+    check_goal_solve("4 5 7 2 8 0 6 1 3", "1 2 3 4 5 6 0 7 8");
+
+    //An image specific labelling, unsolvable against the standard goal
+    assert(!taquin_check_solvable("1 4 3 7 0 2 6 5 8", 3));
+    check_goal_solve("1 4 3 7 0 2 6 5 8", "2 1 3 4 5 6 7 8 0");
+}
+
+static void test_4_4_goal()
+{
+    //The blank first goal, uses the standard pattern databases through relabelling
+    SolverOptions options;
+    options.goal_board = taquin_tokenise_board_string("0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15");
+
+    std::vector<uint8_t> board = taquin_tokenise_board_string("4 1 2 3 8 5 6 7 0 9 10 11 12 13 14 15");
+    std::queue<Moves> moves = taquin_solve(board, 4, Algorithm::IDA, options);
+
+    assert(moves.size() == 2);
+    assert(apply_moves(board, 4, moves) == options.goal_board);
+}
+
+static void test_invalid_goals()
+{
+    SolverOptions options;
+
+    //Empty tile not in a corner
+    options.goal_board = taquin_tokenise_board_string("1 2 3 4 0 5 6 7 8");
+    try {
+        taquin_solve("4 5 7 2 8 0 6 1 3", 3, Algorithm::IDA, options);
+        assert(false);
+    } catch (std::string e) {
+    }
+
+    //Repeated tile
+    options.goal_board = taquin_tokenise_board_string("1 1 3 4 5 6 7 8 0");
+    try {
+        taquin_solve("4 5 7 2 8 0 6 1 3", 3, Algorithm::IDA, options);
+        assert(false);
+    } catch (std::string e) {
+    }
+
+    //Board in the other parity class than the goal
+    options.goal_board = taquin_tokenise_board_string("0 1 2 3 4 5 6 7 8");
+    try {
+        taquin_solve("0 2 1 3 4 5 6 7 8", 3, Algorithm::IDA, options);
+        assert(false);
+    } catch (std::string e) {
+    }
+}
+
+static void test_hint_session_goal()
+{
+    SolverOptions options;
+    options.goal_board = taquin_tokenise_board_string("0 1 2 3 4 5 6 7 8");
+    HintSession session(taquin_tokenise_board_string("4 5 7 2 8 0 6 1 3"), 3, options);
+
+    while (!session.check_solved()) {
+        session.apply_move(session.get_hint());
+    }
+
+    assert(session.get_board() == options.goal_board);
+    assert(session.get_solve_count() == 1);
+}
+
+int main (void)
+{
+    test_standard_goal();
+    test_corner_goals();
+    test_4_4_goal();
+    test_invalid_goals();
+    test_hint_session_goal();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,192 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string>
+#include <memory>
+
+#include <taquinsolve.hh>
+#include <Heuristics.hh>
+#include <IDASolver.hh>
+#include <WalkingDistance.hh>
+
+using namespace TaquinSolve;
+
+static const std::string puzzle_3x3 = "4 5 7 2 8 0 6 1 3";
+static const std::string puzzle_4x4 = "6 8 15 4 1 2 3 0 9 5 10 7 14 13 11 12";
+
+static std::shared_ptr<Board> make_board(std::string board, uint8_t board_size)
+{
+    return std::shared_ptr<Board>(new Board(taquin_tokenise_board_string(board), board_size));
+}
+
+/**
+ * A stateful policy, counting how often the search asks for an estimate.
+ */
+struct CountingManhattan
+{
+    std::shared_ptr<uint64_t> count = std::shared_ptr<uint64_t>(new uint64_t(0));
+    ManhattanDistance manhattan;
+
+    uint8_t estimate(Board &board)
+    {
+        (*this->count)++;
+        return this->manhattan.estimate(board);
+    }
+
+    void prefetch(Board &) {}
+};
+
+static void test_policies()
+{
+    ManhattanDistance manhattan;
+    LinearConflict linear_conflict;
+
+    //Nothing to do at the goal
+    std::shared_ptr<Board> goal = make_board("1 2 3 4 5 6 7 8 0", 3);
+    assert(manhattan.estimate(*goal) == 0);
+    assert(linear_conflict.estimate(*goal) == 0);
+
+    //Tiles 2 and 1 are swapped in their goal row, one has to step out and back
+    std::shared_ptr<Board> swapped = make_board("2 1 3 4 5 6 7 8 0", 3);
+    assert(manhattan.estimate(*swapped) == 2);
+    assert(linear_conflict.estimate(*swapped) == 4);
+
+    //A reversed row needs two tiles out of the way, not one per pair
+    std::shared_ptr<Board> reversed = make_board("3 2 1 4 5 6 7 8 0", 3);
+    assert(manhattan.estimate(*reversed) == 4);
+    assert(linear_conflict.estimate(*reversed) == 8);
+
+    //Conflicts in columns count too
+    std::shared_ptr<Board> column = make_board("4 2 3 1 5 6 7 8 0", 3);
+    assert(linear_conflict.estimate(*column) == manhattan.estimate(*column) + 2);
+
+    //A corner holding the wrong tile with both neighbours in place, and tiles 6 and 8 both away from the empty cell's goal
+    EnhancedLinearConflict enhanced;
+    std::shared_ptr<Board> corner = make_board("5 2 3 4 1 6 7 8 0", 3);
+    assert(linear_conflict.estimate(*corner) == 4);
+    assert(enhanced.estimate(*corner) == 8);
+    assert(enhanced.estimate(*goal) == 0);
+
+    //Combinators
+    std::shared_ptr<Board> board = make_board(puzzle_3x3, 3);
+    MaxOf<ManhattanDistance, LinearConflict> maximum;
+    SumOf<ManhattanDistance, ManhattanDistance> sum;
+    assert(maximum.estimate(*board) == linear_conflict.estimate(*board));
+    assert(sum.estimate(*board) == 2 * manhattan.estimate(*board));
+
+    //The default composition is what boards use on their own
+    DefaultHeuristic default_heuristic;
+    assert(default_heuristic.estimate(*board) == board->get_heuristic());
+}
+
+static void test_incremental_conflicts()
+{
+    LinearConflict linear_conflict;
+    EnhancedLinearConflict enhanced;
+
+    //Followed from move to move, the conflicts match those counted from scratch
+    srand(3);
+    for (uint8_t board_size = 3; board_size <= 4; board_size++) {
+        std::shared_ptr<Board> board = make_board(board_size == 3 ? puzzle_3x3 : puzzle_4x4, board_size);
+        board->get_linear_conflicts();
+        for (int i = 0; i < 500; i++) {
+            Moves move = board->get_available_move(rand() % board->get_available_move_count());
+            board = std::shared_ptr<Board>(board->perform_move(move));
+
+            std::shared_ptr<Board> fresh = std::shared_ptr<Board>(new Board(board->get_state(), board_size));
+            assert(board->get_linear_conflicts() == fresh->get_linear_conflicts());
+            for (uint8_t line = 0; line < board_size; line++) {
+                assert(board->get_line_conflicts(false, line) == LinearConflict::count_conflicts(board->get_cells(), board->get_tables(), line, true));
+                assert(board->get_line_conflicts(true, line) == LinearConflict::count_conflicts(board->get_cells(), board->get_tables(), line, false));
+            }
+            assert(enhanced.estimate(*board) >= linear_conflict.estimate(*board));
+        }
+    }
+}
+
+static void test_walking_distance()
+{
+    WalkingDistance walking_distance;
+    ManhattanDistance manhattan;
+
+    //Tables are shared per size and small
+    assert(WalkingDistanceTable::get(4) == WalkingDistanceTable::get(4));
+    assert(WalkingDistanceTable::get(4)->size() < UINT16_MAX);
+    assert(WalkingDistanceTable::get(5) == NULL);
+
+    std::shared_ptr<Board> goal = make_board("1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 0", 4);
+    assert(walking_distance.estimate(*goal) == 0);
+
+    //Tiles swapped within their goal row only count moves between columns
+    std::shared_ptr<Board> swapped = make_board("2 1 3 4 5 6 7 8 9 10 11 12 13 14 15 0", 4);
+    assert(walking_distance.estimate(*swapped) >= manhattan.estimate(*swapped));
+
+    //Followed from move to move, the estimate matches one computed from scratch
+    srand(7);
+    std::shared_ptr<Board> board = make_board(puzzle_4x4, 4);
+    assert(walking_distance.estimate(*board) >= manhattan.estimate(*board));
+    for (int i = 0; i < 500; i++) {
+        Moves move = board->get_available_move(rand() % board->get_available_move_count());
+        board = std::shared_ptr<Board>(board->perform_move(move));
+
+        std::shared_ptr<Board> fresh = std::shared_ptr<Board>(new Board(board->get_state(), 4));
+        uint8_t estimate = walking_distance.estimate(*board);
+        assert(estimate == walking_distance.estimate(*fresh));
+        assert(estimate >= manhattan.estimate(*board));
+    }
+}
+
+static void test_solvers()
+{
+    SolveStats manhattan_stats;
+    SolveStats linear_conflict_stats;
+
+    BasicIDASolver<ManhattanDistance> manhattan_solver;
+    BasicIDASolver<LinearConflict> linear_conflict_solver;
+    assert(manhattan_solver.solve(taquin_tokenise_board_string(puzzle_3x3), 3, &manhattan_stats).size() == 27);
+    assert(linear_conflict_solver.solve(taquin_tokenise_board_string(puzzle_3x3), 3, &linear_conflict_stats).size() == 27);
+
+    //Linear conflict dominates Manhattan distance
+    assert(linear_conflict_stats.initial_heuristic >= manhattan_stats.initial_heuristic);
+    assert(linear_conflict_stats.nodes_generated <= manhattan_stats.nodes_generated);
+
+    //Corner and last move tiles on top of linear conflicts
+    BasicIDASolver<EnhancedLinearConflict> enhanced_solver;
+    SolveStats enhanced_stats;
+    assert(enhanced_solver.solve(taquin_tokenise_board_string(puzzle_3x3), 3, &enhanced_stats).size() == 27);
+    assert(enhanced_stats.nodes_generated <= linear_conflict_stats.nodes_generated);
+
+    //Policies can carry state, evaluated once per board
+    CountingManhattan counting;
+    BasicIDASolver<CountingManhattan> counting_solver(SolverOptions(), counting);
+    SolveStats counting_stats;
+    assert(counting_solver.solve(taquin_tokenise_board_string(puzzle_3x3), 3, &counting_stats).size() == 27);
+    assert(*counting.count == counting_stats.nodes_generated + 1);
+
+    //Pattern databases combined with linear conflict
+    BasicIDASolver<WithPerimeter<MaxOf<PatternDatabaseHeuristic, LinearConflict>>> combined_solver;
+    SolveStats default_stats;
+    SolveStats combined_stats;
+    assert(IDASolver().solve(taquin_tokenise_board_string(puzzle_4x4), 4, &default_stats).size() == 34);
+    assert(combined_solver.solve(taquin_tokenise_board_string(puzzle_4x4), 4, &combined_stats).size() == 34);
+    assert(combined_stats.nodes_generated <= default_stats.nodes_generated);
+
+    //Walking distance without any databases
+    BasicIDASolver<WalkingDistance> walking_distance_solver;
+    BasicIDASolver<ManhattanDistance> manhattan_4x4_solver;
+    SolveStats walking_distance_stats;
+    SolveStats manhattan_4x4_stats;
+    assert(walking_distance_solver.solve(taquin_tokenise_board_string(puzzle_3x3), 3).size() == 27);
+    assert(walking_distance_solver.solve(taquin_tokenise_board_string(puzzle_4x4), 4, &walking_distance_stats).size() == 34);
+    assert(manhattan_4x4_solver.solve(taquin_tokenise_board_string(puzzle_4x4), 4, &manhattan_4x4_stats).size() == 34);
+    assert(walking_distance_stats.nodes_generated < manhattan_4x4_stats.nodes_generated);
+}
+
+int main (void)
+{
+    test_policies();
+    test_incremental_conflicts();
+    test_walking_distance();
+    test_solvers();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,96 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <taquinsolve.hh>
+#include <HintSession.hh>
+
+using namespace TaquinSolve;
+
+static void test_follow_hints()
+{
+    HintSession session(taquin_tokenise_board_string("4 5 7 2 8 0 6 1 3"), 3);
+
+    assert(session.get_remaining_moves() == 27);
+
+    //Following the hints should reach the goal without searching again
+    uint8_t moves = 0;
+    while (!session.check_solved()) {
+        session.apply_move(session.get_hint());
+        moves++;
+    }
+
+    assert(moves == 27);
+    assert(session.get_solve_count() == 1);
+    assert(session.get_remaining_moves() == 0);
+}
+
+static void test_deviate_from_hint()
+{
+    HintSession session(taquin_tokenise_board_string("4 5 7 2 8 0 6 1 3"), 3);
+    Moves hint = session.get_hint();
+
+    //Take any other legal move
+    std::vector<Moves> available_moves = Board(session.get_board(), 3).get_available_moves();
+    Moves deviation = available_moves.front() == hint ? available_moves.back() : available_moves.front();
+    session.apply_move(deviation);
+
+    //The re-solve should agree with a fresh solve of the new board
+    std::vector<uint8_t> board = session.get_board();
+    assert(session.get_remaining_moves() == taquin_solve(board, 3).size());
+    assert(session.get_solve_count() == 2);
+
+    //The first iteration should start from the previous length less one
+    assert(session.get_stats().iterations.front().bound >= 26);
+}
+
+static void test_illegal_move()
+{
+    //The blank is in a corner so two of the moves are not possible
+    HintSession session(taquin_tokenise_board_string("1 2 3 4 5 6 7 8 0"), 3);
+    std::vector<Moves> available_moves = Board(session.get_board(), 3).get_available_moves();
+    assert(available_moves.size() == 2);
+
+    uint8_t rejected = 0;
+    for (Moves move : {Moves::UP, Moves::DOWN, Moves::LEFT, Moves::RIGHT}) {
+        if (std::find(available_moves.begin(), available_moves.end(), move) != available_moves.end()) {
+            continue;
+        }
+        try {
+            session.apply_move(move);
+            assert(false);
+        } catch (std::string e) {
+            rejected++;
+        }
+    }
+
+    //Nothing should have changed
+    assert(rejected == 2);
+    assert(session.check_solved());
+}
+
+static void test_solved_board()
+{
+    HintSession session(taquin_tokenise_board_string("1 2 3 0"), 2);
+
+    assert(session.check_solved());
+    assert(session.get_remaining_moves() == 0);
+
+    try {
+        session.get_hint();
+        assert(false);
+    } catch (std::string e) {
+    }
+}
+
+int main (void)
+{
+    test_follow_hints();
+    test_deviate_from_hint();
+    test_illegal_move();
+    test_solved_board();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <queue>
+
+#include <taquinsolve.hh>
+#include <MoveSequence.hh>
+#include <Board.hh>
+#include <IDASolver.hh>
+
+using namespace TaquinSolve;
+
+static void test_push_and_get()
+{
+    MoveSequence sequence;
+    assert(sequence.empty());
+
+    //More than fits in one byte, so moves span several
+    std::vector<Moves> moves = {UP, DOWN, LEFT, RIGHT, RIGHT, LEFT, DOWN, UP, LEFT};
+    for (Moves move : moves) {
+        sequence.push(move);
+    }
+
+    assert(sequence.size() == moves.size());
+    assert(sequence.get_data_size() == 3);
+    for (uint8_t i = 0; i < moves.size(); i++) {
+        assert(sequence[i] == moves[i]);
+    }
+
+    //Iterating should give the same moves in order
+    uint8_t i = 0;
+    for (Moves move : sequence) {
+        assert(move == moves[i++]);
+    }
+    assert(i == moves.size());
+
+    assert(sequence.back() == LEFT);
+    sequence.pop();
+    assert(sequence.size() == moves.size() - 1);
+    assert(sequence.back() == UP);
+
+    sequence.set(0, RIGHT);
+    assert(sequence[0] == RIGHT);
+    assert(sequence[1] == DOWN);
+}
+
+static void test_conversions()
+{
+    MoveSequence sequence = MoveSequence::from_string("UDLRRLDUL");
+    assert(sequence.size() == 9);
+    assert(sequence.to_string() == "UDLRRLDUL");
+
+    //Queue round trip
+    std::queue<Moves> queue = sequence.to_queue();
+    assert(queue.size() == 9);
+    assert(MoveSequence(queue) == sequence);
+
+    //Packed round trip
+    MoveSequence unpacked(sequence.get_data(), sequence.size());
+    assert(unpacked == sequence);
+    assert(unpacked != MoveSequence::from_string("UDLRRLDUR"));
+
+    //Removed moves shouldn't affect comparison
+    MoveSequence longer = MoveSequence::from_string("UDLRRLDULR");
+    longer.pop();
+    assert(longer == sequence);
+
+    try {
+        MoveSequence::from_string("UDX");
+        assert(false);
+    } catch (std::string e) {
+    }
+}
+
+static void test_capacity()
+{
+    MoveSequence sequence;
+    for (uint16_t i = 0; i < MoveSequence::CAPACITY; i++) {
+        sequence.push((Moves) (i % 4));
+    }
+    assert(sequence.size() == MoveSequence::CAPACITY);
+
+    try {
+        sequence.push(UP);
+        assert(false);
+    } catch (std::string e) {
+    }
+}
+
+static void test_board_past_capacity()
+{
+    //Boards moved by hand go on past the capacity, dropping their history
+    Board *board = new Board(taquin_tokenise_board_string("1 2 3 4 5 6 7 8 0"), 3);
+    Moves move = board->get_available_move(0);
+    for (uint16_t i = 0; i <= MoveSequence::CAPACITY; i++) {
+        Board *next = board->perform_move(i % 2 == 0 ? move : (Moves) (move ^ 1));
+        delete board;
+        board = next;
+    }
+    assert(!board->has_move_history());
+    assert(board->get_move_history().empty());
+    assert(!board->check_solved());
+
+    //Replacing the history records moves again
+    MoveSequence history;
+    history.push(move);
+    board->replace_move_history(history);
+    Board *next = board->perform_move((Moves) (move ^ 1));
+    assert(next->has_move_history());
+    assert(next->get_move_history().size() == 2);
+    assert(next->check_solved());
+
+    delete next;
+    delete board;
+}
+
+static void test_solve_into()
+{
+    std::vector<uint8_t> board = taquin_tokenise_board_string("4 5 7 2 8 0 6 1 3");
+    MoveSequence solution;
+
+    taquin_solve_into(board, 3, solution);
+    assert(solution.size() == 27);
+
+    //Should agree with the queue interface
+    assert(MoveSequence(taquin_solve(board, 3)) == solution);
+
+    //A reused solver should overwrite the previous solution
+    IDASolver solver;
+    solver.solve_into(taquin_tokenise_board_string("1 2 3 4 5 6 7 0 8"), 3, solution);
+    assert(solution.to_string().size() == 1);
+}
+
+int main (void)
+{
+    test_push_and_get();
+    test_conversions();
+    test_capacity();
+    test_board_past_capacity();
+    test_solve_into();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,190 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string>
+#include <memory>
+#include <fstream>
+#include <cstdio>
+
+#include <taquinsolve.hh>
+#include <Board.hh>
+#include <PatternDatabase.hh>
+#include <EmbeddedDatabases.hh>
+
+using namespace TaquinSolve;
+
+static void test_pattern_database_lookup(bool use_huge_pages)
+{
+    std::shared_ptr<PatternDatabase> pattern_database(new PatternDatabase(3, use_huge_pages));
+
+    //Groups {1,2} and {3,4}
+    pattern_database->add_group(0x0006);
+    pattern_database->add_group(0x0018);
+    assert(pattern_database->get_group_count() == 2);
+
+    //Tile 2 in cell 0 and tile 1 in cell 1
+    pattern_database->insert(0x12, 3);
+
+    //Tile 3 in cell 2 and tile 4 in cell 3
+    pattern_database->insert(0x4300, 5);
+
+    //Both groups match
+    Board both(taquin_tokenise_board_string("2 1 3 4 5 6 7 8 0"), 3, pattern_database);
+    both.prefetch_heuristic();
+    assert(both.get_pattern_db_heuristic() == 8);
+
+    //Only the first group matches, unknown entries count as 0
+    Board first(taquin_tokenise_board_string("2 1 4 3 5 6 7 8 0"), 3, pattern_database);
+    assert(first.get_pattern_db_heuristic() == 3);
+
+    //Should not be used for a different board size
+    Board other(taquin_tokenise_board_string("1 2 3 0"), 2, pattern_database);
+    assert(other.get_pattern_db_heuristic() == 0);
+
+    //Should fail on an entry outside every group
+    bool exception_thrown = false;
+    try {
+        pattern_database->insert(0x5, 1);
+    } catch (std::string e) {
+        exception_thrown = true;
+    }
+    assert(exception_thrown);
+}
+
+static void test_pattern_database_files()
+{
+    //Tile 2 in cell 0, tile 1 in cell 1 and tile 4 in cell 5
+    Board board(taquin_tokenise_board_string("2 1 3 7 5 4 6 8 0"), 3);
+    std::vector<uint8_t> state = board.get_state();
+    uint8_t positions[MAX_CELLS];
+    for (uint8_t cell = 0; cell < 9; cell++) {
+        positions[state[cell]] = cell;
+    }
+
+    //Standard groups put the most frequently moved tiles first, others go in ascending order
+    assert(PatternDatabase::get_default_tile_order(4, 0x2662) == std::vector<uint8_t>({10, 6, 1, 5, 9, 13}));
+    assert(PatternDatabase::get_default_tile_order(3, 0x0016) == std::vector<uint8_t>({1, 2, 4}));
+
+    //The order must cover the group
+    PatternDatabase invalid(3);
+    bool exception_thrown = false;
+    try {
+        invalid.add_group(0x0016, {1, 2});
+    } catch (std::string e) {
+        exception_thrown = true;
+    }
+    assert(exception_thrown);
+
+    //Sparse files
+    std::ofstream sparse("./sparse.db.bin", std::ios::binary);
+    uint64_t hash = 0x400012;
+    uint8_t cost = 7;
+    sparse.write((char *) &hash, 8);
+    sparse.write((char *) &cost, 1);
+    sparse.close();
+
+    PatternDatabase ascending(3);
+    ascending.add_group(0x0016);
+    ascending.load("./sparse.db.bin");
+    uint32_t indices[MAX_PATTERN_GROUPS];
+    ascending.get_indices(positions, indices);
+    assert(ascending.lookup(indices) == 7);
+
+    //Dense files record their tile order and load into any order
+    ascending.save(0, "./dense.db.bin");
+    std::ifstream dense("./dense.db.bin", std::ios::binary);
+    char header[13];
+    dense.read(header, sizeof(header));
+    assert(std::string(header, 8) == std::string(DENSE_DATABASE_MAGIC, 8));
+    assert(header[8] == 3 && header[9] == 3 && header[10] == 1 && header[11] == 2 && header[12] == 4);
+    dense.close();
+
+    PatternDatabase reordered(3);
+    reordered.add_group(0x0016, {4, 1, 2});
+    reordered.load("./dense.db.bin");
+    reordered.get_indices(positions, indices);
+    assert(reordered.lookup(indices) == 7);
+    assert(reordered.get_tile_order(0) == std::vector<uint8_t>({4, 1, 2}));
+
+    //Only the entry given is set
+    positions[4] = 8;
+    reordered.get_indices(positions, indices);
+    assert(reordered.lookup(indices) == 0);
+
+    //Files held in memory are used in place when in the same order
+    std::ifstream in_memory("./dense.db.bin", std::ios::binary);
+    std::vector<uint8_t> contents((std::istreambuf_iterator<char>(in_memory)), std::istreambuf_iterator<char>());
+    positions[4] = 5;
+
+    PatternDatabase attached(3);
+    attached.add_group(0x0016);
+    attached.attach(contents.data(), contents.size());
+    attached.get_indices(positions, indices);
+    assert(attached.lookup(indices) == 7);
+
+    exception_thrown = false;
+    try {
+        attached.insert(0x400012, 1);
+    } catch (std::string e) {
+        exception_thrown = true;
+    }
+    assert(exception_thrown);
+
+    //And copied otherwise
+    PatternDatabase copied(3);
+    copied.add_group(0x0016, {2, 4, 1});
+    copied.attach(contents.data(), contents.size());
+    copied.get_indices(positions, indices);
+    assert(copied.lookup(indices) == 7);
+    copied.insert(0x400012, 1);
+
+    //Truncated contents are refused
+    exception_thrown = false;
+    try {
+        PatternDatabase truncated(3);
+        truncated.add_group(0x0016);
+        truncated.attach(contents.data(), contents.size() - 1);
+    } catch (std::string e) {
+        exception_thrown = true;
+    }
+    assert(exception_thrown);
+
+    remove("./sparse.db.bin");
+    remove("./dense.db.bin");
+}
+
+static void test_embedded_databases()
+{
+    //Only present when built with --enable-embedded-databases
+    for (const StandardDatabase &database : STANDARD_DATABASES) {
+        const uint8_t *data;
+        size_t size;
+        assert(EmbeddedDatabases::find(database.file_name, data, size) == EmbeddedDatabases::is_available());
+
+        if (EmbeddedDatabases::is_available()) {
+            PatternDatabase pattern_database(4);
+            pattern_database.add_group(database.group_mask);
+            pattern_database.attach(data, size);
+        }
+    }
+}
+
+static void test_pattern_database_solve(bool use_huge_pages)
+{
+    std::string solvable_puzzle = "12 1 10 2 7 11 4 14 5 0 9 15 8 13 6 3";
+    SolverOptions options;
+    options.use_huge_pages = use_huge_pages;
+
+    //Should find a solution with 53 moves
+    assert(taquin_solve(solvable_puzzle, 4, Algorithm::IDA, options).size() == 53);
+}
+
+int main (void)
+{
+    test_pattern_database_lookup(false);
+    test_pattern_database_lookup(true);
+    test_pattern_database_files();
+    test_embedded_databases();
+    test_pattern_database_solve(true);
+
+    return EXIT_SUCCESS;
+}
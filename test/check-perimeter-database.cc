@@ -0,0 +1,91 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string>
+#include <memory>
+
+#include <taquinsolve.hh>
+#include <Board.hh>
+#include <PerimeterDatabase.hh>
+#include <Solver.hh>
+
+using namespace TaquinSolve;
+
+/**
+ * Apply the given moves to the given board and check it ends up solved.
+ */
+static bool check_moves_solve(std::string puzzle, uint8_t board_size, std::queue<Moves> moves)
+{
+    std::shared_ptr<Board> board(new Board(taquin_tokenise_board_string(puzzle), board_size));
+    while (!moves.empty()) {
+        board = std::shared_ptr<Board>(board->perform_move(moves.front()));
+        moves.pop();
+    }
+    return board->check_solved();
+}
+
+static void test_perimeter_3_3_distances()
+{
+    PerimeterDatabase perimeter(3, 4);
+    perimeter.generate();
+
+    //Should hold the goal and every state within 4 moves: 1 + 2 + 4 + 8 + 16
+    assert(perimeter.size() == 31);
+
+    uint8_t distance;
+
+    //The goal should be at distance 0
+    assert(perimeter.lookup(Board(taquin_tokenise_board_string("1 2 3 4 5 6 7 8 0"), 3).get_state_hash(), distance));
+    assert(distance == 0);
+
+    //Two moves from the goal
+    assert(perimeter.lookup(Board(taquin_tokenise_board_string("1 2 3 4 5 6 0 7 8"), 3).get_state_hash(), distance));
+    assert(distance == 2);
+
+    //Should not contain states outside the radius
+    assert(!perimeter.lookup(Board(taquin_tokenise_board_string("4 5 7 2 8 0 6 1 3"), 3).get_state_hash(), distance));
+}
+
+static void test_perimeter_solve_3_3_puzzle()
+{
+    std::string solvable_puzzle = "4 5 7 2 8 0 6 1 3";
+    SolverOptions options;
+    options.perimeter_radius = 12;
+
+    std::queue<Moves> moves = taquin_solve(solvable_puzzle, 3, Algorithm::IDA, options);
+
+    //Should find the same length solution as without the perimeter
+    assert(moves.size() == 27);
+    assert(check_moves_solve(solvable_puzzle, 3, moves));
+}
+
+static void test_perimeter_solve_4_4_puzzle()
+{
+    std::string solvable_puzzle = "12 1 10 2 7 11 4 14 5 0 9 15 8 13 6 3";
+    SolverOptions options;
+    options.perimeter_radius = 10;
+
+    std::queue<Moves> moves = taquin_solve(solvable_puzzle, 4, Algorithm::IDA, options);
+
+    //Should find the same length solution as without the perimeter
+    assert(moves.size() == 53);
+    assert(check_moves_solve(solvable_puzzle, 4, moves));
+}
+
+static void test_perimeter_shared()
+{
+    //Built once per board size and radius, then shared by every solver
+    std::shared_ptr<PerimeterDatabase> perimeter = Solver::get_perimeter_database(3, 8);
+    assert(Solver::get_perimeter_database(3, 8) == perimeter);
+    assert(Solver::get_perimeter_database(3, 6) != perimeter);
+    assert(perimeter->get_radius() == 8 && perimeter->get_board_size() == 3);
+}
+
+int main (void)
+{
+    test_perimeter_3_3_distances();
+    test_perimeter_solve_3_3_puzzle();
+    test_perimeter_solve_4_4_puzzle();
+    test_perimeter_shared();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,129 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include <taquinsolve.hh>
+#include <PuzzleGenerator.hh>
+#include <BoardParser.hh>
+
+using namespace TaquinSolve;
+
+static void test_rank_round_trip()
+{
+    std::vector<uint8_t> tiles(16);
+
+    //The first and last ranks are the sorted and reversed arrangements
+    PuzzleGenerator::unrank(0, 4, tiles.data());
+    assert(tiles == taquin_tokenise_board_string("0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15"));
+    PuzzleGenerator::unrank(PuzzleGenerator::get_permutation_count(4) - 1, 4, tiles.data());
+    assert(tiles == taquin_tokenise_board_string("15 14 13 12 11 10 9 8 7 6 5 4 3 2 1 0"));
+
+    assert(PuzzleGenerator::get_permutation_count(3) == 362880);
+    for (uint64_t rank = 0; rank < 362880; rank += 997) {
+        PuzzleGenerator::unrank(rank, 3, tiles.data());
+        assert(PuzzleGenerator::rank(tiles.data(), 3) == rank);
+    }
+}
+
+static void test_seeded()
+{
+    PuzzleGenerator first(4, 42);
+    PuzzleGenerator second(4, 42);
+    PuzzleGenerator other(4, 43);
+
+    bool differs = false;
+    for (uint32_t i = 0; i < 1000; i++) {
+        std::vector<uint8_t> board = first.generate();
+        assert(BoardParser::validate(board.data(), 4) == ParseError::NONE);
+        assert(second.generate() == board);
+        differs |= other.generate() != board;
+    }
+    assert(differs);
+
+    //The library functions can be seeded too
+    taquin_set_generator_seed(7);
+    std::vector<uint8_t> board = taquin_generate_vector(4);
+    taquin_set_generator_seed(7);
+    assert(taquin_generate_vector(4) == board);
+}
+
+static void test_uniform()
+{
+    //A 2x2 board has 12 solvable arrangements, each should come up about equally
+    PuzzleGenerator generator(2, 1);
+    std::map<std::vector<uint8_t>, uint32_t> counts;
+    for (uint32_t i = 0; i < 12000; i++) {
+        counts[generator.generate()]++;
+    }
+
+    assert(counts.size() == 12);
+    for (std::pair<std::vector<uint8_t>, uint32_t> count : counts) {
+        assert(count.second > 800 && count.second < 1200);
+    }
+}
+
+static void test_walk()
+{
+    PuzzleGenerator generator(3, 5);
+
+    for (uint32_t i = 0; i < 20; i++) {
+        std::vector<uint8_t> board = generator.generate_walk(14);
+        assert(taquin_check_solvable(board, 3));
+
+        //A walk can double back on itself, but never gets further than its length
+        size_t length = taquin_solve(board, 3).size();
+        assert(length <= 14 && length % 2 == 0);
+    }
+}
+
+static void test_band()
+{
+    PuzzleGenerator generator(3, 9);
+
+    for (uint32_t i = 0; i < 5; i++) {
+        std::vector<uint8_t> board = generator.generate_in_band(10, 12);
+        uint8_t heuristic = generator.measure_difficulty(board, DifficultyMeasure::HEURISTIC);
+        assert(heuristic >= 10 && heuristic <= 12);
+
+        board = generator.generate_in_band(20, 22, DifficultyMeasure::SOLUTION_LENGTH);
+        size_t length = taquin_solve(board, 3).size();
+        assert(length >= 20 && length <= 22);
+    }
+
+    //No 3x3 board is that far from the goal
+    try {
+        generator.generate_in_band(40, 50, DifficultyMeasure::HEURISTIC, 100);
+        assert(false);
+    } catch (std::string e) {
+    }
+}
+
+static void test_batch()
+{
+    size_t count = 10000;
+    std::vector<uint8_t> single(count * 16);
+    std::vector<uint8_t> threaded(count * 16);
+
+    //Should give the same boards whatever the number of threads
+    PuzzleGenerator::generate_batch(4, 3, count, single.data(), 1);
+    PuzzleGenerator::generate_batch(4, 3, count, threaded.data(), 4);
+    assert(single == threaded);
+
+    for (size_t i = 0; i < count; i++) {
+        assert(BoardParser::validate(single.data() + i * 16, 4) == ParseError::NONE);
+    }
+}
+
+int main (void)
+{
+    test_rank_round_trip();
+    test_seeded();
+    test_uniform();
+    test_walk();
+    test_band();
+    test_batch();
+
+    return EXIT_SUCCESS;
+}
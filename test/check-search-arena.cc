@@ -0,0 +1,159 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <vector>
+#include <map>
+#include <thread>
+
+#include <taquinsolve.hh>
+#include <SearchArena.hh>
+#include <IDASolver.hh>
+
+using namespace TaquinSolve;
+
+static void test_recycling()
+{
+    SearchArena arena;
+
+    void *first = arena.allocate(40);
+    assert(((uintptr_t) first) % SearchArena::ALIGNMENT == 0);
+    assert(arena.get_bytes_in_use() == 48);
+    assert(arena.get_reserved_bytes() == SearchArena::BLOCK_SIZE);
+
+    //Released memory is handed out again for the same size class
+    arena.deallocate(first, 40);
+    assert(arena.get_bytes_in_use() == 0);
+    assert(arena.allocate(33) == first);
+
+    //Other sizes come from fresh memory
+    void *second = arena.allocate(16);
+    assert(second != first);
+    assert(arena.get_high_water_mark() == 64);
+
+    //Large allocations go to the heap but are still counted
+    void *large = arena.allocate(SearchArena::MAX_POOLED_SIZE + 1);
+    assert(arena.get_bytes_in_use() == 64 + SearchArena::MAX_POOLED_SIZE + 1);
+    arena.deallocate(large, SearchArena::MAX_POOLED_SIZE + 1);
+
+    arena.reset();
+    assert(arena.get_bytes_in_use() == 0);
+    assert(arena.get_high_water_mark() == 0);
+    assert(arena.get_reserved_bytes() == SearchArena::BLOCK_SIZE);
+
+    //Blocks are reused after a reset
+    assert(arena.allocate(40) == first);
+}
+
+static void test_blocks()
+{
+    SearchArena arena;
+
+    //Fill more than one block
+    size_t count = SearchArena::BLOCK_SIZE / 256 + 1;
+    for (size_t i = 0; i < count; i++) {
+        arena.allocate(256);
+    }
+    assert(arena.get_reserved_bytes() == 2 * SearchArena::BLOCK_SIZE);
+    assert(arena.get_bytes_in_use() == count * 256);
+
+    arena.reset();
+    for (size_t i = 0; i < count; i++) {
+        arena.allocate(256);
+    }
+    assert(arena.get_reserved_bytes() == 2 * SearchArena::BLOCK_SIZE);
+}
+
+static void test_scopes()
+{
+    SearchArena arena;
+
+    //The outermost scope resets the arena once everything is released
+    {
+        ArenaScope outer(arena);
+        void *pointer = arena.allocate(64);
+        {
+            ArenaScope inner(arena);
+        }
+        assert(arena.get_bytes_in_use() == 64);
+        arena.deallocate(pointer, 64);
+    }
+    assert(arena.get_high_water_mark() == 0);
+
+    //Memory still in use when the scope ends is left alone
+    void *kept;
+    {
+        ArenaScope scope(arena);
+        kept = arena.allocate(64);
+    }
+    assert(arena.get_bytes_in_use() == 64);
+    arena.deallocate(kept, 64);
+}
+
+static void test_allocator()
+{
+    size_t in_use = SearchArena::get_thread_arena().get_bytes_in_use();
+    {
+        std::vector<int, ArenaAllocator<int>> values;
+        std::map<int, int, std::less<int>, ArenaAllocator<std::pair<const int, int>>> map;
+        for (int i = 0; i < 100; i++) {
+            values.push_back(i);
+            map[i] = i * 2;
+        }
+        assert(values[99] == 99 && map[50] == 100);
+        assert(SearchArena::get_thread_arena().get_bytes_in_use() > in_use);
+    }
+    assert(SearchArena::get_thread_arena().get_bytes_in_use() == in_use);
+}
+
+static void test_solves()
+{
+    SearchArena &arena = SearchArena::get_thread_arena();
+    IDASolver solver;
+    SolveStats stats;
+
+    assert(solver.solve(taquin_tokenise_board_string("4 5 7 2 8 0 6 1 3"), 3, &stats).size() == 27);
+    assert(stats.arena_high_water > 0);
+
+    //Everything is released when the solve ends, and the blocks are reused by the next one
+    assert(arena.get_bytes_in_use() == 0);
+    size_t reserved = arena.get_reserved_bytes();
+    assert(solver.solve(taquin_tokenise_board_string("4 5 7 2 8 0 6 1 3"), 3).size() == 27);
+    assert(arena.get_reserved_bytes() == reserved);
+
+    //Failed solves release their memory too
+    bool thrown = false;
+    try {
+        solver.solve(taquin_tokenise_board_string("1 2 3 4 5 6 8 7 0"), 3);
+    } catch (std::string e) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(arena.get_bytes_in_use() == 0);
+
+    //Each thread has its own arena
+    std::vector<std::thread> threads;
+    std::vector<size_t> lengths(4);
+    for (uint32_t t = 0; t < 4; t++) {
+        threads.push_back(std::thread([&lengths, t]() {
+            IDASolver thread_solver;
+            lengths[t] = thread_solver.solve(taquin_tokenise_board_string("4 5 7 2 8 0 6 1 3"), 3).size();
+            assert(SearchArena::get_thread_arena().get_bytes_in_use() == 0);
+        }));
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    for (size_t length : lengths) {
+        assert(length == 27);
+    }
+}
+
+int main (void)
+{
+    test_recycling();
+    test_blocks();
+    test_scopes();
+    test_allocator();
+    test_solves();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,89 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string>
+
+#include <taquinsolve.hh>
+#include <IDASolver.hh>
+
+using namespace TaquinSolve;
+
+static void check_consistent(SolveStats stats)
+{
+    uint64_t nodes_expanded = 0;
+    uint64_t nodes_generated = 0;
+    uint32_t last_bound = 0;
+
+    for (IterationStats iteration : stats.iterations) {
+        //Bounds should only increase
+        assert(iteration.bound > last_bound);
+        last_bound = iteration.bound;
+
+        nodes_expanded += iteration.nodes_expanded;
+        nodes_generated += iteration.nodes_generated;
+    }
+
+    //Totals should match the iterations
+    assert(stats.nodes_expanded == nodes_expanded);
+    assert(stats.nodes_generated == nodes_generated);
+
+    //The first bound is the initial heuristic and the last is the solution length
+    assert(stats.iterations.front().bound == stats.initial_heuristic);
+    assert(stats.iterations.back().bound == stats.solution_length);
+    assert(stats.initial_heuristic <= stats.solution_length);
+}
+
+static void test_stats_3_3_puzzle()
+{
+    std::string solvable_puzzle = "4 5 7 2 8 0 6 1 3";
+    SolveStats stats;
+
+    assert(taquin_solve(solvable_puzzle, 3, Algorithm::IDA, SolverOptions(), &stats).size() == 27);
+
+    check_consistent(stats);
+    assert(stats.initial_heuristic == 17);
+    assert(stats.solution_length == 27);
+    assert(stats.nodes_expanded > 0);
+
+    //No pattern databases are used for 3x3 boards
+    assert(stats.pdb_lookups == 0);
+}
+
+static void test_stats_4_4_puzzle()
+{
+    std::string solvable_puzzle = "12 1 10 2 7 11 4 14 5 0 9 15 8 13 6 3";
+    IDASolver solver;
+    SolveStats stats;
+
+    assert(solver.solve(taquin_tokenise_board_string(solvable_puzzle), 4, &stats).size() == 53);
+
+    check_consistent(stats);
+    assert(stats.solution_length == 53);
+
+    //Every generated board is looked up in each of the three databases
+    assert(stats.pdb_lookups == stats.nodes_generated * 3);
+    assert(stats.database_load_time > 0);
+
+    //The solver should keep the statistics of its last solve
+    assert(solver.get_stats().nodes_generated == stats.nodes_generated);
+}
+
+static void test_stats_solved_puzzle()
+{
+    SolveStats stats;
+
+    assert(taquin_solve("1 2 3 0", 2, Algorithm::IDA, SolverOptions(), &stats).size() == 0);
+
+    //Should finish in a single iteration without expanding anything
+    assert(stats.iterations.size() == 1);
+    assert(stats.nodes_expanded == 0);
+    assert(stats.solution_length == 0);
+}
+
+int main (void)
+{
+    test_stats_3_3_puzzle();
+    test_stats_4_4_puzzle();
+    test_stats_solved_puzzle();
+
+    return EXIT_SUCCESS;
+}
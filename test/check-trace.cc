@@ -0,0 +1,86 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string>
+#include <cstdio>
+
+#include <taquinsolve.hh>
+#include <Trace.hh>
+
+using namespace TaquinSolve;
+
+static void test_trace_unopenable_file()
+{
+    //Read on the first solve, a trace file that can't be opened only disables capturing
+    setenv("TAQUINSOLVE_TRACE", "./check-trace-missing/trace.bin", 1);
+    assert(taquin_solve("4 5 7 2 8 0 6 1 3", 3).size() == 27);
+    assert(taquin_get_trace_writer() == NULL);
+    assert(!taquin_get_trace_error().empty());
+
+    //Setting a file replaces the error
+    taquin_set_trace_file("");
+    assert(taquin_get_trace_error().empty());
+}
+
+static void test_trace_capture()
+{
+    std::string path = "./check-trace.bin";
+    remove(path.c_str());
+
+    taquin_set_trace_file(path);
+
+    //A solved and a failed solve
+    SolveStats stats;
+    assert(taquin_solve("4 5 7 2 8 0 6 1 3", 3, Algorithm::IDA, SolverOptions(), &stats).size() == 27);
+
+    bool exception_thrown = false;
+    try {
+        taquin_solve("5 4 7 2 8 0 6 1 3", 3);
+    } catch (std::string e) {
+        exception_thrown = true;
+    }
+    assert(exception_thrown);
+
+    //Stop capturing, this solve should not be recorded
+    taquin_set_trace_file("");
+    taquin_solve("1 2 3 0", 2);
+
+    TraceReader reader(path);
+    TraceRecord record;
+
+    assert(reader.read(record));
+    assert(record.board_size == 3);
+    assert(record.board == taquin_tokenise_board_string("4 5 7 2 8 0 6 1 3"));
+    assert(record.outcome == TraceOutcome::SOLVED);
+    assert(record.solution_length == 27);
+    assert(record.nodes_generated == stats.nodes_generated);
+    assert(record.timestamp > 0);
+
+    assert(reader.read(record));
+    assert(record.board == taquin_tokenise_board_string("5 4 7 2 8 0 6 1 3"));
+    assert(record.outcome == TraceOutcome::FAILED);
+
+    assert(!reader.read(record));
+
+    remove(path.c_str());
+}
+
+static void test_trace_invalid_file()
+{
+    //Should refuse a file without the trace header
+    bool exception_thrown = false;
+    try {
+        TraceReader reader("./Makefile");
+    } catch (std::string e) {
+        exception_thrown = true;
+    }
+    assert(exception_thrown);
+}
+
+int main (void)
+{
+    test_trace_unopenable_file();
+    test_trace_capture();
+    test_trace_invalid_file();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,122 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+
+#include <taquinsolve.hh>
+#include <IDASolver.hh>
+#include <Heuristics.hh>
+
+using namespace TaquinSolve;
+
+static const std::string shallow_puzzle = "6 8 15 4 1 2 3 0 9 5 10 7 14 13 11 12";
+static const std::string deep_puzzle = "12 1 10 2 7 11 4 14 5 0 9 15 8 13 6 3";
+
+/**
+ * A solve made while the databases load doesn't wait, and is still optimal.
+ */
+static void test_solve_while_loading()
+{
+    taquin_warm_up();
+
+    SolveStats stats;
+    assert(taquin_solve(shallow_puzzle, 4, Algorithm::IDA, SolverOptions(), &stats).size() == 34);
+}
+
+/**
+ * Once warmed up, solves use the databases from the first iteration.
+ */
+static void test_solve_after_warm_up()
+{
+    taquin_warm_up(false, true);
+
+    SolveStats stats;
+    assert(taquin_solve(deep_puzzle, 4, Algorithm::IDA, SolverOptions(), &stats).size() == 53);
+    assert(stats.database_upgrade_iteration == 0);
+    assert(stats.pdb_lookups == stats.nodes_generated * 3);
+}
+
+/**
+ * Other sizes are warmed separately, and only if their databases are installed.
+ */
+static void test_warm_up_sizes()
+{
+    taquin_warm_up(false, true, 5);
+    assert((Solver::get_loaded_pattern_database(false, 5) != NULL) == Solver::check_pattern_databases_available(5));
+    assert(Solver::get_loaded_pattern_database(false, 4)->get_board_size() == 4);
+
+    //Sizes without databases load nothing
+    taquin_warm_up(false, true, 3);
+    assert(Solver::get_loaded_pattern_database(false, 3) == NULL);
+}
+
+/**
+ * Solves loading the databases at once read them a single time, and let them go when done.
+ */
+static void test_concurrent_loads()
+{
+    //Huge page tables are cached separately, so these are still cold
+    SolverOptions options;
+    options.use_huge_pages = true;
+
+    std::shared_ptr<PatternDatabase> loaded[2];
+    std::thread threads[2];
+    for (int i = 0; i < 2; i++) {
+        threads[i] = std::thread([&options, &loaded, i]() {
+            IDASolver solver(options);
+            SolveStats stats;
+            assert(solver.solve(taquin_tokenise_board_string(shallow_puzzle), 4, &stats).size() == 34);
+            assert(stats.pdb_lookups == stats.nodes_generated * 3);
+            loaded[i] = Solver::get_loaded_pattern_database(true, 4);
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    assert(loaded[0] != NULL && loaded[0] == loaded[1]);
+
+    loaded[0] = NULL;
+    loaded[1] = NULL;
+    assert(Solver::get_loaded_pattern_database(true, 4) == NULL);
+}
+
+/**
+ * A long solve started cold switches to the databases part way through.
+ */
+static void test_upgrade_between_iterations()
+{
+    //Huge page tables are cached separately, so these are still cold
+    SolverOptions options;
+    options.use_huge_pages = true;
+    options.background_database_load = true;
+
+    //Without databases the default heuristic solves this before they load, fall back on Manhattan distance instead
+    BasicIDASolver<WithPerimeter<IfPatternDatabase<MaxOf<PatternDatabaseHeuristic, ManhattanDistance>, ManhattanDistance>>> solver(options);
+    SolveStats stats;
+    assert(solver.solve(taquin_tokenise_board_string(deep_puzzle), 4, &stats).size() == 53);
+
+    assert(stats.database_upgrade_iteration > 1);
+    assert(stats.database_upgrade_iteration <= stats.iterations.size());
+    assert(stats.pdb_lookups > 0 && stats.pdb_lookups < stats.nodes_generated * 3);
+
+    //The bound never goes down across the switch
+    for (size_t i = 1; i < stats.iterations.size(); i++) {
+        assert(stats.iterations[i].bound > stats.iterations[i - 1].bound);
+    }
+
+    //The next solve has them from the start
+    assert(solver.solve(taquin_tokenise_board_string(shallow_puzzle), 4, &stats).size() == 34);
+    assert(stats.database_upgrade_iteration == 0);
+    assert(stats.pdb_lookups == stats.nodes_generated * 3);
+}
+
+int main (void)
+{
+    test_solve_while_loading();
+    test_solve_after_warm_up();
+    test_warm_up_sizes();
+    test_concurrent_loads();
+    test_upgrade_between_iterations();
+
+    return EXIT_SUCCESS;
+}